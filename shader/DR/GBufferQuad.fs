@@ -8,18 +8,9 @@ uniform sampler2D gPosition;
 uniform sampler2D gNormal;
 uniform sampler2D gColorSpec;
 
-struct Light {
-    vec3 Position;
-    vec3 Color;
-    
-    float Linear;
-    float Quadratic;
-};
-
-const int NR_LIGHTS = 32;
-uniform Light lights[NR_LIGHTS];
+#include "../Include/LightBuffer.glsl"
 
-uniform vec3 ViewPos;
+#include "../Include/FrameUniforms.glsl"
 
 void main()
 {             
@@ -33,20 +24,20 @@ void main()
     vec3 lighting  = Diffuse * 0.1; // hard-coded ambient component
     vec3 viewDir  = normalize(ViewPos - FragPos);
 
-    for(int i = 0; i < NR_LIGHTS; ++i)
+    for(int i = 0; i < LightCount; ++i)
     {
         // Diffuse
-        vec3 lightDir = normalize(lights[i].Position - FragPos);
-        vec3 diffuse = max(dot(Normal, lightDir), 0.0) * Diffuse * lights[i].Color;
+        vec3 lightDir = normalize(lights[i].Position.xyz - FragPos);
+        vec3 diffuse = max(dot(Normal, lightDir), 0.0) * Diffuse * lights[i].Color.rgb;
 
         // Specular
         vec3 halfwayDir = normalize(lightDir + viewDir);  
         float spec = pow(max(dot(Normal, halfwayDir), 0.0), 16.0);
-        vec3 specular = lights[i].Color * spec * Specular;
+        vec3 specular = lights[i].Color.rgb * spec * Specular;
 
         // Attenuation
-        float distance = length(lights[i].Position - FragPos);
-        float attenuation = 1.0 / (1.0 + lights[i].Linear * distance + lights[i].Quadratic * distance * distance);
+        float distance = length(lights[i].Position.xyz - FragPos);
+        float attenuation = 1.0 / (1.0 + lights[i].Position.w * distance + lights[i].Color.a * distance * distance);
         diffuse *= attenuation;
         specular *= attenuation;
         lighting += diffuse + specular;
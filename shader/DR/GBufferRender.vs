@@ -7,17 +7,17 @@ out vec3 FragPos;
 out vec2 TexCoords;
 out vec3 Normal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../Include/Instancing.glsl"
+#include "../Include/FrameUniforms.glsl"
 
 void main()
 {
-    vec4 worldPos = model * vec4(position, 1.0f);
+    mat4 modelMatrix = GetModelMatrix();
+    vec4 worldPos = modelMatrix * vec4(position, 1.0f);
     FragPos = worldPos.xyz; 
     gl_Position = projection * view * worldPos;
     TexCoords = texCoords;
     
-    mat3 normalMatrix = transpose(inverse(mat3(model)));
+    mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
     Normal = normalMatrix * normal;
 }
\ No newline at end of file
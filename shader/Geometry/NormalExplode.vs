@@ -9,8 +9,7 @@ out vec3 vFragPos;
 out vec2 vTexCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../Include/FrameUniforms.glsl"
 
 void main()
 {
@@ -4,7 +4,7 @@ layout (line_strip, max_vertices = 6) out;
 
 in vec3 vNormal[];
 
-uniform mat4 projection;
+#include "../Include/FrameUniforms.glsl"
 
 const float MAGNITUDE = 0.01;
 
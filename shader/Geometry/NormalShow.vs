@@ -7,7 +7,7 @@ layout (location = 2) in vec2 aTexCoord;
 out vec3 vNormal;
 
 uniform mat4 model;
-uniform mat4 view;
+#include "../Include/FrameUniforms.glsl"
 
 void main()
 {
@@ -0,0 +1,10 @@
+﻿// 每帧相机数据, 由SceneBase::UpdateFrameUniforms每帧上传一次, 布局与C++端FrameUniforms一致
+layout (std140) uniform FrameUniforms {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 ViewPos;
+    float NearPlane;
+    float FarPlane;
+    vec2 ScreenSize;
+};
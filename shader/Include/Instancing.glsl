@@ -0,0 +1,28 @@
+﻿// 模型变换, 定义INSTANCED时左乘逐实例属性, 布局与C++端InstanceData一致
+// 实例化时model只含网格自身的局部变换(如紧凑顶点的还原矩阵), 仅用于顶点着色器
+uniform mat4 model;
+
+#ifdef INSTANCED
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in vec4 aInstanceParams;
+
+mat4 GetModelMatrix()
+{
+    return aInstanceModel * model;
+}
+
+vec4 GetInstanceParams()
+{
+    return aInstanceParams;
+}
+#else
+mat4 GetModelMatrix()
+{
+    return model;
+}
+
+vec4 GetInstanceParams()
+{
+    return vec4(0.0);
+}
+#endif
@@ -0,0 +1,12 @@
+﻿// 场景光源, 由LightBuffer每帧上传一次, 布局与C++端LightBlock一致
+#define MAX_LIGHTS 511
+
+struct PackedLight {
+    vec4 Position; // xyz位置, w一次衰减项
+    vec4 Color; // rgb颜色, a二次衰减项
+};
+
+layout (std140) uniform LightBuffer {
+    int LightCount;
+    PackedLight lights[MAX_LIGHTS];
+};
@@ -0,0 +1,169 @@
+﻿// Phong/Blinn-Phong光照, 由包含者在#include前定义以下宏
+// PARA_LIGHT_COUNT, POINT_LIGHT_COUNT, SPOT_LIGHT_COUNT: 各类光源数量, 为0时既不声明uniform也不计算
+// BLINN_PHONG: 为1时高光使用半程向量
+
+#ifndef PARA_LIGHT_COUNT
+#define PARA_LIGHT_COUNT 1
+#endif
+
+#ifndef POINT_LIGHT_COUNT
+#define POINT_LIGHT_COUNT 1
+#endif
+
+#ifndef SPOT_LIGHT_COUNT
+#define SPOT_LIGHT_COUNT 0
+#endif
+
+#ifndef BLINN_PHONG
+#define BLINN_PHONG 0
+#endif
+
+// 平行光
+struct ParaLight{
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// 点光源
+struct PointLight{
+    vec3 position;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    // 衰减
+    float constant; // 常数项
+    float linear; // 一阶项
+    float quadratic; // 二阶项
+};
+
+// 投射光
+struct SpotLight{
+    vec3  position;
+    vec3  direction;
+
+    vec3 diffuse;
+    vec3 specular;
+
+    float innerCutOff; // 投射角(半程)
+    float outerCutOff; // 外轮廓角, 平滑边缘用
+};
+
+#if PARA_LIGHT_COUNT > 0
+uniform ParaLight paraLights[PARA_LIGHT_COUNT];
+#endif
+
+#if POINT_LIGHT_COUNT > 0
+uniform PointLight pointLights[POINT_LIGHT_COUNT];
+#endif
+
+#if SPOT_LIGHT_COUNT > 0
+uniform SpotLight spotLights[SPOT_LIGHT_COUNT];
+#endif
+
+// 镜面高光系数
+float calculate_specular(vec3 norm, vec3 lightDir, vec3 viewDir, float shininess)
+{
+#if BLINN_PHONG
+    vec3 halfwayDir = normalize(lightDir + viewDir); // 与Phong的差别, 这里计算半程向量
+    return pow(max(dot(norm, halfwayDir), 0.0), shininess); // 差别2, 这里改dot(reflectDir, viewDir)为dot(norm, halfwayDir)
+#else
+    vec3 reflectDir = reflect(-lightDir, norm);
+    return pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+#endif
+}
+
+// 平行光
+vec3 calculate_paraLight(ParaLight lightInst, vec3 norm, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    // 环境光
+    vec3 ambient = lightInst.ambient * diffuseColor;
+
+    vec3 lightDir = normalize(-lightInst.direction);
+
+    // 漫反射光
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = lightInst.diffuse * (diff * diffuseColor);
+
+    // 镜面高光
+    float spec = calculate_specular(norm, lightDir, viewDir, shininess);
+    vec3 specular = lightInst.specular * (spec * specularColor);
+
+    return ambient + diffuse + specular;
+}
+
+// 点光源
+vec3 calculate_pointLight(PointLight lightInst, vec3 norm, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    // 环境光
+    vec3 ambient = lightInst.ambient * diffuseColor;
+
+    vec3 lightDir = normalize(lightInst.position - fragPos);
+
+    // 漫反射光
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = lightInst.diffuse * (diff * diffuseColor);
+
+    // 镜面高光
+    float spec = calculate_specular(norm, lightDir, viewDir, shininess);
+    vec3 specular = lightInst.specular * (spec * specularColor);
+
+    // 点光源距离衰减因子
+    float distance = length(lightInst.position - fragPos);
+    float attenuation = 1.0 / (lightInst.constant + lightInst.linear * distance + lightInst.quadratic * distance * distance);
+
+    return (ambient + diffuse + specular) * attenuation;
+}
+
+// 投射光
+vec3 calculate_spotLight(SpotLight lightInst, vec3 norm, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    vec3 lightDir = normalize(lightInst.position - fragPos);
+
+    float theta = dot(lightDir, normalize(-lightInst.direction));
+    float epsilon = lightInst.innerCutOff - lightInst.outerCutOff;
+    float intensity = clamp((theta - lightInst.outerCutOff) / epsilon, 0.0, 1.0);
+
+    // 漫反射光
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = lightInst.diffuse * (diff * diffuseColor);
+
+    // 镜面高光
+    float spec = calculate_specular(norm, lightDir, viewDir, shininess);
+    vec3 specular = lightInst.specular * (spec * specularColor);
+
+    return (diffuse + specular) * intensity;
+}
+
+// 累加全部光源
+vec3 calculate_lighting(vec3 norm, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    vec3 result = vec3(0.0);
+
+#if PARA_LIGHT_COUNT > 0
+    for (int i = 0; i < PARA_LIGHT_COUNT; i++)
+    {
+        result += calculate_paraLight(paraLights[i], norm, fragPos, viewDir, diffuseColor, specularColor, shininess);
+    }
+#endif
+
+#if POINT_LIGHT_COUNT > 0
+    for (int i = 0; i < POINT_LIGHT_COUNT; i++)
+    {
+        result += calculate_pointLight(pointLights[i], norm, fragPos, viewDir, diffuseColor, specularColor, shininess);
+    }
+#endif
+
+#if SPOT_LIGHT_COUNT > 0
+    for (int i = 0; i < SPOT_LIGHT_COUNT; i++)
+    {
+        result += calculate_spotLight(spotLights[i], norm, fragPos, viewDir, diffuseColor, specularColor, shininess);
+    }
+#endif
+
+    return result;
+}
@@ -15,11 +15,9 @@ out VS_OUT {
 } vs_out;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../Include/FrameUniforms.glsl"
 
 uniform vec3 LightPos;
-uniform vec3 ViewPos;
 
 void main()
 {
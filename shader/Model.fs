@@ -0,0 +1,94 @@
+﻿#version 330 core
+
+// 模型着色, 变体宏:
+// PARA_LIGHT_COUNT, POINT_LIGHT_COUNT, SPOT_LIGHT_COUNT, BLINN_PHONG: 见Include/Lighting.glsl
+// ENV_REFLECTION, ENV_REFRACTION: 天空盒反射/折射
+// NORMAL_EXPLODE: 输入来自Geometry/NormalExplode.gs
+
+#ifndef ENV_REFLECTION
+#define ENV_REFLECTION 1
+#endif
+
+#ifndef ENV_REFRACTION
+#define ENV_REFRACTION 0
+#endif
+
+#ifndef NORMAL_EXPLODE
+#define NORMAL_EXPLODE 0
+#endif
+
+out vec4 FragColor;
+
+#if NORMAL_EXPLODE
+in vec3 gNormal;
+in vec3 gFragPos;
+in vec2 gTexCoord;
+#define Normal gNormal
+#define FragPos gFragPos
+#define TexCoord gTexCoord
+#else
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoord;
+#endif
+
+#include "Include/Lighting.glsl"
+
+// 物体材质
+struct Material {
+    sampler2D texture_diffuse1;
+    sampler2D texture_specular1;
+    sampler2D texture_reflect1;
+    float shininess;
+};
+uniform Material material;
+
+uniform samplerCube skybox;
+
+#include "Include/FrameUniforms.glsl"
+
+// 计算反射纹理对天空盒的反射
+vec3 calculate_reflection(samplerCube cubeMap)
+{
+    vec3 texColor = vec3(texture(material.texture_reflect1, TexCoord));
+    
+    vec3 I = normalize(FragPos - ViewPos);
+    vec3 R = reflect(I, normalize(Normal));
+
+    vec3 cubeColor = texture(cubeMap, R).rgb;
+
+    return texColor * cubeColor;
+}
+
+vec3 calculate_refraction(samplerCube cubeMap)
+{
+    vec3 texColor = vec3(texture(material.texture_reflect1, TexCoord));
+    texColor = vec3(1, 1, 1) - texColor;
+
+    float ratio = 1.00 / 1.52; // 玻璃的折射率
+    vec3 I = normalize(FragPos - ViewPos);
+    vec3 R = refract(I, normalize(Normal), ratio);
+
+    vec3 cubeColor = texture(cubeMap, R).rgb;
+
+    return texColor * cubeColor;
+}
+
+void main()
+{
+    vec3 diffuseColor = vec3(texture(material.texture_diffuse1, TexCoord));
+    vec3 specularColor = vec3(texture(material.texture_specular1, TexCoord));
+
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(ViewPos - FragPos);
+
+    vec3 result = calculate_lighting(norm, FragPos, viewDir, diffuseColor, specularColor, material.shininess);
+#if ENV_REFLECTION
+    result += calculate_reflection(skybox);
+#endif
+#if ENV_REFRACTION
+    result += calculate_refraction(skybox);
+#endif
+
+    FragColor = vec4(result, 1.0);
+}
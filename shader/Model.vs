@@ -9,8 +9,7 @@ out vec3 FragPos;
 out vec2 TexCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "Include/FrameUniforms.glsl"
 
 void main()
 {
@@ -0,0 +1,6 @@
+﻿#version 330 core
+
+// 颜色写入关闭, 只需光栅化及深度测试
+void main()
+{
+}
@@ -0,0 +1,12 @@
+﻿#version 330 core
+
+// 遮挡查询的包围盒代理, model将单位立方体[-1, 1]变换到世界包围盒
+layout (location = 0) in vec3 aPos;
+
+#include "../Include/Instancing.glsl"
+#include "../Include/FrameUniforms.glsl"
+
+void main()
+{
+    gl_Position = viewProj * GetModelMatrix() * vec4(aPos, 1.0);
+}
@@ -7,16 +7,29 @@ out vec2 TexCoords;
 out vec3 WorldPos;
 out vec3 Normal;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+#ifdef INSTANCED
+flat out vec2 MaterialParams;
+#endif
+
+#include "../../Include/FrameUniforms.glsl"
+
+#include "../../Include/Instancing.glsl"
+
 uniform mat3 normalMatrix;
 
 void main()
 {
     TexCoords = aTexCoords;
-    WorldPos = vec3(model * vec4(aPos, 1.0));
+    mat4 modelMatrix = GetModelMatrix();
+    WorldPos = vec3(modelMatrix * vec4(aPos, 1.0));
+
+#ifdef INSTANCED
+    // 逐实例计算法线矩阵, x金属度y粗糙度传给片元
+    Normal = transpose(inverse(mat3(modelMatrix))) * aNormal;
+    MaterialParams = GetInstanceParams().xy;
+#else
     Normal = normalMatrix * aNormal;
+#endif
 
     gl_Position =  projection * view * vec4(WorldPos, 1.0);
 }
\ No newline at end of file
@@ -13,10 +13,9 @@ uniform float roughness;
 uniform float ao;
 
 // lights
-uniform vec3 lightPositions[4];
-uniform vec3 lightColors[4];
+#include "../Include/LightBuffer.glsl"
 
-uniform vec3 ViewPos;
+#include "../Include/FrameUniforms.glsl"
 
 const float PI = 3.14159265359;
 
@@ -76,14 +75,14 @@ void main()
 
     // 反射方程
     vec3 Lo = vec3(0.0);
-    for(int i = 0; i < 4; ++i) 
+    for(int i = 0; i < LightCount; ++i) 
     {
         // Li(p, wi), 光源i的辐射率
-        vec3 L = normalize(lightPositions[i] - WorldPos);
+        vec3 L = normalize(lights[i].Position.xyz - WorldPos);
         vec3 H = normalize(V + L);
-        float distance = length(lightPositions[i] - WorldPos);
+        float distance = length(lights[i].Position.xyz - WorldPos);
         float attenuation = 1.0 / (distance * distance);
-        vec3 radiance = lightColors[i] * attenuation;
+        vec3 radiance = lights[i].Color.rgb * attenuation;
 
         // Cook-Torrance BRDF
         float NDF = DistributionGGX(N, H, roughness); // 法线分布函数
@@ -7,8 +7,8 @@ out vec2 TexCoords;
 out vec3 WorldPos;
 out vec3 Normal;
 
-uniform mat4 projection;
-uniform mat4 view;
+#include "../Include/FrameUniforms.glsl"
+
 uniform mat4 model;
 uniform mat3 normalMatrix;
 
@@ -21,7 +21,7 @@ struct Material {
 uniform LightMat lightMat;
 uniform Material material;
 uniform vec3 LightPos;
-uniform vec3 ViewPos;
+#include "Include/FrameUniforms.glsl"
 
 void main()
 {
@@ -7,8 +7,7 @@ out vec3 Normal;
 out vec3 FragPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "Include/FrameUniforms.glsl"
 
 void main()
 {
@@ -52,7 +52,7 @@ struct Material {
 };
 uniform Material material;
 
-uniform vec3 ViewPos;
+#include "Include/FrameUniforms.glsl"
 
 // 函数声明
 vec3 calculate_paraLight(ParaLight lightInst, vec3 diffuseColor, vec3 specularColor);
@@ -10,8 +10,7 @@ out vec3 Normal;
 uniform bool bInverseNormal;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../Include/FrameUniforms.glsl"
 
 void main()
 {
@@ -8,7 +8,7 @@ uniform sampler2D gPosition;
 uniform sampler2D gNormal;
 uniform sampler2D texNoise;
 
-uniform mat4 projection;
+#include "../Include/FrameUniforms.glsl"
 
 uniform vec3 samples[64];
 
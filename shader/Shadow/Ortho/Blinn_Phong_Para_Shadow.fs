@@ -12,7 +12,8 @@ in VS_OUT {
 uniform sampler2D diffuseTex;
 uniform sampler2D shadowMap;
 
-uniform vec3 ViewPos;
+#include "../../Include/FrameUniforms.glsl"
+
 uniform vec3 LightPos;
 
 void main()
@@ -12,8 +12,8 @@ out VS_OUT {
 } vs_out;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../../Include/FrameUniforms.glsl"
+
 uniform mat4 lightSpaceMatrix;
 
 void main()
@@ -11,7 +11,8 @@ in VS_OUT {
 uniform sampler2D diffuseTex;
 uniform samplerCube depthCubeMap;
 
-uniform vec3 ViewPos;
+#include "../../Include/FrameUniforms.glsl"
+
 uniform vec3 LightPos;
 
 uniform float far_plane;
@@ -2,7 +2,12 @@
 
 out vec4 FragColor;
 
+#ifdef INSTANCED
+flat in vec3 InstanceColor;
+#define InColor InstanceColor
+#else
 uniform vec3 InColor;
+#endif
 
 void main()
 {
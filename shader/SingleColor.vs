@@ -4,11 +4,18 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexcoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "Include/Instancing.glsl"
+#include "Include/FrameUniforms.glsl"
+
+#ifdef INSTANCED
+flat out vec3 InstanceColor;
+#endif
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * GetModelMatrix() * vec4(aPos, 1.0);
+
+#ifdef INSTANCED
+    InstanceColor = GetInstanceParams().rgb;
+#endif
 }
@@ -7,8 +7,7 @@ layout (location = 2) in vec2 aTexCoord; // 纹理坐标
 out vec2 texCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "Include/FrameUniforms.glsl"
 
 void main()
 {
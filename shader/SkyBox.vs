@@ -4,8 +4,7 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 sampleCoord;
 
-uniform mat4 view;
-uniform mat4 projection;
+#include "Include/FrameUniforms.glsl"
 
 void main()
 {
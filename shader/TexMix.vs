@@ -7,8 +7,7 @@ out vec3 vertexColor; // 为片段着色器指定一个颜色输出
 out vec2 texCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "Include/FrameUniforms.glsl"
 
 void main()
 {
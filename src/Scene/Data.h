@@ -1,30 +1,31 @@
-﻿
-float Triangle_2D[] = {
+﻿#pragma once
+
+static float Triangle_2D[] = {
     -0.5f, -0.5f, 0.0f,
      0.5f, -0.5f, 0.0f,
      0.0f,  0.5f, 0.0f
 };
 
-float Rectangle_2D[] = {
+static float Rectangle_2D[] = {
     0.5f, 0.5f, 0.0f,   // 右上角
     0.5f, -0.5f, 0.0f,  // 右下角
     -0.5f, -0.5f, 0.0f, // 左下角
     -0.5f, 0.5f, 0.0f   // 左上角
 };
 
-unsigned int Rectangle_2D_Indices[] = {
+static unsigned int Rectangle_2D_Indices[] = {
     0, 1, 3, // 第一个三角形
     1, 2, 3  // 第二个三角形
 };
 
-float Triangle_ColorVert[] = {
+static float Triangle_ColorVert[] = {
 	// 位置              // 颜色
 	 0.5f, -0.5f, 0.0f,  1.0f, 0.0f, 0.0f,   // 右下
 	-0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f,   // 左下
 	 0.0f,  0.5f, 0.0f,  0.0f, 0.0f, 1.0f    // 顶部
 };
 
-float Rectangle_ColorTexVert[] = {
+static float Rectangle_ColorTexVert[] = {
 	//     ---- 位置 ----       ---- 颜色 ----     - 纹理坐标 -
 		 0.5f,  0.5f, 0.0f,   1.0f, 0.0f, 0.0f,   1.0f, 1.0f,   // 右上
 		 0.5f, -0.5f, 0.0f,   0.0f, 1.0f, 0.0f,   1.0f, 0.0f,   // 右下
@@ -32,7 +33,7 @@ float Rectangle_ColorTexVert[] = {
 		-0.5f,  0.5f, 0.0f,   1.0f, 1.0f, 0.0f,   0.0f, 1.0f    // 左上
 };
 
-glm::vec3 cubePositions[] = {
+static glm::vec3 cubePositions[] = {
 	glm::vec3(0.0f,  0.0f,  0.0f),
 	glm::vec3(2.0f,  5.0f, -15.0f),
 	glm::vec3(-1.5f, -2.2f, -2.5f),
@@ -45,7 +46,7 @@ glm::vec3 cubePositions[] = {
 	glm::vec3(-1.3f,  1.0f, -1.5f)
 };
 
-float Cube_TexVert[] = {
+static float Cube_TexVert[] = {
 	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
 	 0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
 	 0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
@@ -89,7 +90,7 @@ float Cube_TexVert[] = {
 	-0.5f,  0.5f, -0.5f,  0.0f, 1.0f
 };
 
-float Cube_NormalVert[] = {
+static float Cube_NormalVert[] = {
 	-0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
 	 0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
 	 0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
@@ -133,7 +134,7 @@ float Cube_NormalVert[] = {
 	-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f
 };
 
-float Cube_NormalTexVert[] = {
+static float Cube_NormalTexVert[] = {
 	// Back face
 	-0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, // Bottom-left
 	0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f, // top-right
@@ -178,7 +179,7 @@ float Cube_NormalTexVert[] = {
 	-0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f // bottom-left        
 };
 
-float Plane_TexVert[] = {
+static float Plane_TexVert[] = {
 	// positions          // texture Coords (note we set these higher than 1 (together with GL_REPEAT as texture wrapping mode). this will cause the floor texture to repeat)
 	 5.0f, -0.5f,  5.0f,  2.0f, 0.0f,
 	-5.0f, -0.5f,  5.0f,  0.0f, 0.0f,
@@ -189,7 +190,7 @@ float Plane_TexVert[] = {
 	 5.0f, -0.5f, -5.0f,  2.0f, 2.0f
 };
 
-float MapPlane_TexNormalVert[] = {
+static float MapPlane_TexNormalVert[] = {
 	// positions          // texture Coords (note we set these higher than 1 (together with GL_REPEAT as texture wrapping mode). this will cause the floor texture to repeat)
 	 -1.0,  1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0,
 	-1.0, -1.0, 0.0, 0.0, 0.0, 1.0,  0.0f, 0.0f,
@@ -200,7 +201,7 @@ float MapPlane_TexNormalVert[] = {
 	 1.0, 1.0, 0.0, 0.0, 0.0, 1.0,  1.0, 1.0
 };
 
-float Plan_TexNormalVert[] = {
+static float Plan_TexNormalVert[] = {
 	// positions		// normal		// texture Coords (note we set these higher than 1 (together with GL_REPEAT as texture wrapping mode). this will cause the floor texture to repeat)
 	 5.0f, -0.5f,  5.0f,  0.0f,  1.0f,  0.0f,  2.0f, 0.0f,
 	-5.0f, -0.5f,  5.0f,  0.0f,  1.0f,  0.0f,  0.0f, 0.0f,
@@ -211,7 +212,7 @@ float Plan_TexNormalVert[] = {
 	 5.0f, -0.5f, -5.0f,  0.0f,  1.0f,  0.0f,  2.0f, 2.0f
 };
 
-float Window_TexNormalVert[] = {
+static float Window_TexNormalVert[] = {
 	// positions         // texture Coords (swapped y coordinates because texture is flipped upside down)
 	0.0f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,  0.0f,
 	0.0f, -0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f,
@@ -223,7 +224,7 @@ float Window_TexNormalVert[] = {
 };
 
 // 离屏四边形坐标及纹理数据
-float quadVertices[] = { 
+static float quadVertices[] = { 
 		// positions   // texCoords
 		-1.0f,  1.0f,  0.0f, 1.0f,
 		-1.0f, -1.0f,  0.0f, 0.0f,
@@ -235,7 +236,7 @@ float quadVertices[] = {
 };
 
 // 只包含坐标, 用于绘制天空盒
-float skyboxVertices[] = {
+static float skyboxVertices[] = {
 	// positions          
 	-1.0f,  1.0f, -1.0f,
 	-1.0f, -1.0f, -1.0f,
@@ -280,7 +281,7 @@ float skyboxVertices[] = {
 	 1.0f, -1.0f,  1.0f
 };
 
-float UnitCube[] = {
+static float UnitCube[] = {
 	// back face
 	-1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
 	 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
@@ -325,7 +326,7 @@ float UnitCube[] = {
 	-1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 0.0f  // bottom-left        
 };
 
-float ShadowPlan[] = {
+static float ShadowPlan[] = {
 	// positions            // normals         // texcoords
 	 25.0f, -0.5f,  25.0f,  0.0f, 1.0f, 0.0f,  25.0f,  0.0f,
 	-25.0f, -0.5f,  25.0f,  0.0f, 1.0f, 0.0f,   0.0f,  0.0f,
@@ -336,7 +337,7 @@ float ShadowPlan[] = {
 	 25.0f, -0.5f, -25.0f,  0.0f, 1.0f, 0.0f,  25.0f, 25.0f
 };
 
-GLfloat GBufferQuadVertices[] = {
+static GLfloat GBufferQuadVertices[] = {
 	// Positions        // Texture Coords
 	-1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
 	-1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
@@ -344,7 +345,7 @@ GLfloat GBufferQuadVertices[] = {
 	1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
 };
 
-unsigned int GBufferQuadIndices[] = {
+static unsigned int GBufferQuadIndices[] = {
 	0, 1, 2, // 第一个三角形
 	1, 2, 3  // 第二个三角形
 };
@@ -21,17 +21,20 @@
 #include "../render/GBuffer.h"
 #include "../render/SSAOKernel.h"
 #include "../render/SphereRender.h"
+#include "../buffer/LightBuffer.h"
+#include "../buffer/InstanceBuffer.h"
 #include "../buffer/TextureAllocator.h"
 #include "../buffer/FrameObj.h"
+#include "../app/Profiler.h"
+#include "SceneBase.h"
+#include "../render/GLStateCache.h"
 
 
 // 常数定义
-const float SCR_WIDTH = 1920;
-const float SCR_HEIGHT = 1080;
-const float NEAR_PLAN = 0.1f;
-const float FAR_PLAN = 100.0f;
+static const float NEAR_PLAN = 0.1f;
+static const float FAR_PLAN = 100.0f;
 
-std::vector<glm::mat4> CubeMapViewMatList =
+static std::vector<glm::mat4> CubeMapViewMatList =
 {
    glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
    glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(-1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
@@ -42,60 +45,122 @@ std::vector<glm::mat4> CubeMapViewMatList =
 };
 
 
-// 函数声明
-void InitGLFW();
-GLFWwindow* CreateWindow();
+// 基于HDR环境贴图的IBL, 预计算辐照度, 预滤波及BRDF LUT后渲染7x7球体阵列
+class IBLScene : public SceneBase
+{
+public:
 
-// 窗口尺寸改变回调, 初始化时同样会执行
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-// 输入回调函数声明
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-void processInput(float deltaTime, GLFWwindow* window);
+	void Init() override;
 
-// 全局变量
-Camera* CurCamera;
+	void Render(float currentTime) override;
 
-TextureLoader* TexLoader;
+private:
 
-TextureAllocator* TexAllocator;
+	TextureLoader* TexLoader;
 
-int main()
-{
-	InitGLFW();
+	TextureAllocator* TexAllocator;
 
-	GLFWwindow* window = CreateWindow();
+	SimpleRender* QuadRender;
 
-	// 初始化glad
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cout << "Failed to initialize GLAD" << std::endl;
-		return -1;
-	}
+	SimpleRender* UnitCubeRender;
+
+	SphereRender* Sphere;
+
+	Shader* RTShader;
+
+	Shader* SingleColorShader;
+
+	Shader* SkyboxShader;
+
+	Shader* IBLShader;
+
+	// 球体阵列中视锥内的实例, 逐帧剔除后上传
+	InstanceBuffer* SphereInstances;
+
+	// 球体阵列的变换及金属度/粗糙度, 初始化时生成
+	vector<glm::mat4> sphereMatrixList;
+
+	vector<glm::vec4> sphereParamList;
+
+	// 球体及光源在ObjectTree中的句柄, 光源逐帧Refit
+	vector<int> sphereHandleList;
+
+	vector<int> lightHandleList;
+
+	// ObjectTree每帧剔除一次的结果, 按句柄索引
+	vector<uint8_t> visibleList;
+
+	// 光源球的变换及颜色, 逐帧上传
+	InstanceBuffer* LightInstances;
+
+	vector<glm::vec3> lightPositions;
+
+	vector<glm::vec3> lightColors;
+
+	LightBuffer* SceneLights;
+
+	// 模型排列数据
+	int nrRows;
+
+	int nrColumns;
+
+	float spacing;
+
+	GLuint CaptureCubeMap;
+
+	GLuint DiffuseCubeMap;
+
+	GLuint PrefilterCubeMap;
+
+	GLuint LUTTex;
+
+private:
+
+	// 光源球缩放为0.5
+	BoundingBox GetLightBox(const glm::vec3& position) const;
+};
+
+REGISTER_SCENE("IBL", IBLScene)
+
+
+void IBLScene::Init()
+{
+	NearPlan = NEAR_PLAN;
+	FarPlan = FAR_PLAN;
 
 	// 创建场景相机
 	CurCamera = new Camera(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 
-	glfwMakeContextCurrent(window);
-	glfwSetCursorPosCallback(window, mouse_callback); // 鼠标滑动回调
-	glfwSetScrollCallback(window, scroll_callback); // 鼠标滚轮回调
-
-	//glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	// 基准测试环绕半径需看到完整的球体阵列
+	PathRadius = 18.0f;
 
 	TexLoader = new TextureLoader();
 	TexAllocator = new TextureAllocator();
 
+	/*----------------------------------------------------
+		Part Shader
+	----------------------------------------------------*/
+
+
+	// 全部Shader提前提交, 编译与HDR解码及预计算重叠, 各自首次Use()时才等待
+	RTShader = new Shader("shader/PostProcess/ScreenQuad.vs", "shader/PostProcess/Primitive.fs");
+	SingleColorShader = new Shader("shader/SingleColor.vs", "shader/SingleColor.fs", ShaderDefines().Set("INSTANCED", 1));
+	SkyboxShader = new Shader("shader/SkyBox.vs", "shader/SkyBox.fs");
+	IBLShader = new Shader("shader/PBR/IBL/IBL.vs", "shader/PBR/IBL/IBL.fs", ShaderDefines().Set("INSTANCED", 1));
+	Shader* ERPCaptureShader = new Shader("shader/PBR/IBL/ERPCapture.vs", "shader/PBR/IBL/ERPCapture.fs");
+	Shader* DiffuseConvoShader = new Shader("shader/PBR/IBL/DiffuseConv.vs", "shader/PBR/IBL/DiffuseConv.fs");
+	Shader* PrefilterShader = new Shader("shader/PBR/IBL/PrefilterHDR.vs", "shader/PBR/IBL/PrefilterHDR.fs");
+	Shader* LUTShader = new Shader("shader/PBR/IBL/BRDFLUT.vs", "shader/PBR/IBL/BRDFLUT.fs");
+
+
 	/*----------------------------------------------------
 		Part Screen Quad
 	----------------------------------------------------*/
 
 
 	// 屏幕纹理渲染缓冲数据, 可用于直接展示中间过程生成的各种纹理
-	vector<int> QuadAttri{ 2, 2 };
-	SimpleRender* QuadRender = new SimpleRender(QuadAttri, quadVertices, sizeof(quadVertices));
+	QuadRender = new SimpleRender(Pos2TexLayout(), quadVertices, sizeof(quadVertices));
 
-	Shader* RTShader = new Shader("shader/PostProcess/Primitive.vs", "shader/PostProcess/Primitive.fs");
 	RTShader->Use();
 	RTShader->SetInt("RT", 0);
 
@@ -104,45 +169,68 @@ int main()
 		Part 光源
 	----------------------------------------------------*/
 
-	vector<glm::vec3> lightPositions{
+	lightPositions = {
 		glm::vec3(-10.0f,  10.0f, 10.0f),
 		glm::vec3(10.0f,  10.0f, 10.0f),
 		glm::vec3(-10.0f, -10.0f, 10.0f),
 		glm::vec3(10.0f, -10.0f, 10.0f),
 	};
 
-	vector<glm::vec3> lightColors{
+	lightColors = {
 		glm::vec3(300.0f, 300.0f, 300.0f),
 		glm::vec3(300.0f, 300.0f, 300.0f),
 		glm::vec3(300.0f, 300.0f, 300.0f),
 		glm::vec3(300.0f, 300.0f, 300.0f)
 	};
 
-
-	Shader* SingleColorShader = new Shader("shader/SingleColor.vs", "shader/SingleColor.fs");
-	SingleColorShader->Use();
-
-	/*----------------------------------------------------
-		Part Skybox
-	----------------------------------------------------*/
-
-
-	Shader* SkyboxShader = new Shader("shader/SkyBox.vs", "shader/SkyBox.fs");
+	// 光源逐帧移动, Render中每帧上传
+	SceneLights = new LightBuffer();
+	LightInstances = new InstanceBuffer();
 
 
+	SingleColorShader->Use();
 
 	/*----------------------------------------------------
 		Part Obj
 	----------------------------------------------------*/
 
-	SphereRender* Sphere = new SphereRender();
+	Sphere = new SphereRender();
 
 	// 模型排列数据
-	int nrRows = 7;
-	int nrColumns = 7;
-	float spacing = 2.5;
+	nrRows = 7;
+	nrColumns = 7;
+	spacing = 2.5;
+
+	// 从上到下金属度递增, 从左到右粗糙度递增
+	SphereInstances = new InstanceBuffer();
+	for (int row = 0; row < nrRows; ++row)
+	{
+		for (int col = 0; col < nrColumns; ++col)
+		{
+			glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(
+				(col - (nrColumns / 2)) * spacing,
+				(row - (nrRows / 2)) * spacing,
+				0.0f
+			));
+
+			float metallic = (float)row / (float)nrRows;
+			float roughness = glm::clamp((float)col / (float)nrColumns, 0.05f, 1.0f);
+			sphereMatrixList.push_back(modelMatrix);
+			sphereParamList.push_back(glm::vec4(metallic, roughness, 0.0f, 0.0f));
+
+			BoundingBox box;
+			box.Min = glm::vec3(modelMatrix[3]) - Sphere->Radius;
+			box.Max = glm::vec3(modelMatrix[3]) + Sphere->Radius;
+			sphereHandleList.push_back(ObjectTree.Insert(box));
+		}
+	}
+
+	for (unsigned int i = 0; i < lightPositions.size(); ++i)
+	{
+		lightHandleList.push_back(ObjectTree.Insert(GetLightBox(lightPositions[i])));
+	}
+	ObjectTree.Build();
 
-	Shader* IBLShader = new Shader("shader/PBR/IBL/IBL.vs", "shader/PBR/IBL/IBL.fs");
 	IBLShader->Use();
 	IBLShader->SetVec3("albedo", glm::vec3(0.5f, 0.0f, 0.0f));
 	IBLShader->SetFloat("ao", 1.0f);
@@ -154,16 +242,12 @@ int main()
 	----------------------------------------------------*/
 
 
-	Shader* ERPCaptureShader = new Shader("shader/PBR/IBL/ERPCapture.vs", "shader/PBR/IBL/ERPCapture.fs");
-
-
 	GLuint CaptureWidth = 512, CaptureHeight = 512;
 	glm::mat4 CaptureProjectionMatrix = glm::perspective(glm::radians(90.0f), (GLfloat)CaptureWidth / (GLfloat)CaptureHeight, NEAR_PLAN, FAR_PLAN);
 
 	GLuint ERPTex = TexLoader->LoadHDRTexture((char*)"res/hdr/newport_loft.hdr");
 
-	vector<int> PosNormalTexAttri{ 3, 3, 2 };
-	SimpleRender* UnitCubeRender = new SimpleRender(PosNormalTexAttri, UnitCube, sizeof(UnitCube));
+	UnitCubeRender = new SimpleRender(PosNormalTexLayout(), UnitCube, sizeof(UnitCube));
 
 	
 	FrameParam* CaptureFrameParam = new FrameParam();
@@ -178,35 +262,39 @@ int main()
 	CaptureCubeParam->wrapMode = GL_CLAMP_TO_EDGE;
 	CaptureCubeParam->mipMode = GL_LINEAR;
 	CaptureCubeParam->bMipmap = false;
-	GLuint CaptureCubeMap = TexAllocator->GenCubeMap(CaptureWidth, CaptureHeight, CaptureCubeParam);
+	CaptureCubeMap = TexAllocator->GenCubeMap(CaptureWidth, CaptureHeight, CaptureCubeParam);
+
 
+	{
+		ProfileScope scope("ERPCapture");
 
-	// ERP采样
-	glViewport(0, 0, CaptureWidth, CaptureHeight);
-	glBindFramebuffer(GL_FRAMEBUFFER, CaptureFrame->FBO);
+		// ERP采样
+		GLStateCache::Viewport(0, 0, CaptureWidth, CaptureHeight);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, CaptureFrame->FBO);
 
 	
 
-	ERPCaptureShader->Use();
-	ERPCaptureShader->SetInt("equirectangularMap", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, ERPTex);
+		ERPCaptureShader->Use();
+		ERPCaptureShader->SetInt("equirectangularMap", 0);
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, ERPTex);
 
-	// 在立方体中心分别以六个viewMatrix各渲染一次, 这样就可以摘出立方体的六个面来
-	ERPCaptureShader->SetMat4("projection", CaptureProjectionMatrix);
-	for (unsigned int i = 0; i < 6; ++i)
-	{
-		ERPCaptureShader->SetMat4("view", CubeMapViewMatList[i]);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, CaptureCubeMap, 0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// 在立方体中心分别以六个viewMatrix各渲染一次, 这样就可以摘出立方体的六个面来
+		ERPCaptureShader->SetMat4("projection", CaptureProjectionMatrix);
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			ERPCaptureShader->SetMat4("view", CubeMapViewMatList[i]);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, CaptureCubeMap, 0);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		UnitCubeRender->Draw();
+			UnitCubeRender->Draw();
+		}
 	}
 
 
 
-	glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::Viewport(0, 0, Context->Width, Context->Height);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -216,9 +304,6 @@ int main()
 	----------------------------------------------------*/
 
 
-	Shader* DiffuseConvoShader = new Shader("shader/PBR/IBL/DiffuseConv.vs", "shader/PBR/IBL/DiffuseConv.fs");
-
-
 	GLuint DiffuseWidth = 32, DiffuseHeight = 32;
 	glm::mat4 DiffuseProjectionMatrix = glm::perspective(glm::radians(90.0f), (GLfloat)DiffuseWidth / (GLfloat)DiffuseHeight, NEAR_PLAN, FAR_PLAN);
 
@@ -229,7 +314,7 @@ int main()
 	DiffuseCubeParam->wrapMode = GL_CLAMP_TO_EDGE;
 	DiffuseCubeParam->mipMode = GL_LINEAR;
 	DiffuseCubeParam->bMipmap = false;
-	GLuint DiffuseCubeMap = TexAllocator->GenCubeMap(DiffuseWidth, DiffuseHeight, DiffuseCubeParam);
+	DiffuseCubeMap = TexAllocator->GenCubeMap(DiffuseWidth, DiffuseHeight, DiffuseCubeParam);
 
 
 	FrameParam* diffuseFrameParam = new FrameParam();
@@ -238,31 +323,35 @@ int main()
 	FrameObj* diffuseFrame = new FrameObj(DiffuseWidth, DiffuseHeight, diffuseFrameParam);
 
 
-	// 卷积计算
-	glViewport(0, 0, DiffuseWidth, DiffuseHeight);
-	glBindFramebuffer(GL_FRAMEBUFFER, diffuseFrame->FBO);
+	{
+		ProfileScope scope("DiffuseConvolution");
 
+		// 卷积计算
+		GLStateCache::Viewport(0, 0, DiffuseWidth, DiffuseHeight);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, diffuseFrame->FBO);
 
 
-	DiffuseConvoShader->Use();
-	DiffuseConvoShader->SetInt("EnvCubeMap", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, CaptureCubeMap);
 
-	DiffuseConvoShader->SetMat4("projection", DiffuseProjectionMatrix);
-	for (unsigned int i = 0; i < 6; ++i)
-	{
-		DiffuseConvoShader->SetMat4("view", CubeMapViewMatList[i]);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, DiffuseCubeMap, 0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		DiffuseConvoShader->Use();
+		DiffuseConvoShader->SetInt("EnvCubeMap", 0);
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, CaptureCubeMap);
 
-		UnitCubeRender->Draw();
+		DiffuseConvoShader->SetMat4("projection", DiffuseProjectionMatrix);
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			DiffuseConvoShader->SetMat4("view", CubeMapViewMatList[i]);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, DiffuseCubeMap, 0);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			UnitCubeRender->Draw();
+		}
 	}
 
 
 
-	glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::Viewport(0, 0, Context->Width, Context->Height);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -273,9 +362,6 @@ int main()
 	----------------------------------------------------*/
 
 
-
-	Shader* PrefilterShader = new Shader("shader/PBR/IBL/PrefilterHDR.vs", "shader/PBR/IBL/PrefilterHDR.fs");
-
 	GLuint PrefilterWidth = 128, PrefilterHeight = 128;
 	glm::mat4 PrefilterProjectionMatrix = glm::perspective(glm::radians(90.0f), (GLfloat)PrefilterWidth / (GLfloat)PrefilterHeight, NEAR_PLAN, FAR_PLAN);
 
@@ -286,7 +372,7 @@ int main()
 	PrefilterCubeParam->wrapMode = GL_CLAMP_TO_EDGE;
 	PrefilterCubeParam->mipMode = GL_LINEAR_MIPMAP_LINEAR;
 	PrefilterCubeParam->bMipmap = true;
-	GLuint PrefilterCubeMap = TexAllocator->GenCubeMap(PrefilterWidth, PrefilterHeight, PrefilterCubeParam);
+	PrefilterCubeMap = TexAllocator->GenCubeMap(PrefilterWidth, PrefilterHeight, PrefilterCubeParam);
 
 
 	FrameParam* PrefilterFrameParam = new FrameParam();
@@ -295,45 +381,49 @@ int main()
 	FrameObj* PrefilterFrame = new FrameObj(PrefilterWidth, PrefilterHeight, PrefilterFrameParam);
 
 
-	// 卷积计算
-	glBindFramebuffer(GL_FRAMEBUFFER, PrefilterFrame->FBO);
-
+	{
+		ProfileScope scope("Prefilter");
 
+		// 卷积计算
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, PrefilterFrame->FBO);
 
-	PrefilterShader->Use();
-	PrefilterShader->SetMat4("projection", PrefilterProjectionMatrix);
 
-	PrefilterShader->SetInt("EnvCubeMap", 0);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, CaptureCubeMap);
 
-	unsigned int maxMipLevels = 5;
-	for (unsigned int mip = 0; mip < maxMipLevels; ++mip)
-	{
-		unsigned int mipWidth = PrefilterWidth * std::pow(0.5, mip);
-		unsigned int mipHeight = PrefilterHeight * std::pow(0.5, mip);
+		PrefilterShader->Use();
+		PrefilterShader->SetMat4("projection", PrefilterProjectionMatrix);
 
-		glViewport(0, 0, mipWidth, mipHeight);
-		glBindRenderbuffer(GL_RENDERBUFFER, PrefilterFrame->RBO);
-		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
+		PrefilterShader->SetInt("EnvCubeMap", 0);
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, CaptureCubeMap);
 
-		float roughness = (float)mip / (float)(maxMipLevels - 1);
-		PrefilterShader->SetFloat("roughness", roughness);
-		for (unsigned int i = 0; i < 6; ++i)
+		unsigned int maxMipLevels = 5;
+		for (unsigned int mip = 0; mip < maxMipLevels; ++mip)
 		{
-			PrefilterShader->SetMat4("view", CubeMapViewMatList[i]);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, PrefilterCubeMap, mip);
+			unsigned int mipWidth = PrefilterWidth * std::pow(0.5, mip);
+			unsigned int mipHeight = PrefilterHeight * std::pow(0.5, mip);
 
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			GLStateCache::Viewport(0, 0, mipWidth, mipHeight);
+			glBindRenderbuffer(GL_RENDERBUFFER, PrefilterFrame->RBO);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
+
+			float roughness = (float)mip / (float)(maxMipLevels - 1);
+			PrefilterShader->SetFloat("roughness", roughness);
+			for (unsigned int i = 0; i < 6; ++i)
+			{
+				PrefilterShader->SetMat4("view", CubeMapViewMatList[i]);
+				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, PrefilterCubeMap, mip);
+
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			
-			UnitCubeRender->Draw();
+				UnitCubeRender->Draw();
+			}
 		}
 	}
 
 
 
-	glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::Viewport(0, 0, Context->Width, Context->Height);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -343,8 +433,6 @@ int main()
 	----------------------------------------------------*/
 
 
-	Shader* LUTShader = new Shader("shader/PBR/IBL/BRDFLUT.vs", "shader/PBR/IBL/BRDFLUT.fs");
-
 	GLuint LUTWidth = 512, LUTHeight = 512;
 
 
@@ -354,7 +442,7 @@ int main()
 	LUTParam->wrapMode = GL_CLAMP_TO_EDGE;
 	LUTParam->mipMode = GL_LINEAR;
 	LUTParam->bMipmap = false;
-	GLuint LUTTex = TexAllocator->GenTex(LUTWidth, LUTHeight, nullptr, LUTParam);
+	LUTTex = TexAllocator->GenTex(LUTWidth, LUTHeight, nullptr, LUTParam);
 
 
 	FrameParam* LUTFrameParam = new FrameParam();
@@ -363,284 +451,181 @@ int main()
 	FrameObj* LUTFrame = new FrameObj(LUTWidth, LUTHeight, LUTFrameParam);
 
 
-	// 卷积计算
-	glViewport(0, 0, LUTWidth, LUTHeight);
-	glBindFramebuffer(GL_FRAMEBUFFER, LUTFrame->FBO);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, LUTTex, 0);
+	{
+		ProfileScope scope("BRDFLUT");
+
+		// 卷积计算
+		GLStateCache::Viewport(0, 0, LUTWidth, LUTHeight);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, LUTFrame->FBO);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, LUTTex, 0);
 
 
 
-	LUTShader->Use();
+		LUTShader->Use();
 
-	QuadRender->Draw();
+		QuadRender->Draw();
+	}
 
 
 
-	glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::Viewport(0, 0, Context->Width, Context->Height);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
 
-
+void IBLScene::Render(float currentTime)
+{
 	/*----------------------------------------------------
-		Part Render Loop
+	Loop 计算通用Model矩阵
 	----------------------------------------------------*/
 
-	float deltaTime = 0;
-	float lastFrame = static_cast<float>(glfwGetTime());
-
-	// 绘制循环
-	while (!glfwWindowShouldClose(window))
-	{
-		/*----------------------------------------------------
-		Loop 帧间隔deltaTime刷新
-		----------------------------------------------------*/
-
 
-		float currentFrame = static_cast<float>(glfwGetTime());
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
+	// Model矩阵
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
 
 
+	GLStateCache::Viewport(0, 0, Context->Width, Context->Height);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
 
-		/*----------------------------------------------------
-		Loop 输入处理及相机位置更新
-		计算通用View及Projection矩阵
-		----------------------------------------------------*/
-
-
-		processInput(deltaTime, window);
-
-		// Projection矩阵
-		glm::mat4 projectionMatrix = glm::perspective(glm::radians(CurCamera->Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, NEAR_PLAN, FAR_PLAN); // 45度FOV, 视口长宽比, 近平面0.1, 远屏幕100
-		// View矩阵
-		glm::mat4 viewMatrix = CurCamera->LookAt();
-		// Model矩阵
-		glm::mat4 modelMatrix = glm::mat4(1.0f);
-
-
-		glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	GLStateCache::Enable(GL_DEPTH_TEST);
 
-		glEnable(GL_DEPTH_TEST);
 
+	/*------------------------------------------------------------------------------------------------------------------
+		Loop Skybox
+	--------------------------------------------------------------------------------------------------------------------*/
 
-		/*------------------------------------------------------------------------------------------------------------------
-			Loop Skybox
-		--------------------------------------------------------------------------------------------------------------------*/
+	{
+		ProfileScope scope("Skybox");
 
-		glDepthFunc(GL_LEQUAL);
+		GLStateCache::DepthFunc(GL_LEQUAL);
 
 
 		SkyboxShader->Use();
-		SkyboxShader->SetMat4("view", viewMatrix);
-		SkyboxShader->SetMat4("projection", projectionMatrix);
 		SkyboxShader->SetInt("skyboxTex", 0);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, CaptureCubeMap);
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, CaptureCubeMap);
 
 		UnitCubeRender->Draw();
 
 
-		glDepthFunc(GL_LESS);
+		GLStateCache::DepthFunc(GL_LESS);
+	}
+
+	/*------------------------------------------------------------------------------------------------------------------
+		Loop Light Obj
+	--------------------------------------------------------------------------------------------------------------------*/
 
-		/*------------------------------------------------------------------------------------------------------------------
-			Loop Light Obj
-		--------------------------------------------------------------------------------------------------------------------*/
+	{
+		ProfileScope scope("LightObj");
 
 		for (unsigned int i = 0; i < lightPositions.size(); ++i)
 		{
-			lightPositions[i] = lightPositions[i] + glm::vec3(sin(glfwGetTime() * 3.0) * 3.0, 0.0, 0.0);
+			lightPositions[i] = lightPositions[i] + glm::vec3(sin(currentTime * 3.0) * 3.0, 0.0, 0.0);
 		}
 
-		SingleColorShader->Use();
+		// 本帧光源一次上传, 供IBL shader读取
+		SceneLights->Clear();
+		for (unsigned int i = 0; i < lightPositions.size(); ++i)
+		{
+			SceneLights->Add(lightPositions[i], lightColors[i]);
+		}
+		SceneLights->Upload();
 
+		// 光源移动后更新包围盒, 球体与光源一次剔除
+		for (unsigned int i = 0; i < lightPositions.size(); ++i)
+		{
+			ObjectTree.Update(lightHandleList[i], GetLightBox(lightPositions[i]));
+		}
+		ObjectTree.Refit();
+		ObjectTree.Cull(ViewFrustum, visibleList);
+
+		LightInstances->Clear();
 		for (int i = 0; i < lightPositions.size(); i++)
 		{
-			SingleColorShader->SetVec3("InColor", lightColors[i]);
+			if (!visibleList[lightHandleList[i]])
+			{
+				Profiler::Get().AddCulled(1);
+				continue;
+			}
 
 			modelMatrix = glm::mat4(1.0f);
 			modelMatrix = glm::translate(modelMatrix, lightPositions[i]);
 			modelMatrix = glm::scale(modelMatrix, glm::vec3(0.5f));
-			Sphere->Draw(SingleColorShader, modelMatrix, viewMatrix, projectionMatrix);
+			LightInstances->Add(modelMatrix, glm::vec4(lightColors[i], 1.0f));
 		}
+		LightInstances->Upload();
 
+		SingleColorShader->Use();
+		Sphere->DrawInstanced(SingleColorShader, LightInstances);
+	}
 
-		/*--------------------------------------------------------------------------------------------------------------
-			Loop Render Obj
-		--------------------------------------------------------------------------------------------------------------*/
 
+	/*--------------------------------------------------------------------------------------------------------------
+		Loop Render Obj
+	--------------------------------------------------------------------------------------------------------------*/
+
+
+	{
+		ProfileScope scope("IBLSpheres");
 
 		IBLShader->Use();
 		IBLShader->SetInt("irradianceMap", 0);
 		IBLShader->SetInt("prefilterMap", 1);
 		IBLShader->SetInt("BRDFLUT", 2);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, DiffuseCubeMap);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, PrefilterCubeMap);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, LUTTex);
-
-		IBLShader->SetVec3("ViewPos", CurCamera->Pos);
-		for (unsigned int i = 0; i < lightPositions.size(); ++i)
-		{
-			IBLShader->SetVec3("lightPositions[" + std::to_string(i) + "]", lightPositions[i]);
-			IBLShader->SetVec3("lightColors[" + std::to_string(i) + "]", lightColors[i]);
-		}
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, DiffuseCubeMap);
+		GLStateCache::ActiveTexture(GL_TEXTURE1);
+		GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, PrefilterCubeMap);
+		GLStateCache::ActiveTexture(GL_TEXTURE2);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, LUTTex);
 
-		// 绘制球体
-		for (int row = 0; row < nrRows; ++row)
-		{
-			// 从上到下金属度递增
-			IBLShader->SetFloat("metallic", (float)row / (float)nrRows);
 
-			for (int col = 0; col < nrColumns; ++col)
+		// 只上传视锥内的球体
+		SphereInstances->Clear();
+		for (size_t i = 0; i < sphereMatrixList.size(); i++)
+		{
+			if (visibleList[sphereHandleList[i]])
 			{
-				// 从左到右粗糙度递增
-				IBLShader->SetFloat("roughness", glm::clamp((float)col / (float)nrColumns, 0.05f, 1.0f));
-
-				modelMatrix = glm::mat4(1.0f);
-				modelMatrix = glm::translate(modelMatrix, glm::vec3(
-					(col - (nrColumns / 2)) * spacing,
-					(row - (nrRows / 2)) * spacing,
-					0.0f
-				));
-
-				// 球体法线是在local空间生成的, 需要将其转换至World空间
-				IBLShader->SetMat3("normalMatrix", glm::transpose(glm::inverse(glm::mat3(modelMatrix))));
-
-				Sphere->Draw(IBLShader, modelMatrix, viewMatrix, projectionMatrix);
+				SphereInstances->Add(sphereMatrixList[i], sphereParamList[i]);
+			}
+			else
+			{
+				Profiler::Get().AddCulled(1);
 			}
 		}
+		SphereInstances->Upload();
 
-
-
-		/*--------------------------------------------------------------------------------------------------------------
-			Loop Debug Pass
-		--------------------------------------------------------------------------------------------------------------*/
-
-
-		// Debug代码, 直接显示各种中间结果的纹理附件
-		//glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		//glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		//RTShader->Use();
-		//glActiveTexture(GL_TEXTURE0);
-		//glBindTexture(GL_TEXTURE_2D, LUTTex);
-
-		//QuadRender->Draw(false);
-
-
-		/*----------------------------------------------------
-		Loop End
-		----------------------------------------------------*/
-
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+		// 一次绘制全部可见球体, 法线矩阵在shader中逐实例计算
+		Sphere->DrawInstanced(IBLShader, SphereInstances);
 	}
 
-	// 退出程序
-	glfwTerminate();
-	return 0;
-}
-
 
-// 初始化GLFW
-void InitGLFW()
-{
-	glfwInit();
 
-	// 设置OpenGL支持版本
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	/*--------------------------------------------------------------------------------------------------------------
+		Loop Debug Pass
+	--------------------------------------------------------------------------------------------------------------*/
 
-	// 使用OpenGL核心模式
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-}
 
+	// Debug代码, 直接显示各种中间结果的纹理附件
+	//GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
+	//glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-// 创建窗口对象
-GLFWwindow* CreateWindow()
-{
-	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "SoftRendererGL", NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return nullptr;
-	}
-	glfwMakeContextCurrent(window);
+	//RTShader->Use();
+	//GLStateCache::ActiveTexture(GL_TEXTURE0);
+	//GLStateCache::BindTexture(GL_TEXTURE_2D, LUTTex);
 
-	// 设置窗口大小变化时的回调
-	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-	return window;
-}
-
-// 窗口改变回调
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-	glViewport(0, 0, width, height);
+	//QuadRender->Draw(false);
 }
 
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(float deltaTime, GLFWwindow* window)
+BoundingBox IBLScene::GetLightBox(const glm::vec3& position) const
 {
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-		glfwSetWindowShouldClose(window, true);
-
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		CurCamera->ProcessKeyboard(EMoveDir::FORWARD, deltaTime);
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		CurCamera->ProcessKeyboard(EMoveDir::BACKWARD, deltaTime);
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		CurCamera->ProcessKeyboard(EMoveDir::LEFT, deltaTime);
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		CurCamera->ProcessKeyboard(EMoveDir::RIGHT, deltaTime);
+	BoundingBox box;
+	box.Min = position - Sphere->Radius * 0.5f;
+	box.Max = position + Sphere->Radius * 0.5f;
+	return box;
 }
-
-
-// glfw: whenever the mouse moves, this callback is called
-// -------------------------------------------------------
-bool firstMouse = true;
-float lastX = (float)SCR_WIDTH / 2.0;
-float lastY = (float)SCR_HEIGHT / 2.0;
-void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
-{
-	float xpos = static_cast<float>(xposIn);
-	float ypos = static_cast<float>(yposIn);
-
-	if (firstMouse)
-	{
-		lastX = xpos;
-		lastY = ypos;
-		firstMouse = false;
-	}
-
-	float xoffset = xpos - lastX;
-	float yoffset = lastY - ypos; // reversed since y-coordinates go from bottom to top
-
-	lastX = xpos;
-	lastY = ypos;
-
-	CurCamera->ProcessMouseMovement(xoffset, yoffset);
-}
-
-// glfw: whenever the mouse scroll wheel scrolls, this callback is called
-// ----------------------------------------------------------------------
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	CurCamera->ProcessMouseScroll(static_cast<float>(yoffset));
-}
-
-
-
-
-
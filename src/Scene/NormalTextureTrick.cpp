@@ -1,393 +1,251 @@
-﻿//#include <GLFW/glfw3.h>
-//#include <glad/glad.h>
-//#include <iostream>
-//
-//#include <glm/glm.hpp>
-//#include <glm/gtc/matrix_transform.hpp>
-//#include <glm/gtc/type_ptr.hpp>
-//
-//#include <assimp/Importer.hpp>
-//#include <assimp/scene.h>
-//#include <assimp/postprocess.h>
-//
-//#include "Data.h"
-//
-//#include "../render/Shader.h"
-//#include "../render/ModelRender.h"
-//#include "../obj/Camera.h"
-//#include "../tool/TextureLoader.h"
-//#include "../render/FrameBuffer.h"
-//#include "../render/SimpleRender.h"
-//
-//
-//// 常数定义
-//const float SCR_WIDTH = 1920;
-//const float SCR_HEIGHT = 1080;
-//
-//const GLuint SHADOW_WIDTH = 1024;
-//const GLuint SHADOW_HEIGHT = 1024;
-//
-//
-//// 函数声明
-//void InitGLFW();
-//GLFWwindow* CreateWindow();
-//
-//// 窗口尺寸改变回调, 初始化时同样会执行
-//void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-//// 输入回调函数声明
-//void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-//void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-//void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-//void processInput(float deltaTime, GLFWwindow* window);
-//
-//// 全局变量
-//Camera* CurCamera;
-//
-//TextureLoader* TexLoader;
-//
-//int main()
-//{
-//	/*----------------------------------------------------
-//		Part Init
-//	----------------------------------------------------*/
-//
-//
-//
-//	InitGLFW();
-//
-//	GLFWwindow* window = CreateWindow();
-//
-//	// 初始化glad
-//	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-//	{
-//		std::cout << "Failed to initialize GLAD" << std::endl;
-//		return -1;
-//	}
-//
-//	// 创建场景相机
-//	CurCamera = new Camera(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-//
-//	glfwMakeContextCurrent(window);
-//	glfwSetCursorPosCallback(window, mouse_callback); // 鼠标滑动回调
-//	glfwSetScrollCallback(window, scroll_callback); // 鼠标滚轮回调
-//
-//	//glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-//
-//	TexLoader = new TextureLoader();
-//
-//
-//
-//	/*----------------------------------------------------
-//		Part Const Definition
-//	----------------------------------------------------*/
-//
-//	vector<int> normalTexVertDivisor{ 3, 3, 2 };
-//	vector<int> normalTBNDivisor{ 3, 3, 2, 3, 3 };
-//
-//	glm::vec3 lightPos(0.0f, 0.0f, 0.0f);
-//	glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
-//
-//	GLfloat near_plane = 1.0f, far_plane = 25.0f;
-//
-//
-//	unsigned int BrickTex = TexLoader->LoadTexture((char*)"res/textures/brickwall.jpg");
-//	unsigned int BrickNormalTex = TexLoader->LoadTexture((char*)"res/textures/brickwall_normal.jpg");
-//
-//
-//
-//	/*----------------------------------------------------
-//		Part Prepare Scene
-//	----------------------------------------------------*/
-//
-//
-//	// positions
-//	glm::vec3 pos1(-1.0, 1.0, 0.0);
-//	glm::vec3 pos2(-1.0, -1.0, 0.0);
-//	glm::vec3 pos3(1.0, -1.0, 0.0);
-//	glm::vec3 pos4(1.0, 1.0, 0.0);
-//	// texture coordinates
-//	glm::vec2 uv1(0.0, 1.0);
-//	glm::vec2 uv2(0.0, 0.0);
-//	glm::vec2 uv3(1.0, 0.0);
-//	glm::vec2 uv4(1.0, 1.0);
-//	// normal vector
-//	glm::vec3 nm(0.0, 0.0, 1.0);
-//
-//	// calculate tangent/bitangent vectors of both triangles
-//	glm::vec3 tangent1, bitangent1;
-//	glm::vec3 tangent2, bitangent2;
-//	// - triangle 1
-//	glm::vec3 edge1 = pos2 - pos1;
-//	glm::vec3 edge2 = pos3 - pos1;
-//	glm::vec2 deltaUV1 = uv2 - uv1;
-//	glm::vec2 deltaUV2 = uv3 - uv1;
-//
-//	GLfloat f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-//
-//	tangent1.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-//	tangent1.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-//	tangent1.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-//	tangent1 = glm::normalize(tangent1);
-//
-//	bitangent1.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-//	bitangent1.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-//	bitangent1.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-//	bitangent1 = glm::normalize(bitangent1);
-//
-//	// - triangle 2
-//	edge1 = pos3 - pos1;
-//	edge2 = pos4 - pos1;
-//	deltaUV1 = uv3 - uv1;
-//	deltaUV2 = uv4 - uv1;
-//
-//	f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-//
-//	tangent2.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-//	tangent2.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-//	tangent2.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-//	tangent2 = glm::normalize(tangent2);
-//
-//
-//	bitangent2.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-//	bitangent2.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-//	bitangent2.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-//	bitangent2 = glm::normalize(bitangent2);
-//
-//
-//	GLfloat quadVertices[] = {
-//		// Positions            // normal         // TexCoords  // Tangent                          // Bitangent
-//		pos1.x, pos1.y, pos1.z, nm.x, nm.y, nm.z, uv1.x, uv1.y, tangent1.x, tangent1.y, tangent1.z, bitangent1.x, bitangent1.y, bitangent1.z,
-//		pos2.x, pos2.y, pos2.z, nm.x, nm.y, nm.z, uv2.x, uv2.y, tangent1.x, tangent1.y, tangent1.z, bitangent1.x, bitangent1.y, bitangent1.z,
-//		pos3.x, pos3.y, pos3.z, nm.x, nm.y, nm.z, uv3.x, uv3.y, tangent1.x, tangent1.y, tangent1.z, bitangent1.x, bitangent1.y, bitangent1.z,
-//
-//		pos1.x, pos1.y, pos1.z, nm.x, nm.y, nm.z, uv1.x, uv1.y, tangent2.x, tangent2.y, tangent2.z, bitangent2.x, bitangent2.y, bitangent2.z,
-//		pos3.x, pos3.y, pos3.z, nm.x, nm.y, nm.z, uv3.x, uv3.y, tangent2.x, tangent2.y, tangent2.z, bitangent2.x, bitangent2.y, bitangent2.z,
-//		pos4.x, pos4.y, pos4.z, nm.x, nm.y, nm.z, uv4.x, uv4.y, tangent2.x, tangent2.y, tangent2.z, bitangent2.x, bitangent2.y, bitangent2.z
-//	};
-//
-//
-//	// 2D平面
-//	SimpleRender* WallRender = new SimpleRender(normalTBNDivisor, quadVertices, sizeof(quadVertices));
-//	WallRender->BindTexture(BrickTex);
-//	WallRender->BindTexture(BrickNormalTex);
-//
-//
-//	// 点光源
-//	SimpleRender* PointLightRender = new SimpleRender(normalTexVertDivisor, Cube_NormalTexVert, sizeof(Cube_NormalTexVert));
-//
-//
-//
-//	/*----------------------------------------------------
-//		Part Shader
-//	----------------------------------------------------*/
-//
-//
-//	
-//	Shader* BlinnPhongNormalShader = new Shader("shader/Map/Blinn_Phong_NormalMap.vs", "shader/Map/Blinn_Phong_NormalMap.fs");
-//	BlinnPhongNormalShader->Use();
-//	BlinnPhongNormalShader->SetInt("diffuseTex", 0);
-//	BlinnPhongNormalShader->SetInt("normalTex", 1);
-//	BlinnPhongNormalShader->SetVec3("LightPos", lightPos);
-//	// 点光源静态参数
-//	BlinnPhongNormalShader->SetVec3("pointLight.ambient", glm::vec3(0.2f, 0.2f, 0.2f));
-//	BlinnPhongNormalShader->SetVec3("pointLight.diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
-//	BlinnPhongNormalShader->SetVec3("pointLight.specular", glm::vec3(1.0f, 1.0f, 1.0f));
-//	BlinnPhongNormalShader->SetFloat("pointLight.constant", 1.0f);
-//	BlinnPhongNormalShader->SetFloat("pointLight.linear", 0.09f);
-//	BlinnPhongNormalShader->SetFloat("pointLight.quadratic", 0.032f);
-//
-//
-//
-//	// 绘制点光源模型用
-//	Shader* PointLightShader = new Shader("shader/SingleColor.vs", "shader/SingleColor.fs");
-//	PointLightShader->Use();
-//	PointLightShader->SetVec3("InColor", glm::vec3(0.5));
-//
-//
-//
-//	/*----------------------------------------------------
-//		Part Render Loop
-//	----------------------------------------------------*/
-//	float deltaTime = 0;
-//	float lastFrame = static_cast<float>(glfwGetTime());
-//
-//	while (!glfwWindowShouldClose(window))
-//	{
-//		/*----------------------------------------------------
-//		Loop 帧间隔deltaTime刷新
-//		----------------------------------------------------*/
-//
-//
-//		float currentFrame = static_cast<float>(glfwGetTime());
-//		deltaTime = currentFrame - lastFrame;
-//		lastFrame = currentFrame;
-//
-//
-//
-//		/*----------------------------------------------------
-//		Loop 输入处理及相机位置更新
-//		计算通用View及Projection矩阵
-//		----------------------------------------------------*/
-//
-//
-//		processInput(deltaTime, window);
-//
-//		// Projection矩阵
-//		glm::mat4 projectionMatrix = glm::perspective(glm::radians(CurCamera->Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, near_plane, far_plane); // 45度FOV, 视口长宽比, 近平面, 远屏幕
-//		// View矩阵
-//		glm::mat4 viewMatrix = CurCamera->LookAt();
-//		// Model矩阵
-//		glm::mat4 modelMatrix = glm::mat4(1.0f);
-//
-//
-//		/*----------------------------------------------------
-//		Loop 状态重置
-//		----------------------------------------------------*/
-//
-//
-//		glEnable(GL_DEPTH_TEST); // 开启深度测试
-//
-//		glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // 设置背景色
-//		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // 清除颜色及深度缓冲
-//
-//
-//
-//		/*----------------------------------------------------
-//		Loop 场景渲染
-//		----------------------------------------------------*/
-//
-//
-//		// 砖墙模型
-//		modelMatrix = glm::mat4(1.0f);
-//		BlinnPhongNormalShader->Use();
-//		modelMatrix = glm::translate(modelMatrix, glm::vec3(0, 0, -2));
-//		modelMatrix = glm::rotate(modelMatrix, glm::radians(-45.0f), glm::vec3(1, 0, 0));
-//		BlinnPhongNormalShader->SetMat4("model", modelMatrix);
-//		BlinnPhongNormalShader->SetMat4("view", viewMatrix);
-//		BlinnPhongNormalShader->SetMat4("projection", projectionMatrix);
-//		BlinnPhongNormalShader->SetVec3("ViewPos", CurCamera->Pos);
-//
-//		WallRender->Draw(false);
-//
-//
-//		// 光源模型
-//		modelMatrix = glm::mat4(1.0f);
-//		modelMatrix = glm::translate(modelMatrix, lightPos);
-//		modelMatrix = glm::scale(modelMatrix, lightColor);
-//		PointLightShader->Use();
-//		PointLightShader->SetMat4("model", modelMatrix);
-//		PointLightShader->SetMat4("view", viewMatrix);
-//		PointLightShader->SetMat4("projection", projectionMatrix);
-//
-//		PointLightRender->Draw(false);
-//
-//
-//
-//		/*----------------------------------------------------
-//		Loop End
-//		----------------------------------------------------*/
-//
-//		glfwSwapBuffers(window);
-//		glfwPollEvents();
-//	}
-//
-//	// 退出程序
-//	glfwTerminate();
-//	return 0;
-//}
-//
-//
-//// 初始化GLFW
-//void InitGLFW()
-//{
-//	glfwInit();
-//
-//	// 设置OpenGL支持版本
-//	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-//	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-//
-//	// 使用OpenGL核心模式
-//	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-//}
-//
-//
-//// 创建窗口对象
-//GLFWwindow* CreateWindow()
-//{
-//	GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "SoftRendererGL", NULL, NULL);
-//	if (window == NULL)
-//	{
-//		std::cout << "Failed to create GLFW window" << std::endl;
-//		glfwTerminate();
-//		return nullptr;
-//	}
-//	glfwMakeContextCurrent(window);
-//
-//	// 设置窗口大小变化时的回调
-//	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-//
-//	return window;
-//}
-//
-//// 窗口改变回调
-//void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-//{
-//	glViewport(0, 0, width, height);
-//}
-//
-//
-//// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-//// ---------------------------------------------------------------------------------------------------------
-//void processInput(float deltaTime, GLFWwindow* window)
-//{
-//	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-//		glfwSetWindowShouldClose(window, true);
-//
-//	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-//		CurCamera->ProcessKeyboard(EMoveDir::FORWARD, deltaTime);
-//	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-//		CurCamera->ProcessKeyboard(EMoveDir::BACKWARD, deltaTime);
-//	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-//		CurCamera->ProcessKeyboard(EMoveDir::LEFT, deltaTime);
-//	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-//		CurCamera->ProcessKeyboard(EMoveDir::RIGHT, deltaTime);
-//}
-//
-//
-//// glfw: whenever the mouse moves, this callback is called
-//// -------------------------------------------------------
-//bool firstMouse = true;
-//float lastX = (float)SCR_WIDTH / 2.0;
-//float lastY = (float)SCR_HEIGHT / 2.0;
-//void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
-//{
-//	float xpos = static_cast<float>(xposIn);
-//	float ypos = static_cast<float>(yposIn);
-//
-//	if (firstMouse)
-//	{
-//		lastX = xpos;
-//		lastY = ypos;
-//		firstMouse = false;
-//	}
-//
-//	float xoffset = xpos - lastX;
-//	float yoffset = lastY - ypos; // reversed since y-coordinates go from bottom to top
-//
-//	lastX = xpos;
-//	lastY = ypos;
-//
-//	CurCamera->ProcessMouseMovement(xoffset, yoffset);
-//}
-//
-//// glfw: whenever the mouse scroll wheel scrolls, this callback is called
-//// ----------------------------------------------------------------------
-//void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
-//{
-//	CurCamera->ProcessMouseScroll(static_cast<float>(yoffset));
-//}
-//
-//
-//
-//
-//
+﻿#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <iostream>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "Data.h"
+
+#include "../render/Shader.h"
+#include "../render/ModelRender.h"
+#include "../obj/Camera.h"
+#include "../tool/TextureLoader.h"
+#include "../render/FrameBuffer.h"
+#include "../render/SimpleRender.h"
+#include "../app/Profiler.h"
+#include "SceneBase.h"
+#include "../render/GLStateCache.h"
+
+
+// 常数定义
+static const float NEAR_PLAN = 1.0f;
+static const float FAR_PLAN = 25.0f;
+
+
+// 法线贴图, 手动计算平面的切线空间TBN
+class NormalTextureTrickScene : public SceneBase
+{
+public:
+
+	void Init() override;
+
+	void Render(float currentTime) override;
+
+private:
+
+	TextureLoader* TexLoader;
+
+	SimpleRender* WallRender;
+
+	SimpleRender* PointLightRender;
+
+	Shader* BlinnPhongNormalShader;
+
+	Shader* PointLightShader;
+
+	glm::vec3 lightPos;
+
+	glm::vec3 lightColor;
+};
+
+REGISTER_SCENE("NormalTextureTrick", NormalTextureTrickScene)
+
+
+void NormalTextureTrickScene::Init()
+{
+	NearPlan = NEAR_PLAN;
+	FarPlan = FAR_PLAN;
+
+	// 创建场景相机
+	CurCamera = new Camera(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	// 基准测试绕砖墙环绕
+	PathCenter = glm::vec3(0.0f, 0.0f, -2.0f);
+
+	TexLoader = new TextureLoader();
+
+
+
+	/*----------------------------------------------------
+		Part Const Definition
+	----------------------------------------------------*/
+
+
+	lightPos = glm::vec3(0.0f, 0.0f, 0.0f);
+	lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+
+
+	unsigned int BrickTex = TexLoader->LoadTexture((char*)"res/textures/brickwall.jpg");
+	unsigned int BrickNormalTex = TexLoader->LoadTexture((char*)"res/textures/brickwall_normal.jpg");
+
+
+
+	/*----------------------------------------------------
+		Part Prepare Scene
+	----------------------------------------------------*/
+
+
+	// positions
+	glm::vec3 pos1(-1.0, 1.0, 0.0);
+	glm::vec3 pos2(-1.0, -1.0, 0.0);
+	glm::vec3 pos3(1.0, -1.0, 0.0);
+	glm::vec3 pos4(1.0, 1.0, 0.0);
+	// texture coordinates
+	glm::vec2 uv1(0.0, 1.0);
+	glm::vec2 uv2(0.0, 0.0);
+	glm::vec2 uv3(1.0, 0.0);
+	glm::vec2 uv4(1.0, 1.0);
+	// normal vector
+	glm::vec3 nm(0.0, 0.0, 1.0);
+
+	// calculate tangent/bitangent vectors of both triangles
+	glm::vec3 tangent1, bitangent1;
+	glm::vec3 tangent2, bitangent2;
+	// - triangle 1
+	glm::vec3 edge1 = pos2 - pos1;
+	glm::vec3 edge2 = pos3 - pos1;
+	glm::vec2 deltaUV1 = uv2 - uv1;
+	glm::vec2 deltaUV2 = uv3 - uv1;
+
+	GLfloat f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+
+	tangent1.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
+	tangent1.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
+	tangent1.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
+	tangent1 = glm::normalize(tangent1);
+
+	bitangent1.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
+	bitangent1.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
+	bitangent1.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
+	bitangent1 = glm::normalize(bitangent1);
+
+	// - triangle 2
+	edge1 = pos3 - pos1;
+	edge2 = pos4 - pos1;
+	deltaUV1 = uv3 - uv1;
+	deltaUV2 = uv4 - uv1;
+
+	f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+
+	tangent2.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
+	tangent2.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
+	tangent2.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
+	tangent2 = glm::normalize(tangent2);
+
+
+	bitangent2.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
+	bitangent2.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
+	bitangent2.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
+	bitangent2 = glm::normalize(bitangent2);
+
+
+	GLfloat quadVertices[] = {
+		// Positions            // normal         // TexCoords  // Tangent                          // Bitangent
+		pos1.x, pos1.y, pos1.z, nm.x, nm.y, nm.z, uv1.x, uv1.y, tangent1.x, tangent1.y, tangent1.z, bitangent1.x, bitangent1.y, bitangent1.z,
+		pos2.x, pos2.y, pos2.z, nm.x, nm.y, nm.z, uv2.x, uv2.y, tangent1.x, tangent1.y, tangent1.z, bitangent1.x, bitangent1.y, bitangent1.z,
+		pos3.x, pos3.y, pos3.z, nm.x, nm.y, nm.z, uv3.x, uv3.y, tangent1.x, tangent1.y, tangent1.z, bitangent1.x, bitangent1.y, bitangent1.z,
+
+		pos1.x, pos1.y, pos1.z, nm.x, nm.y, nm.z, uv1.x, uv1.y, tangent2.x, tangent2.y, tangent2.z, bitangent2.x, bitangent2.y, bitangent2.z,
+		pos3.x, pos3.y, pos3.z, nm.x, nm.y, nm.z, uv3.x, uv3.y, tangent2.x, tangent2.y, tangent2.z, bitangent2.x, bitangent2.y, bitangent2.z,
+		pos4.x, pos4.y, pos4.z, nm.x, nm.y, nm.z, uv4.x, uv4.y, tangent2.x, tangent2.y, tangent2.z, bitangent2.x, bitangent2.y, bitangent2.z
+	};
+
+
+	// 2D平面
+	WallRender = new SimpleRender(PosNormalTexTBNLayout(), quadVertices, sizeof(quadVertices));
+	WallRender->BindTexture(BrickTex);
+	WallRender->BindTexture(BrickNormalTex);
+
+
+	// 点光源
+	PointLightRender = new SimpleRender(PosNormalTexLayout(), Cube_NormalTexVert, sizeof(Cube_NormalTexVert));
+
+
+
+	/*----------------------------------------------------
+		Part Shader
+	----------------------------------------------------*/
+
+
+	
+	BlinnPhongNormalShader = new Shader("shader/Map/Blinn_Phong_NormalMap.vs", "shader/Map/Blinn_Phong_NormalMap.fs");
+	BlinnPhongNormalShader->Use();
+	BlinnPhongNormalShader->SetInt("diffuseTex", 0);
+	BlinnPhongNormalShader->SetInt("normalTex", 1);
+	BlinnPhongNormalShader->SetVec3("LightPos", lightPos);
+	// 点光源静态参数
+	BlinnPhongNormalShader->SetVec3("pointLight.ambient", glm::vec3(0.2f, 0.2f, 0.2f));
+	BlinnPhongNormalShader->SetVec3("pointLight.diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
+	BlinnPhongNormalShader->SetVec3("pointLight.specular", glm::vec3(1.0f, 1.0f, 1.0f));
+	BlinnPhongNormalShader->SetFloat("pointLight.constant", 1.0f);
+	BlinnPhongNormalShader->SetFloat("pointLight.linear", 0.09f);
+	BlinnPhongNormalShader->SetFloat("pointLight.quadratic", 0.032f);
+
+
+
+	// 绘制点光源模型用
+	PointLightShader = new Shader("shader/SingleColor.vs", "shader/SingleColor.fs");
+	PointLightShader->Use();
+	PointLightShader->SetVec3("InColor", glm::vec3(0.5));
+}
+
+void NormalTextureTrickScene::Render(float currentTime)
+{
+	/*----------------------------------------------------
+	Loop 计算通用Model矩阵
+	----------------------------------------------------*/
+
+
+	// Model矩阵
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
+
+
+	/*----------------------------------------------------
+	Loop 状态重置
+	----------------------------------------------------*/
+
+
+	GLStateCache::Viewport(0, 0, Context->Width, Context->Height);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, Context->GetScreenFBO());
+
+	GLStateCache::Enable(GL_DEPTH_TEST); // 开启深度测试
+
+	glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // 设置背景色
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // 清除颜色及深度缓冲
+
+
+
+	/*----------------------------------------------------
+	Loop 场景渲染
+	----------------------------------------------------*/
+
+
+	{
+		ProfileScope scope("Scene");
+
+		// 砖墙模型
+		modelMatrix = glm::mat4(1.0f);
+		BlinnPhongNormalShader->Use();
+		modelMatrix = glm::translate(modelMatrix, glm::vec3(0, 0, -2));
+		modelMatrix = glm::rotate(modelMatrix, glm::radians(-45.0f), glm::vec3(1, 0, 0));
+		BlinnPhongNormalShader->SetMat4("model", modelMatrix);
+
+		WallRender->Draw(false);
+
+
+		// 光源模型
+		modelMatrix = glm::mat4(1.0f);
+		modelMatrix = glm::translate(modelMatrix, lightPos);
+		modelMatrix = glm::scale(modelMatrix, lightColor);
+		PointLightShader->Use();
+		PointLightShader->SetMat4("model", modelMatrix);
+
+		PointLightRender->Draw(false);
+	}
+}
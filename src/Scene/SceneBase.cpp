@@ -0,0 +1,99 @@
+﻿#include <algorithm>
+
+#include "SceneBase.h"
+
+SceneBase::~SceneBase()
+{
+	delete FrameUniformBuffer;
+}
+
+CameraPath SceneBase::BuildDefaultPath(float duration) const
+{
+	float radius = PathRadius;
+	if (radius <= 0.0f)
+	{
+		glm::vec3 offset = CurCamera->Pos - PathCenter;
+		radius = glm::length(glm::vec2(offset.x, offset.z));
+	}
+
+	return CameraPath::MakeOrbit(PathCenter, CurCamera->Pos, radius, duration);
+}
+
+glm::mat4 SceneBase::GetProjectionMatrix() const
+{
+	return glm::perspective(glm::radians(CurCamera->Zoom), (float)Context->Width / (float)Context->Height, NearPlan, FarPlan);
+}
+
+void SceneBase::UpdateFrameUniforms()
+{
+	if (!FrameUniformBuffer)
+	{
+		FrameUniformBuffer = new UniformBuffer(FRAME_UNIFORM_BINDING, sizeof(FrameUniforms));
+	}
+
+	FrameUniforms uniforms;
+	uniforms.View = CurCamera->LookAt();
+	uniforms.Projection = GetProjectionMatrix();
+	uniforms.ViewProj = uniforms.Projection * uniforms.View;
+	uniforms.ViewPos = CurCamera->Pos;
+	uniforms.NearPlane = NearPlan;
+	uniforms.FarPlane = FarPlan;
+	uniforms.Padding = 0.0f;
+	uniforms.ScreenSize = glm::vec2((float)Context->Width, (float)Context->Height);
+
+	FrameUniformBuffer->Update(&uniforms, sizeof(uniforms));
+
+	ViewProj = uniforms.ViewProj;
+	ViewFrustum = Frustum::FromMatrix(ViewProj);
+}
+
+bool SceneBase::Pick(float screenX, float screenY, float screenWidth, float screenHeight, RayHit& hit) const
+{
+	float ndcX = screenX / screenWidth * 2.0f - 1.0f;
+	float ndcY = 1.0f - screenY / screenHeight * 2.0f;
+
+	// 近平面及远平面上的对应点反投影回世界空间
+	glm::mat4 invViewProj = glm::inverse(ViewProj);
+	glm::vec4 nearPoint = invViewProj * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+	glm::vec4 farPoint = invViewProj * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+	glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+	glm::vec3 ray = glm::vec3(farPoint) / farPoint.w - origin;
+
+	return ObjectTree.RayCast(origin, glm::normalize(ray), glm::length(ray), hit);
+}
+
+
+std::vector<SceneEntry>& SceneRegistry::GetList()
+{
+	// 函数内静态变量, 避免跨编译单元的静态初始化顺序问题
+	static std::vector<SceneEntry> sceneList;
+	return sceneList;
+}
+
+std::vector<SceneEntry> SceneRegistry::GetSortedList()
+{
+	std::vector<SceneEntry> sceneList = GetList();
+	std::sort(sceneList.begin(), sceneList.end(), [](const SceneEntry& a, const SceneEntry& b) { return a.Name < b.Name; });
+	return sceneList;
+}
+
+void SceneRegistry::Register(const std::string& name, SceneCreateFunc func)
+{
+	SceneEntry entry;
+	entry.Name = name;
+	entry.Create = func;
+	GetList().push_back(entry);
+}
+
+SceneBase* SceneRegistry::Create(const std::string& name)
+{
+	for (const SceneEntry& entry : GetList())
+	{
+		if (entry.Name == name)
+		{
+			return entry.Create();
+		}
+	}
+
+	return nullptr;
+}
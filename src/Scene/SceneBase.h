@@ -0,0 +1,102 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../app/RenderContext.h"
+#include "../buffer/UniformBuffer.h"
+#include "../obj/Camera.h"
+#include "../obj/CameraPath.h"
+#include "../obj/Frustum.h"
+#include "../obj/BVH.h"
+
+// 场景基类, 原先每个场景独立的main()拆分为Init和Render两部分
+class SceneBase
+{
+public:
+
+	RenderContext* Context = nullptr;
+
+	Camera* CurCamera = nullptr;
+
+	float NearPlan = 0.1f;
+
+	float FarPlan = 100.0f;
+
+	// 基准测试默认环绕路径的中心及半径, 半径为0时取相机初始位置到中心的距离
+	glm::vec3 PathCenter = glm::vec3(0.0f);
+
+	float PathRadius = 0.0f;
+
+	// 首次UpdateFrameUniforms时创建, 随场景销毁
+	UniformBuffer* FrameUniformBuffer = nullptr;
+
+	// 当前相机的视锥, 由UpdateFrameUniforms更新, 场景据此剔除不可见的物体
+	Frustum ViewFrustum;
+
+	glm::mat4 ViewProj = glm::mat4(1.0f);
+
+	// 场景物体的世界包围盒, 场景Init时插入并Build, 用于剔除及拾取
+	BVH ObjectTree;
+
+public:
+
+	virtual ~SceneBase();
+
+	// 创建资源并完成预计算, 调用前上下文已就绪
+	virtual void Init() = 0;
+
+	// 渲染一帧至Context->GetScreenFBO(), currentTime为场景时间(秒)
+	virtual void Render(float currentTime) = 0;
+
+	// 基准测试未指定相机路径时使用, 默认绕PathCenter环绕一周
+	virtual CameraPath BuildDefaultPath(float duration) const;
+
+	glm::mat4 GetProjectionMatrix() const;
+
+	// 每帧Render前调用, 以当前相机上传FrameUniforms, 各shader经uniform block读取view/projection/ViewPos
+	void UpdateFrameUniforms();
+
+	// 窗口坐标(像素, 原点在左上)处的射线拾取ObjectTree, 使用最近一次UpdateFrameUniforms的相机
+	bool Pick(float screenX, float screenY, float screenWidth, float screenHeight, RayHit& hit) const;
+};
+
+
+typedef SceneBase* (*SceneCreateFunc)();
+
+struct SceneEntry {
+	std::string Name;
+	SceneCreateFunc Create;
+};
+
+// 场景注册表, 各场景文件通过REGISTER_SCENE在静态初始化阶段注册
+class SceneRegistry
+{
+public:
+
+	// 按名称排序
+	static std::vector<SceneEntry> GetSortedList();
+
+	static void Register(const std::string& name, SceneCreateFunc func);
+
+	// 名称不存在时返回nullptr
+	static SceneBase* Create(const std::string& name);
+
+private:
+
+	static std::vector<SceneEntry>& GetList();
+};
+
+struct SceneRegister {
+	SceneRegister(const char* name, SceneCreateFunc func)
+	{
+		SceneRegistry::Register(name, func);
+	}
+};
+
+#define REGISTER_SCENE(Name, Class) \
+	static SceneBase* Create##Class() { return new Class(); } \
+	static SceneRegister Register##Class(Name, Create##Class);
@@ -0,0 +1,455 @@
+﻿#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Benchmark.h"
+#include "FrameStats.h"
+#include "../Scene/SceneBase.h"
+#include "../render/MeshCache.h"
+#include "../render/ProgramCache.h"
+#include "../render/ShaderCompileQueue.h"
+#include "../buffer/GeometryArena.h"
+
+// JSON字符串转义, 仅处理场景名及驱动字符串中可能出现的字符
+static std::string EscapeJson(const std::string& str)
+{
+	std::string result;
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			result += '\\';
+		}
+		if ((unsigned char)c >= 0x20)
+		{
+			result += c;
+		}
+	}
+	return result;
+}
+
+// 输出min/median/p99/avg/max, 无数据时输出null(如驱动不支持GPU计时)
+static void WriteSummary(std::ofstream& file, const FrameStats& stats)
+{
+	if (stats.FrameTimeList.empty())
+	{
+		file << "null";
+		return;
+	}
+
+	file << "{ \"min\": " << stats.Min()
+		<< ", \"median\": " << stats.Percentile(50.0)
+		<< ", \"p99\": " << stats.Percentile(99.0)
+		<< ", \"avg\": " << stats.Average()
+		<< ", \"max\": " << stats.Max() << " }";
+}
+
+// 未取得的GPU耗时输出null
+static void WriteGpuMs(std::ofstream& file, double gpuMs)
+{
+	if (gpuMs >= 0.0)
+	{
+		file << gpuMs;
+	}
+	else
+	{
+		file << "null";
+	}
+}
+
+#ifdef GL_INSTRUMENT
+// 输出各类GL调用次数, 计数为整数, 汇总为平均值
+static void WriteGLCalls(std::ofstream& file, const double* countList)
+{
+	file << "{ ";
+	for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+	{
+		file << (i > 0 ? ", " : "") << "\"" << glad_call_type_name[i] << "\": " << countList[i];
+	}
+	file << " }";
+}
+
+static void WriteGLCalls(std::ofstream& file, const GLCallStats& stats)
+{
+	double countList[GL_CALL_TYPE_COUNT];
+	for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+	{
+		countList[i] = stats.Count[i];
+	}
+	WriteGLCalls(file, countList);
+}
+#endif
+
+// 输出单帧的cpu_ms, gpu_ms, draw_calls, culled及passes字段, 不含外层括号
+static void WriteFrameFields(std::ofstream& file, const FrameSample& frame)
+{
+	file << "\"cpu_ms\": " << frame.CpuMs << ", \"gpu_ms\": ";
+	WriteGpuMs(file, frame.GpuMs);
+	file << ", \"draw_calls\": " << frame.DrawCalls;
+	file << ", \"culled\": " << frame.Culled;
+#ifdef GL_INSTRUMENT
+	file << ", \"gl\": ";
+	WriteGLCalls(file, frame.GLCalls);
+#endif
+	file << ", \"passes\": [";
+	for (size_t p = 0; p < frame.PassList.size(); p++)
+	{
+		const PassSample& pass = frame.PassList[p];
+		file << (p > 0 ? ", " : "") << "{ \"name\": \"" << EscapeJson(pass.Name) << "\", \"cpu_ms\": " << pass.CpuMs << ", \"gpu_ms\": ";
+		WriteGpuMs(file, pass.GpuMs);
+		file << ", \"draw_calls\": " << pass.DrawCalls;
+		file << ", \"culled\": " << pass.Culled;
+#ifdef GL_INSTRUMENT
+		file << ", \"gl\": ";
+		WriteGLCalls(file, pass.GLCalls);
+#endif
+		file << " }";
+	}
+	file << "]";
+}
+
+Benchmark::Benchmark(GLuint InWidth, GLuint InHeight, const RunParam& InContextParam, const BenchParam& InParam)
+{
+	Width = InWidth;
+	Height = InHeight;
+	ContextParam = InContextParam;
+	Param = InParam;
+}
+
+BenchParam Benchmark::ParseArgs(int argc, char** argv)
+{
+	BenchParam param;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--bench" && i + 1 < argc)
+		{
+			param.bEnabled = true;
+
+			std::string sceneArg = argv[++i];
+			if (sceneArg != "all")
+			{
+				std::stringstream stream(sceneArg);
+				std::string name;
+				while (std::getline(stream, name, ','))
+				{
+					if (!name.empty())
+					{
+						param.SceneList.push_back(name);
+					}
+				}
+			}
+		}
+		else if (arg == "--list")
+		{
+			param.bListScene = true;
+		}
+		else if (arg == "--out" && i + 1 < argc)
+		{
+			param.OutPath = argv[++i];
+		}
+		else if (arg == "--warmup" && i + 1 < argc)
+		{
+			param.WarmupFrames = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--frames" && i + 1 < argc)
+		{
+			param.MeasureFrames = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--camera-path" && i + 1 < argc)
+		{
+			param.CameraPathFile = argv[++i];
+		}
+	}
+
+	return param;
+}
+
+void Benchmark::PrintSceneList()
+{
+	for (const SceneEntry& entry : SceneRegistry::GetSortedList())
+	{
+		std::cout << entry.Name << std::endl;
+	}
+}
+
+bool Benchmark::Run()
+{
+	std::vector<std::string> sceneList = Param.SceneList;
+	if (sceneList.empty())
+	{
+		for (const SceneEntry& entry : SceneRegistry::GetSortedList())
+		{
+			sceneList.push_back(entry.Name);
+		}
+	}
+
+	bool bSuccess = true;
+	for (const std::string& name : sceneList)
+	{
+		if (!RunScene(name))
+		{
+			bSuccess = false;
+		}
+	}
+
+	ProgramCache::PrintStats();
+	MeshCache::PrintStats();
+
+	return WriteJson(Param.OutPath) && bSuccess;
+}
+
+bool Benchmark::RunScene(const std::string& name)
+{
+	SceneBase* scene = SceneRegistry::Create(name);
+	if (!scene)
+	{
+		std::cout << "ERROR::BENCHMARK::Unknown scene: " << name << std::endl;
+		return false;
+	}
+
+	// 每个场景使用独立上下文, 避免前一场景残留的GL状态及资源影响结果
+	RunParam param = ContextParam;
+	param.bHeadless = true;
+	param.FrameCount = Param.WarmupFrames + Param.MeasureFrames;
+
+	RenderContext* context = new RenderContext(Width, Height, param);
+	if (!context->Init())
+	{
+		delete scene;
+		delete context;
+		return false;
+	}
+
+	std::cout << "Benchmark scene: " << name << std::endl;
+
+	ShaderCompileQueue::Init(context);
+
+	Profiler& profiler = Profiler::Get();
+	profiler.Clear();
+
+	// 预计算等初始化开销单独作为一帧记录, 不计入滑动平均
+	profiler.bRecording = true;
+	profiler.BeginFrame();
+	scene->Context = context;
+	scene->Init();
+	profiler.EndFrame();
+	profiler.Flush();
+
+	SceneResult result;
+	result.InitFrame = profiler.FrameList.back();
+	profiler.FrameList.clear();
+	profiler.AverageList.clear();
+
+	CameraPath path;
+	if (Param.CameraPathFile.empty() || !path.Load(Param.CameraPathFile))
+	{
+		path = scene->BuildDefaultPath(Param.MeasureFrames * Param.TimeStep);
+	}
+
+	while (!context->ShouldClose())
+	{
+		// 预热帧停留在路径起点, 测量帧从0时刻开始按固定步长推进
+		int measureIndex = context->FrameIndex - Param.WarmupFrames;
+		float currentTime = measureIndex > 0 ? measureIndex * Param.TimeStep : 0.0f;
+		profiler.bRecording = measureIndex >= 0;
+
+		context->BeginFrame();
+
+		path.Apply(scene->CurCamera, currentTime);
+
+		profiler.BeginFrame();
+		scene->UpdateFrameUniforms();
+		scene->Render(currentTime);
+		profiler.EndFrame();
+
+		context->EndFrame();
+	}
+
+	// 取回最后几帧尚未返回的GPU结果
+	profiler.Flush();
+
+	result.Name = name;
+	result.Renderer = (const char*)glGetString(GL_RENDERER);
+	result.FrameMsList.assign(context->Stats.FrameTimeList.begin() + Param.WarmupFrames, context->Stats.FrameTimeList.end());
+	result.FrameList = profiler.FrameList;
+	ResultList.push_back(result);
+
+	FrameStats stats;
+	stats.FrameTimeList = result.FrameMsList;
+	stats.PrintSummary();
+	profiler.PrintAverages();
+
+	profiler.Clear();
+
+	// 场景资源随上下文销毁, arena中的缓冲同样按场景统计及释放
+	GeometryArena::PrintStats();
+	GeometryArena::Shutdown();
+	ShaderCompileQueue::Shutdown();
+
+	delete scene;
+	delete context;
+
+	return true;
+}
+
+bool Benchmark::WriteJson(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::BENCHMARK::Failed to write: " << path << std::endl;
+		return false;
+	}
+
+	file << "{" << std::endl;
+	file << "  \"width\": " << Width << "," << std::endl;
+	file << "  \"height\": " << Height << "," << std::endl;
+	file << "  \"warmup_frames\": " << Param.WarmupFrames << "," << std::endl;
+	file << "  \"measure_frames\": " << Param.MeasureFrames << "," << std::endl;
+	file << "  \"time_step\": " << Param.TimeStep << "," << std::endl;
+	file << "  \"camera_path\": \"" << EscapeJson(Param.CameraPathFile.empty() ? "default" : Param.CameraPathFile) << "\"," << std::endl;
+	file << "  \"scenes\": [" << std::endl;
+
+	for (size_t s = 0; s < ResultList.size(); s++)
+	{
+		const SceneResult& result = ResultList[s];
+
+		// 汇总整帧, CPU提交, GPU, DrawCall及剔除数
+		FrameStats frameStats, cpuStats, gpuStats, drawStats, culledStats;
+		frameStats.FrameTimeList = result.FrameMsList;
+		for (const FrameSample& frame : result.FrameList)
+		{
+			cpuStats.AddFrame(frame.CpuMs);
+			if (frame.GpuMs >= 0.0)
+			{
+				gpuStats.AddFrame(frame.GpuMs);
+			}
+			drawStats.AddFrame(frame.DrawCalls);
+			culledStats.AddFrame(frame.Culled);
+		}
+
+#ifdef GL_INSTRUMENT
+		// 各类GL调用的每帧平均次数
+		double glCallList[GL_CALL_TYPE_COUNT] = {};
+		for (const FrameSample& frame : result.FrameList)
+		{
+			for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+			{
+				glCallList[i] += frame.GLCalls.Count[i] / (double)result.FrameList.size();
+			}
+		}
+#endif
+
+		// 按首次出现顺序收集Pass, 某帧缺失的Pass记为0
+		std::vector<std::string> passNameList;
+		for (const FrameSample& frame : result.FrameList)
+		{
+			for (const PassSample& pass : frame.PassList)
+			{
+				if (std::find(passNameList.begin(), passNameList.end(), pass.Name) == passNameList.end())
+				{
+					passNameList.push_back(pass.Name);
+				}
+			}
+		}
+
+		file << "    {" << std::endl;
+		file << "      \"name\": \"" << EscapeJson(result.Name) << "\"," << std::endl;
+		file << "      \"renderer\": \"" << EscapeJson(result.Renderer) << "\"," << std::endl;
+
+		file << "      \"summary\": {" << std::endl;
+		file << "        \"frame_ms\": "; WriteSummary(file, frameStats); file << "," << std::endl;
+		file << "        \"cpu_ms\": "; WriteSummary(file, cpuStats); file << "," << std::endl;
+		file << "        \"gpu_ms\": "; WriteSummary(file, gpuStats); file << "," << std::endl;
+		file << "        \"draw_calls\": "; WriteSummary(file, drawStats); file << "," << std::endl;
+		file << "        \"culled\": "; WriteSummary(file, culledStats);
+#ifdef GL_INSTRUMENT
+		file << "," << std::endl;
+		file << "        \"gl\": "; WriteGLCalls(file, glCallList);
+#endif
+		file << std::endl;
+		file << "      }," << std::endl;
+
+		file << "      \"init\": ";
+		file << "{ "; WriteFrameFields(file, result.InitFrame); file << " }";
+		file << "," << std::endl;
+
+		file << "      \"passes\": [" << std::endl;
+		for (size_t p = 0; p < passNameList.size(); p++)
+		{
+			FrameStats passCpuStats, passGpuStats, passDrawStats, passCulledStats;
+#ifdef GL_INSTRUMENT
+			double passGLCallList[GL_CALL_TYPE_COUNT] = {};
+#endif
+			for (const FrameSample& frame : result.FrameList)
+			{
+				double cpuMs = 0.0;
+				double gpuMs = frame.GpuMs >= 0.0 ? 0.0 : -1.0;
+				int drawCalls = 0;
+				int culled = 0;
+				for (const PassSample& pass : frame.PassList)
+				{
+					if (pass.Name == passNameList[p])
+					{
+						cpuMs = pass.CpuMs;
+						gpuMs = pass.GpuMs;
+						drawCalls = pass.DrawCalls;
+						culled = pass.Culled;
+#ifdef GL_INSTRUMENT
+						for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+						{
+							passGLCallList[i] += pass.GLCalls.Count[i] / (double)result.FrameList.size();
+						}
+#endif
+					}
+				}
+				passCpuStats.AddFrame(cpuMs);
+				if (gpuMs >= 0.0)
+				{
+					passGpuStats.AddFrame(gpuMs);
+				}
+				passDrawStats.AddFrame(drawCalls);
+				passCulledStats.AddFrame(culled);
+			}
+
+			file << "        { \"name\": \"" << EscapeJson(passNameList[p]) << "\", \"cpu_ms\": ";
+			WriteSummary(file, passCpuStats);
+			file << ", \"gpu_ms\": ";
+			WriteSummary(file, passGpuStats);
+			file << ", \"draw_calls\": ";
+			WriteSummary(file, passDrawStats);
+			file << ", \"culled\": ";
+			WriteSummary(file, passCulledStats);
+#ifdef GL_INSTRUMENT
+			file << ", \"gl\": ";
+			WriteGLCalls(file, passGLCallList);
+#endif
+			file << " }" << (p + 1 < passNameList.size() ? "," : "") << std::endl;
+		}
+		file << "      ]," << std::endl;
+
+		file << "      \"frames\": [" << std::endl;
+		for (size_t f = 0; f < result.FrameList.size(); f++)
+		{
+			double frameMs = f < result.FrameMsList.size() ? result.FrameMsList[f] : 0.0;
+
+			file << "        { \"frame_ms\": " << frameMs << ", ";
+			WriteFrameFields(file, result.FrameList[f]);
+			file << " }" << (f + 1 < result.FrameList.size() ? "," : "") << std::endl;
+		}
+		file << "      ]" << std::endl;
+
+		file << "    }" << (s + 1 < ResultList.size() ? "," : "") << std::endl;
+	}
+
+	file << "  ]" << std::endl;
+	file << "}" << std::endl;
+
+	std::cout << "Benchmark result written to " << path << std::endl;
+	return true;
+}
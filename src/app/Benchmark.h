@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+#include "RenderContext.h"
+#include "Profiler.h"
+
+// 基准测试参数
+struct BenchParam {
+	bool bEnabled = false;
+	bool bListScene = false;
+	std::vector<std::string> SceneList; // 为空表示全部场景
+	std::string OutPath = "benchmark.json";
+	std::string CameraPathFile; // 为空则使用各场景默认环绕路径
+	int WarmupFrames = 10;
+	int MeasureFrames = 300;
+	float TimeStep = 1.0f / 60.0f; // 固定时间步长, 场景动画与相机路径均按帧推进
+};
+
+// 单个场景的测试结果
+struct SceneResult {
+	std::string Name;
+	std::string Renderer;
+	std::vector<double> FrameMsList; // 含等待GPU完成的整帧耗时
+	std::vector<FrameSample> FrameList;
+	FrameSample InitFrame; // Init()中的预计算Pass
+};
+
+// 依次在独立上下文中运行已注册场景, 结果写入JSON
+class Benchmark
+{
+public:
+
+	BenchParam Param;
+
+	RunParam ContextParam;
+
+	GLuint Width;
+
+	GLuint Height;
+
+	std::vector<SceneResult> ResultList;
+
+public:
+
+	Benchmark(GLuint InWidth, GLuint InHeight, const RunParam& InContextParam, const BenchParam& InParam);
+
+	// 解析命令行: --bench all|A,B --out file --warmup N --camera-path file --list, --frames N为测量帧数
+	static BenchParam ParseArgs(int argc, char** argv);
+
+	static void PrintSceneList();
+
+	bool Run();
+
+	bool WriteJson(const std::string& path) const;
+
+private:
+
+	bool RunScene(const std::string& name);
+};
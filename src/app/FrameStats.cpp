@@ -0,0 +1,74 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "FrameStats.h"
+
+void FrameStats::AddFrame(double frameMs)
+{
+	FrameTimeList.push_back(frameMs);
+}
+
+void FrameStats::Clear()
+{
+	FrameTimeList.clear();
+}
+
+double FrameStats::Min() const
+{
+	if (FrameTimeList.empty())
+	{
+		return 0.0;
+	}
+	return *std::min_element(FrameTimeList.begin(), FrameTimeList.end());
+}
+
+double FrameStats::Max() const
+{
+	if (FrameTimeList.empty())
+	{
+		return 0.0;
+	}
+	return *std::max_element(FrameTimeList.begin(), FrameTimeList.end());
+}
+
+double FrameStats::Average() const
+{
+	if (FrameTimeList.empty())
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (double frameMs : FrameTimeList)
+	{
+		total += frameMs;
+	}
+	return total / FrameTimeList.size();
+}
+
+double FrameStats::Percentile(double percent) const
+{
+	if (FrameTimeList.empty())
+	{
+		return 0.0;
+	}
+
+	// 最近秩法, 不修改原始数据顺序
+	std::vector<double> sorted = FrameTimeList;
+	std::sort(sorted.begin(), sorted.end());
+
+	size_t rank = (size_t)std::ceil(percent / 100.0 * sorted.size());
+	rank = std::min(std::max(rank, (size_t)1), sorted.size());
+	return sorted[rank - 1];
+}
+
+void FrameStats::PrintSummary() const
+{
+	std::cout << "Frames: " << FrameTimeList.size()
+		<< " | avg " << Average() << " ms"
+		<< " | min " << Min() << " ms"
+		<< " | median " << Percentile(50.0) << " ms"
+		<< " | p99 " << Percentile(99.0) << " ms"
+		<< " | max " << Max() << " ms" << std::endl;
+}
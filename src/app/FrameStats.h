@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include <vector>
+
+// 帧耗时统计, 单位毫秒
+class FrameStats
+{
+public:
+
+	std::vector<double> FrameTimeList;
+
+public:
+
+	void AddFrame(double frameMs);
+
+	void Clear();
+
+	double Min() const;
+
+	double Max() const;
+
+	double Average() const;
+
+	// percent取值[0, 100], 50即中位数
+	double Percentile(double percent) const;
+
+	void PrintSummary() const;
+};
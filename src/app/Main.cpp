@@ -0,0 +1,303 @@
+﻿#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "RenderContext.h"
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "../Scene/SceneBase.h"
+#include "../obj/CameraPath.h"
+#include "../render/MeshCache.h"
+#include "../render/ModelRender.h"
+#include "../render/ProgramCache.h"
+#include "../render/ShaderCompileQueue.h"
+#include "../buffer/GeometryArena.h"
+#include "../buffer/DrawBatch.h"
+#include "../render/OcclusionCuller.h"
+#include "../obj/MaskedOcclusion.h"
+#include "../tool/ThreadPool.h"
+
+
+// 常数定义
+const float SCR_WIDTH = 1920;
+const float SCR_HEIGHT = 1080;
+
+
+// 输入回调函数声明
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+void processInput(float deltaTime, GLFWwindow* window);
+
+// 全局变量
+RenderContext* Context;
+
+SceneBase* CurScene;
+
+int main(int argc, char** argv)
+{
+	RunParam runParam = RenderContext::ParseArgs(argc, argv);
+	BenchParam benchParam = Benchmark::ParseArgs(argc, argv);
+
+	// --scene NAME 交互运行的场景, --record-path FILE 退出时保存相机路径供基准测试回放, --no-shader-cache 关闭程序二进制缓存
+	// --no-mesh-cache 关闭模型网格缓存, --load-threads N 模型导入线程数, --vertex-format float|half|snorm16 模型顶点格式
+	// --shader-compile sync|parallel|worker 指定着色器编译方式, --no-indirect 模型绘制不使用glMultiDrawElementsIndirect
+	// --no-occlusion 关闭遮挡查询剔除, --no-soft-occlusion 关闭CPU遮挡剔除
+	std::string sceneName = "IBL";
+	std::string recordPathFile;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--scene" && i + 1 < argc)
+		{
+			sceneName = argv[++i];
+		}
+		else if (arg == "--record-path" && i + 1 < argc)
+		{
+			recordPathFile = argv[++i];
+		}
+		else if (arg == "--no-shader-cache")
+		{
+			ProgramCache::bEnabled = false;
+		}
+		else if (arg == "--no-mesh-cache")
+		{
+			MeshCache::bEnabled = false;
+		}
+		else if (arg == "--load-threads" && i + 1 < argc)
+		{
+			ThreadPool::ThreadCount = std::atoi(argv[++i]);
+		}
+		else if (arg == "--vertex-format" && i + 1 < argc)
+		{
+			std::string format = argv[++i];
+			if (format == "float")
+			{
+				ModelRender::VertexFormat = VERTEX_FORMAT_FLOAT;
+			}
+			else if (format == "half")
+			{
+				ModelRender::VertexFormat = VERTEX_FORMAT_HALF;
+			}
+			else if (format == "snorm16")
+			{
+				ModelRender::VertexFormat = VERTEX_FORMAT_SNORM16;
+			}
+		}
+		else if (arg == "--no-indirect")
+		{
+			DrawBatch::bAllowIndirect = false;
+		}
+		else if (arg == "--no-occlusion")
+		{
+			OcclusionCuller::bEnabled = false;
+		}
+		else if (arg == "--no-soft-occlusion")
+		{
+			MaskedOcclusion::bEnabled = false;
+		}
+		else if (arg == "--shader-compile" && i + 1 < argc)
+		{
+			std::string mode = argv[++i];
+			if (mode == "sync")
+			{
+				ShaderCompileQueue::PreferredMode = COMPILE_SYNC;
+			}
+			else if (mode == "parallel")
+			{
+				ShaderCompileQueue::PreferredMode = COMPILE_PARALLEL;
+			}
+			else if (mode == "worker")
+			{
+				ShaderCompileQueue::PreferredMode = COMPILE_WORKER;
+			}
+		}
+	}
+
+	if (benchParam.bListScene)
+	{
+		Benchmark::PrintSceneList();
+		return 0;
+	}
+
+	if (benchParam.bEnabled)
+	{
+		Benchmark bench(SCR_WIDTH, SCR_HEIGHT, runParam, benchParam);
+		return bench.Run() ? 0 : -1;
+	}
+
+
+	/*----------------------------------------------------
+		Part Init
+	----------------------------------------------------*/
+
+
+	CurScene = SceneRegistry::Create(sceneName);
+	if (!CurScene)
+	{
+		std::cout << "ERROR::SCENE::Unknown scene: " << sceneName << std::endl;
+		Benchmark::PrintSceneList();
+		return -1;
+	}
+
+	// 创建窗口或无头上下文, --headless --frames N
+	Context = new RenderContext(SCR_WIDTH, SCR_HEIGHT, runParam);
+	if (!Context->Init())
+	{
+		return -1;
+	}
+	ShaderCompileQueue::Init(Context);
+
+	// 初始化作为单独一帧计时, IBL等场景的预计算Pass在此统计
+	Profiler::Get().BeginFrame();
+	CurScene->Context = Context;
+	CurScene->Init();
+	Profiler::Get().EndFrame();
+	ProgramCache::PrintStats();
+	MeshCache::PrintStats();
+	GeometryArena::PrintStats();
+
+	if (!Context->IsHeadless())
+	{
+		glfwSetCursorPosCallback(Context->Window, mouse_callback); // 鼠标滑动回调
+		glfwSetScrollCallback(Context->Window, scroll_callback); // 鼠标滚轮回调
+		glfwSetMouseButtonCallback(Context->Window, mouse_button_callback); // 左键拾取
+	}
+
+	//glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	CameraPath recordPath;
+
+
+	/*----------------------------------------------------
+		Part Render Loop
+	----------------------------------------------------*/
+
+	float deltaTime = 0;
+	float lastFrame = static_cast<float>(Context->GetTime());
+
+	// 绘制循环
+	while (!Context->ShouldClose())
+	{
+		Context->BeginFrame();
+
+		float currentFrame = static_cast<float>(Context->GetTime());
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+
+		if (!Context->IsHeadless())
+		{
+			processInput(deltaTime, Context->Window);
+		}
+
+		if (!recordPathFile.empty())
+		{
+			recordPath.AddKey(currentFrame, CurScene->CurCamera);
+		}
+
+		Profiler::Get().BeginFrame();
+		CurScene->UpdateFrameUniforms();
+		CurScene->Render(currentFrame);
+		Profiler::Get().EndFrame();
+
+		Context->EndFrame();
+	}
+
+	// 退出程序
+	if (!recordPathFile.empty())
+	{
+		recordPath.Save(recordPathFile);
+	}
+
+	ShaderCompileQueue::Shutdown();
+	GeometryArena::Shutdown();
+
+	Context->Stats.PrintSummary();
+	Profiler::Get().Flush();
+	Profiler::Get().PrintAverages();
+	Context->Terminate();
+	return 0;
+}
+
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(float deltaTime, GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+		CurScene->CurCamera->ProcessKeyboard(EMoveDir::FORWARD, deltaTime);
+	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+		CurScene->CurCamera->ProcessKeyboard(EMoveDir::BACKWARD, deltaTime);
+	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+		CurScene->CurCamera->ProcessKeyboard(EMoveDir::LEFT, deltaTime);
+	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		CurScene->CurCamera->ProcessKeyboard(EMoveDir::RIGHT, deltaTime);
+}
+
+
+// glfw: whenever the mouse moves, this callback is called
+// -------------------------------------------------------
+bool firstMouse = true;
+float lastX = (float)SCR_WIDTH / 2.0;
+float lastY = (float)SCR_HEIGHT / 2.0;
+void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
+{
+	float xpos = static_cast<float>(xposIn);
+	float ypos = static_cast<float>(yposIn);
+
+	if (firstMouse)
+	{
+		lastX = xpos;
+		lastY = ypos;
+		firstMouse = false;
+	}
+
+	float xoffset = xpos - lastX;
+	float yoffset = lastY - ypos; // reversed since y-coordinates go from bottom to top
+
+	lastX = xpos;
+	lastY = ypos;
+
+	CurScene->CurCamera->ProcessMouseMovement(xoffset, yoffset);
+}
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+// ----------------------------------------------------------------------
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	CurScene->CurCamera->ProcessMouseScroll(static_cast<float>(yoffset));
+}
+
+// glfw: 左键按下时拾取光标处的场景物体
+// ----------------------------------------------------------------------
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+{
+	if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS)
+	{
+		return;
+	}
+
+	double xpos, ypos;
+	int width, height;
+	glfwGetCursorPos(window, &xpos, &ypos);
+	glfwGetWindowSize(window, &width, &height);
+	if (width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	RayHit hit;
+	if (CurScene->Pick((float)xpos, (float)ypos, (float)width, (float)height, hit))
+	{
+		std::cout << "Pick: object " << hit.Handle << ", distance " << hit.Distance << std::endl;
+	}
+	else
+	{
+		std::cout << "Pick: none" << std::endl;
+	}
+}
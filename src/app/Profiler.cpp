@@ -0,0 +1,419 @@
+﻿#include <chrono>
+#include <iostream>
+
+#include "Profiler.h"
+
+RollingAverage::RollingAverage(size_t InWindow)
+{
+	Window = InWindow > 0 ? InWindow : 1;
+}
+
+void RollingAverage::Add(double value)
+{
+	if (SampleList.size() < Window)
+	{
+		SampleList.push_back(value);
+	}
+	else
+	{
+		SampleList[Next] = value;
+	}
+	Next = (Next + 1) % Window;
+}
+
+double RollingAverage::Get() const
+{
+	if (SampleList.empty())
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (double value : SampleList)
+	{
+		total += value;
+	}
+	return total / SampleList.size();
+}
+
+size_t RollingAverage::GetCount() const
+{
+	return SampleList.size();
+}
+
+#ifdef GL_INSTRUMENT
+// total += end - begin, 计数器回绕时差值仍正确
+static void AddGLCalls(GLCallStats& total, const GLCallStats& begin, const GLCallStats& end)
+{
+	for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+	{
+		total.Count[i] += end.Count[i] - begin.Count[i];
+	}
+}
+#endif
+
+
+Profiler& Profiler::Get()
+{
+	static Profiler instance;
+	return instance;
+}
+
+void Profiler::BeginFrame()
+{
+	CurFrame = FrameSample();
+	PassStack.clear();
+	FrameStartTime = GetClockTime();
+#ifdef GL_INSTRUMENT
+	FrameStartGLCalls = glad_call_stats;
+#endif
+
+	CheckGpuTiming();
+	if (!bGpuTiming)
+	{
+		return;
+	}
+
+	// 先取回之前帧已就绪的结果, 回收其查询对象
+	ResolvePending(false);
+
+	if (FreeList.empty())
+	{
+		CurGpuFrame = new GpuFrame();
+	}
+	else
+	{
+		CurGpuFrame = FreeList.back();
+		FreeList.pop_back();
+	}
+	CurGpuFrame->UsedCount = 0;
+	CurGpuFrame->RangeList.clear();
+	CurGpuFrame->NameList.clear();
+	CurGpuFrame->FrameIndex = -1;
+
+	FrameBeginQuery = IssueTimestamp();
+}
+
+void Profiler::EndFrame()
+{
+	// 未正确闭合的Pass在帧末强制结束
+	while (!PassStack.empty())
+	{
+		EndPass();
+	}
+
+	CurFrame.CpuMs = (GetClockTime() - FrameStartTime) * 1000.0;
+#ifdef GL_INSTRUMENT
+	AddGLCalls(CurFrame.GLCalls, FrameStartGLCalls, glad_call_stats);
+#endif
+
+	if (CurGpuFrame)
+	{
+		GpuRange range;
+		range.PassIndex = -1;
+		range.BeginQuery = FrameBeginQuery;
+		range.EndQuery = IssueTimestamp();
+		CurGpuFrame->RangeList.push_back(range);
+
+		for (const PassSample& pass : CurFrame.PassList)
+		{
+			CurGpuFrame->NameList.push_back(pass.Name);
+		}
+		CurGpuFrame->FrameIndex = bRecording ? (int)FrameList.size() : -1;
+
+		PendingList.push_back(CurGpuFrame);
+		CurGpuFrame = nullptr;
+	}
+
+	FindAverage("Frame").CpuMs.Add(CurFrame.CpuMs);
+	FindAverage("Frame").DrawCalls.Add(CurFrame.DrawCalls);
+	FindAverage("Frame").Culled.Add(CurFrame.Culled);
+#ifdef GL_INSTRUMENT
+	for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+	{
+		FindAverage("Frame").GLCalls[i].Add(CurFrame.GLCalls.Count[i]);
+	}
+#endif
+	for (const PassSample& pass : CurFrame.PassList)
+	{
+		PassAverage& average = FindAverage(pass.Name);
+		average.CpuMs.Add(pass.CpuMs);
+		average.DrawCalls.Add(pass.DrawCalls);
+		average.Culled.Add(pass.Culled);
+#ifdef GL_INSTRUMENT
+		for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+		{
+			average.GLCalls[i].Add(pass.GLCalls.Count[i]);
+		}
+#endif
+	}
+
+	if (bRecording)
+	{
+		FrameList.push_back(CurFrame);
+	}
+}
+
+void Profiler::BeginPass(const std::string& name)
+{
+	size_t index = 0;
+	while (index < CurFrame.PassList.size() && CurFrame.PassList[index].Name != name)
+	{
+		index++;
+	}
+
+	if (index == CurFrame.PassList.size())
+	{
+		PassSample pass;
+		pass.Name = name;
+		CurFrame.PassList.push_back(pass);
+	}
+
+	OpenPass open;
+	open.Index = index;
+	open.StartTime = GetClockTime();
+	open.StartDrawCalls = CurFrame.DrawCalls;
+	open.StartCulled = CurFrame.Culled;
+	open.BeginQuery = CurGpuFrame ? IssueTimestamp() : 0;
+#ifdef GL_INSTRUMENT
+	open.StartGLCalls = glad_call_stats;
+#endif
+	PassStack.push_back(open);
+}
+
+void Profiler::EndPass()
+{
+	if (PassStack.empty())
+	{
+		return;
+	}
+
+	OpenPass open = PassStack.back();
+	PassStack.pop_back();
+
+	PassSample& pass = CurFrame.PassList[open.Index];
+	pass.CpuMs += (GetClockTime() - open.StartTime) * 1000.0;
+	pass.DrawCalls += CurFrame.DrawCalls - open.StartDrawCalls;
+	pass.Culled += CurFrame.Culled - open.StartCulled;
+#ifdef GL_INSTRUMENT
+	AddGLCalls(pass.GLCalls, open.StartGLCalls, glad_call_stats);
+#endif
+
+	if (CurGpuFrame && open.BeginQuery)
+	{
+		GpuRange range;
+		range.PassIndex = (int)open.Index;
+		range.BeginQuery = open.BeginQuery;
+		range.EndQuery = IssueTimestamp();
+		CurGpuFrame->RangeList.push_back(range);
+	}
+}
+
+void Profiler::AddDrawCall(int count)
+{
+	CurFrame.DrawCalls += count;
+}
+
+void Profiler::AddCulled(int count)
+{
+	CurFrame.Culled += count;
+}
+
+void Profiler::Flush()
+{
+	ResolvePending(true);
+}
+
+void Profiler::Clear()
+{
+	if (CurGpuFrame)
+	{
+		PendingList.push_back(CurGpuFrame);
+		CurGpuFrame = nullptr;
+	}
+	for (GpuFrame* gpuFrame : PendingList)
+	{
+		FreeList.push_back(gpuFrame);
+	}
+	PendingList.clear();
+
+	for (GpuFrame* gpuFrame : FreeList)
+	{
+		if (!gpuFrame->QueryList.empty())
+		{
+			glDeleteQueries((GLsizei)gpuFrame->QueryList.size(), gpuFrame->QueryList.data());
+		}
+		delete gpuFrame;
+	}
+	FreeList.clear();
+
+	// 下一个上下文重新检测
+	bGpuChecked = false;
+
+	CurFrame = FrameSample();
+	FrameList.clear();
+	AverageList.clear();
+	PassStack.clear();
+}
+
+const PassAverage* Profiler::GetAverage(const std::string& name) const
+{
+	for (const PassAverage& average : AverageList)
+	{
+		if (average.Name == name)
+		{
+			return &average;
+		}
+	}
+	return nullptr;
+}
+
+void Profiler::PrintAverages() const
+{
+	for (const PassAverage& average : AverageList)
+	{
+		std::cout << average.Name
+			<< " | cpu " << average.CpuMs.Get() << " ms";
+		if (average.GpuMs.GetCount() > 0)
+		{
+			std::cout << " | gpu " << average.GpuMs.Get() << " ms";
+		}
+		std::cout << " | draw " << average.DrawCalls.Get();
+		std::cout << " | culled " << average.Culled.Get();
+#ifdef GL_INSTRUMENT
+		std::cout << " | gl";
+		for (int i = 0; i < GL_CALL_TYPE_COUNT; i++)
+		{
+			std::cout << " " << glad_call_type_name[i] << " " << average.GLCalls[i].Get();
+		}
+#endif
+		std::cout << std::endl;
+	}
+}
+
+double Profiler::GetClockTime() const
+{
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::CheckGpuTiming()
+{
+	if (bGpuChecked)
+	{
+		return;
+	}
+	bGpuChecked = true;
+
+	// 计数位数为0表示驱动不支持时间戳查询
+	GLint bits = 0;
+	glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+	if (bits == 0)
+	{
+		std::cout << "ERROR::PROFILER::GL_TIMESTAMP not supported, GPU timing disabled" << std::endl;
+		bGpuTiming = false;
+	}
+}
+
+GLuint Profiler::IssueTimestamp()
+{
+	if (CurGpuFrame->UsedCount == CurGpuFrame->QueryList.size())
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+		CurGpuFrame->QueryList.push_back(query);
+	}
+
+	GLuint query = CurGpuFrame->QueryList[CurGpuFrame->UsedCount++];
+	glQueryCounter(query, GL_TIMESTAMP);
+	return query;
+}
+
+void Profiler::ResolvePending(bool bWait)
+{
+	while (!PendingList.empty())
+	{
+		GpuFrame* gpuFrame = PendingList.front();
+
+		// 查询按提交顺序完成, 最后一个时间戳就绪则整帧就绪
+		if (!bWait)
+		{
+			GLuint available = 0;
+			glGetQueryObjectuiv(gpuFrame->QueryList[gpuFrame->UsedCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+			{
+				break;
+			}
+		}
+
+		ResolveFrame(gpuFrame);
+
+		PendingList.pop_front();
+		FreeList.push_back(gpuFrame);
+	}
+}
+
+void Profiler::ResolveFrame(GpuFrame* gpuFrame)
+{
+	double frameGpuMs = 0.0;
+	std::vector<double> passGpuMs(gpuFrame->NameList.size(), 0.0);
+
+	for (const GpuRange& range : gpuFrame->RangeList)
+	{
+		GLuint64 beginTime = 0, endTime = 0;
+		glGetQueryObjectui64v(range.BeginQuery, GL_QUERY_RESULT, &beginTime);
+		glGetQueryObjectui64v(range.EndQuery, GL_QUERY_RESULT, &endTime);
+
+		double ms = endTime > beginTime ? (endTime - beginTime) / 1000000.0 : 0.0;
+		if (range.PassIndex < 0)
+		{
+			frameGpuMs = ms;
+		}
+		else
+		{
+			passGpuMs[range.PassIndex] += ms;
+		}
+	}
+
+	FindAverage("Frame").GpuMs.Add(frameGpuMs);
+	for (size_t i = 0; i < passGpuMs.size(); i++)
+	{
+		FindAverage(gpuFrame->NameList[i]).GpuMs.Add(passGpuMs[i]);
+	}
+
+	if (gpuFrame->FrameIndex >= 0 && gpuFrame->FrameIndex < (int)FrameList.size())
+	{
+		FrameSample& frame = FrameList[gpuFrame->FrameIndex];
+		frame.GpuMs = frameGpuMs;
+		for (size_t i = 0; i < passGpuMs.size() && i < frame.PassList.size(); i++)
+		{
+			frame.PassList[i].GpuMs = passGpuMs[i];
+		}
+	}
+}
+
+PassAverage& Profiler::FindAverage(const std::string& name)
+{
+	for (PassAverage& average : AverageList)
+	{
+		if (average.Name == name)
+		{
+			return average;
+		}
+	}
+
+	PassAverage average;
+	average.Name = name;
+	AverageList.push_back(average);
+	return AverageList.back();
+}
+
+ProfileScope::ProfileScope(const std::string& name)
+{
+	Profiler::Get().BeginPass(name);
+}
+
+ProfileScope::~ProfileScope()
+{
+	Profiler::Get().EndPass();
+}
@@ -0,0 +1,187 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../tool/GLInstrument.h"
+
+// 单个Pass在一帧内的统计, GpuMs在数帧后查询结果返回时回填, 未取得时为-1
+struct PassSample {
+	std::string Name;
+	double CpuMs = 0.0;
+	double GpuMs = -1.0;
+	int DrawCalls = 0;
+	int Culled = 0; // 可见性剔除掉的对象数
+#ifdef GL_INSTRUMENT
+	GLCallStats GLCalls = {}; // 按类别的GL调用次数
+#endif
+};
+
+// 一帧的统计, CpuMs为CPU提交耗时, 不含等待GPU
+struct FrameSample {
+	double CpuMs = 0.0;
+	double GpuMs = -1.0;
+	int DrawCalls = 0;
+	int Culled = 0;
+#ifdef GL_INSTRUMENT
+	GLCallStats GLCalls = {};
+#endif
+	std::vector<PassSample> PassList;
+};
+
+// 定长窗口滑动平均
+class RollingAverage
+{
+public:
+
+	RollingAverage(size_t InWindow = 60);
+
+	void Add(double value);
+
+	double Get() const;
+
+	size_t GetCount() const;
+
+private:
+
+	std::vector<double> SampleList;
+
+	size_t Window;
+
+	size_t Next = 0;
+};
+
+// 单个Pass的滑动平均, 名称为"Frame"的项对应整帧
+struct PassAverage {
+	std::string Name;
+	RollingAverage CpuMs;
+	RollingAverage GpuMs;
+	RollingAverage DrawCalls;
+	RollingAverage Culled;
+#ifdef GL_INSTRUMENT
+	RollingAverage GLCalls[GL_CALL_TYPE_COUNT];
+#endif
+};
+
+// 帧内Pass计时及DrawCall计数, 渲染器在每次提交绘制时调用AddDrawCall, 剔除对象时调用AddCulled
+// GPU耗时使用GL_TIMESTAMP查询, 在Pass首尾各写入一个时间戳(可嵌套), 查询对象循环复用,
+// 每帧开始时只读取已就绪的结果, 从不等待GPU
+class Profiler
+{
+public:
+
+	// 为false时只统计当前帧, 不写入FrameList(如预热帧)
+	bool bRecording = false;
+
+	// GPU计时可用且开启
+	bool bGpuTiming = true;
+
+	FrameSample CurFrame;
+
+	std::vector<FrameSample> FrameList;
+
+	std::vector<PassAverage> AverageList;
+
+public:
+
+	static Profiler& Get();
+
+	void BeginFrame();
+
+	void EndFrame();
+
+	// 同名Pass在一帧内多次出现时累加, 允许嵌套
+	void BeginPass(const std::string& name);
+
+	void EndPass();
+
+	void AddDrawCall(int count = 1);
+
+	void AddCulled(int count);
+
+	// 阻塞读取全部未返回的GPU结果, 仅在测量结束或预计算完成后调用
+	void Flush();
+
+	// 释放查询对象并清空数据, 需在所属GL上下文销毁前调用
+	void Clear();
+
+	// 名称不存在时返回nullptr
+	const PassAverage* GetAverage(const std::string& name) const;
+
+	void PrintAverages() const;
+
+private:
+
+	struct OpenPass {
+		size_t Index;
+		double StartTime;
+		int StartDrawCalls;
+		int StartCulled;
+#ifdef GL_INSTRUMENT
+		GLCallStats StartGLCalls;
+#endif
+		GLuint BeginQuery;
+	};
+
+	// 一个时间戳区间, PassIndex为-1表示整帧
+	struct GpuRange {
+		int PassIndex;
+		GLuint BeginQuery;
+		GLuint EndQuery;
+	};
+
+	// 一帧内发出的全部查询, 结果返回后回填FrameList[FrameIndex]
+	struct GpuFrame {
+		std::vector<GLuint> QueryList;
+		size_t UsedCount = 0;
+		std::vector<GpuRange> RangeList;
+		std::vector<std::string> NameList;
+		int FrameIndex = -1;
+	};
+
+	double FrameStartTime = 0.0;
+
+#ifdef GL_INSTRUMENT
+	GLCallStats FrameStartGLCalls = {};
+#endif
+
+	std::vector<OpenPass> PassStack;
+
+	bool bGpuChecked = false;
+
+	GpuFrame* CurGpuFrame = nullptr;
+
+	GLuint FrameBeginQuery = 0;
+
+	// 已提交待读取的帧, 按提交顺序排列
+	std::deque<GpuFrame*> PendingList;
+
+	std::vector<GpuFrame*> FreeList;
+
+private:
+
+	double GetClockTime() const;
+
+	void CheckGpuTiming();
+
+	GLuint IssueTimestamp();
+
+	// bWait为false时遇到未就绪的帧即停止
+	void ResolvePending(bool bWait);
+
+	void ResolveFrame(GpuFrame* gpuFrame);
+
+	PassAverage& FindAverage(const std::string& name);
+};
+
+// Pass作用域计时, 构造时开始, 析构时结束
+class ProfileScope
+{
+public:
+
+	ProfileScope(const std::string& name);
+
+	~ProfileScope();
+};
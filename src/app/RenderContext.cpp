@@ -0,0 +1,451 @@
+﻿#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+#include "RenderContext.h"
+#include "../buffer/TextureAllocator.h"
+#include "../render/GLStateCache.h"
+
+#ifdef SRGL_ENABLE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// 窗口改变回调
+static void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	GLStateCache::Viewport(0, 0, width, height);
+}
+
+RenderContext::RenderContext(GLuint InWidth, GLuint InHeight, const RunParam& InParam)
+{
+	Width = InWidth;
+	Height = InHeight;
+	Param = InParam;
+}
+
+RenderContext::~RenderContext()
+{
+	Terminate();
+}
+
+RunParam RenderContext::ParseArgs(int argc, char** argv)
+{
+	RunParam param;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--headless")
+		{
+			param.bHeadless = true;
+		}
+		else if (arg == "--frames" && i + 1 < argc)
+		{
+			param.FrameCount = std::atoi(argv[++i]);
+		}
+		else if (arg == "--backend" && i + 1 < argc)
+		{
+			std::string backend = argv[++i];
+			if (backend == "glfw")
+			{
+				param.Backend = BACKEND_GLFW;
+			}
+			else if (backend == "egl")
+			{
+				param.Backend = BACKEND_EGL;
+			}
+		}
+	}
+
+	// 无头模式必须有确定的帧数, 否则无法退出
+	if (param.bHeadless && param.FrameCount <= 0)
+	{
+		param.FrameCount = 100;
+	}
+
+	return param;
+}
+
+bool RenderContext::Init()
+{
+	bool bSuccess = false;
+
+	EContextBackend backend = Param.Backend;
+	if (backend == BACKEND_AUTO)
+	{
+#ifdef SRGL_ENABLE_EGL
+		backend = Param.bHeadless ? BACKEND_EGL : BACKEND_GLFW;
+#else
+		backend = BACKEND_GLFW;
+#endif
+	}
+
+	if (backend == BACKEND_EGL)
+	{
+		bSuccess = InitEGL();
+	}
+	else
+	{
+		bSuccess = InitGLFW(!Param.bHeadless);
+	}
+
+	if (!bSuccess)
+	{
+		return false;
+	}
+
+	// 新上下文的状态与之前上下文的记录无关
+	GLStateCache::Reset();
+
+	std::cout << "GL_RENDERER: " << glGetString(GL_RENDERER) << std::endl;
+	std::cout << "GL_VERSION: " << glGetString(GL_VERSION) << std::endl;
+
+	if (IsHeadless())
+	{
+		CreateOffscreenFrame();
+	}
+
+	StartTime = GetClockTime();
+	FrameStartTime = StartTime;
+
+	return true;
+}
+
+bool RenderContext::InitGLFW(bool bVisible)
+{
+	glfwInit();
+
+	// 设置OpenGL支持版本
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+
+	// 使用OpenGL核心模式
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	// 无头模式下使用隐藏窗口承载上下文
+	glfwWindowHint(GLFW_VISIBLE, bVisible ? GLFW_TRUE : GLFW_FALSE);
+
+	Window = glfwCreateWindow(Width, Height, "SoftRendererGL", NULL, NULL);
+	if (Window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return false;
+	}
+	glfwMakeContextCurrent(Window);
+
+	// 设置窗口大小变化时的回调
+	glfwSetFramebufferSizeCallback(Window, framebuffer_size_callback);
+
+	// 初始化glad
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cout << "Failed to initialize GLAD" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool RenderContext::InitEGL()
+{
+#ifdef SRGL_ENABLE_EGL
+	EGLDisplay display = EGL_NO_DISPLAY;
+
+	// 优先使用Mesa的surfaceless平台, 完全不依赖显示服务
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+	{
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+	{
+		std::cout << "ERROR::EGL::Failed to initialize display" << std::endl;
+		return false;
+	}
+
+	eglBindAPI(EGL_OPENGL_API);
+
+	EGLint configAttri[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_NONE
+	};
+	EGLConfig config = nullptr;
+	EGLint configNum = 0;
+	eglChooseConfig(display, configAttri, &config, 1, &configNum);
+
+	// 依次尝试4.5及3.3核心模式
+	const EGLint versionList[][2] = { { 4, 5 }, { 3, 3 } };
+	EGLContext context = EGL_NO_CONTEXT;
+	for (int i = 0; i < 2 && context == EGL_NO_CONTEXT; i++)
+	{
+		EGLint contextAttri[] = {
+			EGL_CONTEXT_MAJOR_VERSION, versionList[i][0],
+			EGL_CONTEXT_MINOR_VERSION, versionList[i][1],
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, configNum > 0 ? config : (EGLConfig)0, EGL_NO_CONTEXT, contextAttri);
+		GLMajor = versionList[i][0];
+		GLMinor = versionList[i][1];
+	}
+
+	if (context == EGL_NO_CONTEXT)
+	{
+		std::cout << "ERROR::EGL::Failed to create context" << std::endl;
+		return false;
+	}
+
+	// 支持surfaceless时不创建任何surface, 否则退化为pbuffer
+	EGLSurface surface = EGL_NO_SURFACE;
+	const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+	if (!extensions || !std::strstr(extensions, "EGL_KHR_surfaceless_context"))
+	{
+		EGLint pbufferAttri[] = { EGL_WIDTH, (EGLint)Width, EGL_HEIGHT, (EGLint)Height, EGL_NONE };
+		surface = eglCreatePbufferSurface(display, config, pbufferAttri);
+	}
+
+	if (!eglMakeCurrent(display, surface, surface, context))
+	{
+		std::cout << "ERROR::EGL::Failed to make context current" << std::endl;
+		return false;
+	}
+
+	EGLDisplayHandle = display;
+	EGLContextHandle = context;
+	EGLSurfaceHandle = surface;
+	EGLConfigHandle = configNum > 0 ? config : nullptr;
+
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+	{
+		std::cout << "Failed to initialize GLAD" << std::endl;
+		return false;
+	}
+
+	return true;
+#else
+	std::cout << "ERROR::EGL::EGL backend is not available on this platform" << std::endl;
+	return false;
+#endif
+}
+
+void RenderContext::CreateOffscreenFrame()
+{
+	FrameParam frameParam;
+	frameParam.RBOFormat = GL_DEPTH24_STENCIL8;
+	frameParam.RBOType = GL_DEPTH_STENCIL_ATTACHMENT;
+	OffscreenFrame = new FrameObj(Width, Height, &frameParam);
+
+	TexParam texParam;
+	texParam.precision = GL_RGBA8;
+	texParam.channel = GL_RGBA;
+	texParam.wrapMode = GL_CLAMP_TO_EDGE;
+	texParam.mipMode = GL_LINEAR;
+	texParam.bMipmap = false;
+
+	TextureAllocator allocator;
+	OffscreenTex = allocator.GenTex(Width, Height, nullptr, &texParam);
+	OffscreenFrame->BindTexAttached(OffscreenTex);
+}
+
+bool RenderContext::IsHeadless() const
+{
+	return Param.bHeadless;
+}
+
+bool RenderContext::ShouldClose()
+{
+	if (Param.FrameCount > 0 && FrameIndex >= Param.FrameCount)
+	{
+		return true;
+	}
+
+	return Window && glfwWindowShouldClose(Window);
+}
+
+void RenderContext::BeginFrame()
+{
+	// 首帧前等待场景初始化阶段提交的预计算完成, 不计入帧耗时
+	if (IsHeadless() && FrameIndex == 0)
+	{
+		glFinish();
+	}
+
+	FrameStartTime = GetClockTime();
+}
+
+void RenderContext::EndFrame()
+{
+	if (IsHeadless())
+	{
+		// 无头模式没有SwapBuffers的节流, 等待GPU完成才能得到真实帧耗时
+		glFinish();
+	}
+	else
+	{
+		glfwSwapBuffers(Window);
+	}
+
+	if (Window)
+	{
+		glfwPollEvents();
+	}
+
+	Stats.AddFrame((GetClockTime() - FrameStartTime) * 1000.0);
+	FrameIndex++;
+}
+
+GLuint RenderContext::GetScreenFBO() const
+{
+	return OffscreenFrame ? OffscreenFrame->FBO : 0;
+}
+
+double RenderContext::GetTime() const
+{
+	return GetClockTime() - StartTime;
+}
+
+double RenderContext::GetClockTime() const
+{
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RenderContext::Terminate()
+{
+	if (Window)
+	{
+		glfwTerminate();
+		Window = nullptr;
+	}
+
+#ifdef SRGL_ENABLE_EGL
+	if (EGLDisplayHandle)
+	{
+		eglMakeCurrent(EGLDisplayHandle, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (EGLSurfaceHandle != EGL_NO_SURFACE)
+		{
+			eglDestroySurface(EGLDisplayHandle, EGLSurfaceHandle);
+		}
+		eglDestroyContext(EGLDisplayHandle, EGLContextHandle);
+		eglTerminate(EGLDisplayHandle);
+		EGLDisplayHandle = nullptr;
+	}
+#endif
+}
+
+SharedContext* RenderContext::CreateSharedContext()
+{
+	if (Window)
+	{
+		// 隐藏的1x1窗口, 版本及模式沿用InitGLFW中设置的hint
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		GLFWwindow* window = glfwCreateWindow(1, 1, "SharedContext", NULL, Window);
+		if (window == NULL)
+		{
+			std::cout << "ERROR::CONTEXT::Failed to create shared GLFW context" << std::endl;
+			return nullptr;
+		}
+
+		SharedContext* shared = new SharedContext();
+		shared->Window = window;
+		return shared;
+	}
+
+#ifdef SRGL_ENABLE_EGL
+	if (EGLDisplayHandle)
+	{
+		EGLint contextAttri[] = {
+			EGL_CONTEXT_MAJOR_VERSION, GLMajor,
+			EGL_CONTEXT_MINOR_VERSION, GLMinor,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		EGLContext context = eglCreateContext(EGLDisplayHandle, (EGLConfig)EGLConfigHandle, (EGLContext)EGLContextHandle, contextAttri);
+		if (context == EGL_NO_CONTEXT)
+		{
+			std::cout << "ERROR::EGL::Failed to create shared context" << std::endl;
+			return nullptr;
+		}
+
+		// 主上下文使用pbuffer时, 共享上下文同样需要一个surface
+		EGLSurface surface = EGL_NO_SURFACE;
+		if (EGLSurfaceHandle != EGL_NO_SURFACE)
+		{
+			EGLint pbufferAttri[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+			surface = eglCreatePbufferSurface(EGLDisplayHandle, (EGLConfig)EGLConfigHandle, pbufferAttri);
+		}
+
+		SharedContext* shared = new SharedContext();
+		shared->EGLContextHandle = context;
+		shared->EGLSurfaceHandle = surface;
+		return shared;
+	}
+#endif
+
+	return nullptr;
+}
+
+bool RenderContext::MakeCurrent(SharedContext* shared)
+{
+	if (Window)
+	{
+		glfwMakeContextCurrent(shared ? shared->Window : NULL);
+		return true;
+	}
+
+#ifdef SRGL_ENABLE_EGL
+	if (EGLDisplayHandle)
+	{
+		if (!shared)
+		{
+			return eglMakeCurrent(EGLDisplayHandle, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		}
+
+		// 绑定的API是线程局部状态, 新线程默认为GLES
+		eglBindAPI(EGL_OPENGL_API);
+		return eglMakeCurrent(EGLDisplayHandle, shared->EGLSurfaceHandle, shared->EGLSurfaceHandle, shared->EGLContextHandle);
+	}
+#endif
+
+	return false;
+}
+
+void RenderContext::DestroySharedContext(SharedContext* shared)
+{
+	if (!shared)
+	{
+		return;
+	}
+
+	if (shared->Window)
+	{
+		glfwDestroyWindow(shared->Window);
+	}
+
+#ifdef SRGL_ENABLE_EGL
+	if (EGLDisplayHandle && shared->EGLContextHandle)
+	{
+		if (shared->EGLSurfaceHandle != EGL_NO_SURFACE)
+		{
+			eglDestroySurface(EGLDisplayHandle, shared->EGLSurfaceHandle);
+		}
+		eglDestroyContext(EGLDisplayHandle, shared->EGLContextHandle);
+	}
+#endif
+
+	delete shared;
+}
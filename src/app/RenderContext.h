@@ -0,0 +1,121 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <string>
+
+#include "FrameStats.h"
+#include "../buffer/FrameObj.h"
+
+// Linux下默认启用EGL无窗口后端, Windows下无头模式退化为隐藏窗口
+#if defined(__linux__) && !defined(SRGL_DISABLE_EGL)
+#define SRGL_ENABLE_EGL 1
+#endif
+
+enum EContextBackend {
+	BACKEND_AUTO,
+	BACKEND_GLFW,
+	BACKEND_EGL
+};
+
+// 与主上下文共享对象的上下文, 供后台线程使用
+struct SharedContext {
+	GLFWwindow* Window = nullptr;
+	void* EGLContextHandle = nullptr;
+	void* EGLSurfaceHandle = nullptr;
+};
+
+// 启动参数
+struct RunParam {
+	bool bHeadless = false;
+	EContextBackend Backend = BACKEND_AUTO;
+	int FrameCount = 0; // 0表示不限帧数, 窗口模式下直到关闭窗口
+};
+
+class RenderContext
+{
+public:
+
+	GLuint Width;
+
+	GLuint Height;
+
+	RunParam Param;
+
+	GLFWwindow* Window = nullptr;
+
+	// 无头模式下代替默认帧缓冲的离屏目标
+	FrameObj* OffscreenFrame = nullptr;
+
+	GLuint OffscreenTex = 0;
+
+	int FrameIndex = 0;
+
+	FrameStats Stats;
+
+public:
+
+	RenderContext(GLuint InWidth, GLuint InHeight, const RunParam& InParam);
+
+	~RenderContext();
+
+	// 解析命令行: --headless --frames N --backend glfw|egl
+	static RunParam ParseArgs(int argc, char** argv);
+
+	// 创建上下文并初始化glad, 失败返回false
+	bool Init();
+
+	bool IsHeadless() const;
+
+	bool ShouldClose();
+
+	void BeginFrame();
+
+	void EndFrame();
+
+	// 场景中原先绑定0号帧缓冲的地方统一改为绑定该FBO
+	GLuint GetScreenFBO() const;
+
+	// 上下文创建以来经过的秒数
+	double GetTime() const;
+
+	void Terminate();
+
+	// 须在主线程创建及销毁, 失败返回nullptr
+	SharedContext* CreateSharedContext();
+
+	// 可在任意线程调用, 传入nullptr时解除当前线程绑定的上下文
+	bool MakeCurrent(SharedContext* shared);
+
+	void DestroySharedContext(SharedContext* shared);
+
+private:
+
+	double StartTime = 0.0;
+
+	double FrameStartTime = 0.0;
+
+	void* EGLDisplayHandle = nullptr;
+
+	void* EGLContextHandle = nullptr;
+
+	void* EGLSurfaceHandle = nullptr;
+
+	void* EGLConfigHandle = nullptr;
+
+	// 实际创建的上下文版本, 共享上下文与之保持一致
+	int GLMajor = 3;
+
+	int GLMinor = 3;
+
+private:
+
+	bool InitGLFW(bool bVisible);
+
+	bool InitEGL();
+
+	void CreateOffscreenFrame();
+
+	double GetClockTime() const;
+};
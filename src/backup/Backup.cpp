@@ -342,7 +342,7 @@
 //
 //
 //// 屏幕纹理渲染缓冲数据
-//Shader* RTShader = new Shader("shader/PostProcess/Primitive.vs", "shader/PostProcess/Primitive.fs");
+//Shader* RTShader = new Shader("shader/PostProcess/ScreenQuad.vs", "shader/PostProcess/Primitive.fs");
 //RTShader->Use();
 //RTShader->SetInt("RT", 0);
 //
@@ -0,0 +1,146 @@
+﻿#include "DrawBatch.h"
+
+bool DrawBatch::bAllowIndirect = true;
+
+DrawBatch::DrawBatch()
+{
+}
+
+DrawBatch::~DrawBatch()
+{
+	if (IndirectBuffer != 0)
+	{
+		glDeleteBuffers(1, &IndirectBuffer);
+	}
+}
+
+bool DrawBatch::Add(const GeometryRange& range)
+{
+	if (!GeometryArena::IsValid(range) || range.IndexCount == 0)
+	{
+		return false;
+	}
+
+	if (!RangeList.empty() && (range.Pool != First.Pool || range.IndexType != First.IndexType))
+	{
+		return false;
+	}
+
+	if (RangeList.empty())
+	{
+		First = range;
+	}
+	RangeList.push_back(range);
+	return true;
+}
+
+int DrawBatch::GetCount() const
+{
+	return (int)RangeList.size();
+}
+
+const GeometryRange& DrawBatch::GetGeometry() const
+{
+	return First;
+}
+
+void DrawBatch::Build()
+{
+	// 索引缓冲以4字节为单位分配, 换算为该索引类型下的首个索引
+	size_t indexSize = First.IndexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+
+	CommandList.clear();
+	CountList.clear();
+	OffsetList.clear();
+	BaseVertexList.clear();
+	for (const GeometryRange& range : RangeList)
+	{
+		size_t byteOffset = (size_t)range.IndexOffset * sizeof(unsigned int);
+
+		DrawElementsIndirectCommand command;
+		command.Count = range.IndexCount;
+		command.InstanceCount = 1;
+		command.FirstIndex = (GLuint)(byteOffset / indexSize);
+		command.BaseVertex = (GLint)range.VertexOffset;
+		command.BaseInstance = 0;
+		CommandList.push_back(command);
+
+		CountList.push_back((GLsizei)range.IndexCount);
+		OffsetList.push_back((const void*)byteOffset);
+		BaseVertexList.push_back((GLint)range.VertexOffset);
+	}
+
+	if (UseIndirect() && !CommandList.empty())
+	{
+		if (IndirectBuffer == 0)
+		{
+			glGenBuffers(1, &IndirectBuffer);
+		}
+		UploadCommands(1);
+	}
+}
+
+int DrawBatch::Draw(GLenum mode)
+{
+	if (RangeList.empty() || !GeometryArena::Bind(First))
+	{
+		return 0;
+	}
+
+	if (UseIndirect() && IndirectBuffer != 0)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBuffer);
+		if (UploadedInstanceCount != 1)
+		{
+			UploadCommands(1);
+		}
+		glMultiDrawElementsIndirect(mode, First.IndexType, nullptr, (GLsizei)CommandList.size(), 0);
+	}
+	else
+	{
+		glMultiDrawElementsBaseVertex(mode, CountList.data(), First.IndexType, OffsetList.data(), (GLsizei)CountList.size(), BaseVertexList.data());
+	}
+	return 1;
+}
+
+int DrawBatch::DrawInstanced(GLenum mode, const InstanceBuffer* instances)
+{
+	if (RangeList.empty() || instances->GetCount() == 0 || !GeometryArena::Bind(First, instances))
+	{
+		return 0;
+	}
+
+	if (UseIndirect() && IndirectBuffer != 0)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBuffer);
+		if (UploadedInstanceCount != (GLuint)instances->GetCount())
+		{
+			UploadCommands((GLuint)instances->GetCount());
+		}
+		glMultiDrawElementsIndirect(mode, First.IndexType, nullptr, (GLsizei)CommandList.size(), 0);
+		return 1;
+	}
+
+	for (size_t i = 0; i < CountList.size(); i++)
+	{
+		glDrawElementsInstancedBaseVertex(mode, CountList[i], First.IndexType, OffsetList[i], instances->GetCount(), BaseVertexList[i]);
+	}
+	return (int)CountList.size();
+}
+
+bool DrawBatch::UseIndirect() const
+{
+	return bAllowIndirect && GLAD_GL_ARB_multi_draw_indirect;
+}
+
+void DrawBatch::UploadCommands(GLuint instanceCount)
+{
+	for (DrawElementsIndirectCommand& command : CommandList)
+	{
+		command.InstanceCount = instanceCount;
+	}
+	UploadedInstanceCount = instanceCount;
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, CommandList.size() * sizeof(DrawElementsIndirectCommand), CommandList.data(), GL_DYNAMIC_DRAW);
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+
+#include "GeometryArena.h"
+#include "InstanceBuffer.h"
+
+// 与glMultiDrawElementsIndirect约定的命令格式, 字段顺序不可改变
+struct DrawElementsIndirectCommand {
+	GLuint Count;
+	GLuint InstanceCount;
+	GLuint FirstIndex; // 以索引计, 非字节
+	GLint BaseVertex;
+	GLuint BaseInstance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 5 * sizeof(GLuint), "DrawElementsIndirectCommand must be tightly packed");
+
+// 同一GeometryPool且同一索引类型的多个区间合并为一次提交
+// 支持GL_ARB_multi_draw_indirect时命令写入GL_DRAW_INDIRECT_BUFFER, 以glMultiDrawElementsIndirect绘制
+// 否则退回GL 3.3的glMultiDrawElementsBaseVertex, 两者均为一次驱动调用
+class DrawBatch
+{
+public:
+
+	// --no-indirect 关闭间接绘制, 始终使用glMultiDrawElementsBaseVertex
+	static bool bAllowIndirect;
+
+public:
+
+	DrawBatch();
+
+	~DrawBatch();
+
+	DrawBatch(const DrawBatch&) = delete;
+
+	DrawBatch& operator=(const DrawBatch&) = delete;
+
+	// 布局或索引类型与已加入的区间不同, 或区间无索引时返回false
+	bool Add(const GeometryRange& range);
+
+	int GetCount() const;
+
+	// 首个加入的区间, 用于取得布局及VAO
+	const GeometryRange& GetGeometry() const;
+
+	// 加入全部区间后调用, 写入间接命令缓冲
+	void Build();
+
+	// 返回提交的绘制调用数
+	int Draw(GLenum mode);
+
+	// 全部区间各绘制instances中的全部实例; 退回路径无多绘制的实例化版本, 逐区间提交
+	int DrawInstanced(GLenum mode, const InstanceBuffer* instances);
+
+private:
+
+	GeometryRange First;
+
+	std::vector<GeometryRange> RangeList;
+
+	std::vector<DrawElementsIndirectCommand> CommandList;
+
+	GLuint IndirectBuffer = 0;
+
+	// 间接缓冲中命令的InstanceCount, 实例数改变时重写
+	GLuint UploadedInstanceCount = 1;
+
+	// glMultiDrawElementsBaseVertex的参数
+	std::vector<GLsizei> CountList;
+
+	std::vector<const void*> OffsetList;
+
+	std::vector<GLint> BaseVertexList;
+
+private:
+
+	bool UseIndirect() const;
+
+	void UploadCommands(GLuint instanceCount);
+};
@@ -1,22 +1,23 @@
 ﻿#include "FrameObj.h"
+#include "../render/GLStateCache.h"
 
 FrameObj::FrameObj(GLuint width, GLuint height, FrameParam* frameParam)
 {
 	glGenFramebuffers(1, &FBO);
 	glGenRenderbuffers(1, &RBO);
 
-	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, FBO);
 	glBindRenderbuffer(GL_RENDERBUFFER, RBO);
 
 	glRenderbufferStorage(GL_RENDERBUFFER, frameParam->RBOFormat, width, height);
 	glFramebufferRenderbuffer(GL_FRAMEBUFFER, frameParam->RBOType, GL_RENDERBUFFER, RBO);
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FrameObj::BindTexAttached(GLuint InTex, GLuint mipLevel)
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, FBO);
 
 
 	TexAttachList.push_back(InTex);
@@ -25,5 +26,5 @@ void FrameObj::BindTexAttached(GLuint InTex, GLuint mipLevel)
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + CurIndex, GL_TEXTURE_2D, InTex, mipLevel);
 
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -0,0 +1,407 @@
+﻿#include <iostream>
+
+#include "GeometryArena.h"
+#include "../render/GLStateCache.h"
+
+unsigned int RangeAllocator::Allocate(unsigned int size)
+{
+	// 最佳适配, 剩余部分仍作为空闲区间
+	auto it = FreeBySize.lower_bound(size);
+	if (it == FreeBySize.end())
+	{
+		return INVALID_OFFSET;
+	}
+
+	unsigned int offset = it->second;
+	unsigned int freeSize = it->first;
+	EraseFree(FreeByOffset.find(offset));
+
+	if (freeSize > size)
+	{
+		InsertFree(offset + size, freeSize - size);
+	}
+	Used += size;
+	return offset;
+}
+
+void RangeAllocator::Free(unsigned int offset, unsigned int size)
+{
+	Used -= size;
+
+	// 与后一空闲区间合并
+	auto next = FreeByOffset.find(offset + size);
+	if (next != FreeByOffset.end())
+	{
+		size += next->second;
+		EraseFree(next);
+	}
+
+	// 与前一空闲区间合并
+	auto prev = FreeByOffset.lower_bound(offset);
+	if (prev != FreeByOffset.begin())
+	{
+		--prev;
+		if (prev->first + prev->second == offset)
+		{
+			offset = prev->first;
+			size += prev->second;
+			EraseFree(prev);
+		}
+	}
+
+	InsertFree(offset, size);
+}
+
+void RangeAllocator::Grow(unsigned int newCapacity)
+{
+	if (newCapacity <= Capacity)
+	{
+		return;
+	}
+
+	unsigned int oldCapacity = Capacity;
+	Capacity = newCapacity;
+
+	// 借用Free合并尾部空闲区间, Used不变
+	Used += newCapacity - oldCapacity;
+	Free(oldCapacity, newCapacity - oldCapacity);
+}
+
+unsigned int RangeAllocator::GetCapacity() const
+{
+	return Capacity;
+}
+
+unsigned int RangeAllocator::GetUsed() const
+{
+	return Used;
+}
+
+void RangeAllocator::InsertFree(unsigned int offset, unsigned int size)
+{
+	FreeByOffset[offset] = size;
+	FreeBySize.insert(std::make_pair(size, offset));
+}
+
+void RangeAllocator::EraseFree(std::map<unsigned int, unsigned int>::iterator it)
+{
+	auto range = FreeBySize.equal_range(it->second);
+	for (auto sizeIt = range.first; sizeIt != range.second; ++sizeIt)
+	{
+		if (sizeIt->second == it->first)
+		{
+			FreeBySize.erase(sizeIt);
+			break;
+		}
+	}
+	FreeByOffset.erase(it);
+}
+
+
+// 6.5万个Vertex约2MB, 100万个索引4MB
+unsigned int GeometryArena::InitialVertexCapacity = 65536;
+unsigned int GeometryArena::InitialIndexCapacity = 1 << 20;
+
+unsigned int GeometryArena::Generation = 1;
+GeometryBuffer GeometryArena::Indices;
+std::map<std::type_index, GeometryPool*> GeometryArena::PoolMap;
+unsigned int GeometryArena::AllocCount = 0;
+unsigned int GeometryArena::FreeCount = 0;
+unsigned int GeometryArena::GrowCount = 0;
+
+// 单个缓冲上限, 避免容量翻倍时溢出
+static const size_t MAX_BUFFER_BYTES = (size_t)1 << 30;
+
+void GeometryArena::Shutdown()
+{
+	for (auto& entry : PoolMap)
+	{
+		GeometryPool* pool = entry.second;
+		GLStateCache::DeleteVertexArray(pool->VAO);
+		glDeleteBuffers(1, &pool->Vertices.ID);
+		delete pool;
+	}
+	PoolMap.clear();
+
+	if (Indices.ID != 0)
+	{
+		glDeleteBuffers(1, &Indices.ID);
+	}
+	Indices = GeometryBuffer();
+
+	Generation++;
+	AllocCount = FreeCount = GrowCount = 0;
+}
+
+void GeometryArena::Free(GeometryRange& range)
+{
+	if (!IsValid(range))
+	{
+		range = GeometryRange();
+		return;
+	}
+
+	if (range.VertexCount > 0)
+	{
+		range.Pool->Vertices.Allocator.Free(range.VertexOffset, range.VertexCount);
+	}
+	if (range.IndexUnits > 0)
+	{
+		Indices.Allocator.Free(range.IndexOffset, range.IndexUnits);
+	}
+	FreeCount++;
+
+	range = GeometryRange();
+}
+
+bool GeometryArena::IsValid(const GeometryRange& range)
+{
+	return range.Pool != nullptr && range.Generation == Generation;
+}
+
+bool GeometryArena::Bind(const GeometryRange& range, const InstanceBuffer* instances)
+{
+	if (!IsValid(range))
+	{
+		return false;
+	}
+
+	GeometryPool* pool = range.Pool;
+	if (instances && pool->AttributeCount > (int)INSTANCE_ATTRIB_LOCATION)
+	{
+		std::cout << "ERROR::GEOMETRY_ARENA::Vertex layout overlaps instance attributes" << std::endl;
+		return false;
+	}
+
+	GLStateCache::BindVertexArray(pool->VAO);
+
+	// 同一布局的渲染器共用VAO, 换用其他InstanceBuffer时重新设置
+	if (instances && pool->InstanceVBO != instances->GetID())
+	{
+		instances->BindAttributes();
+		pool->InstanceVBO = instances->GetID();
+	}
+	return true;
+}
+
+void GeometryArena::Draw(const GeometryRange& range, GLenum mode)
+{
+	if (!Bind(range))
+	{
+		return;
+	}
+
+	if (range.IndexCount > 0)
+	{
+		glDrawElementsBaseVertex(mode, range.IndexCount, range.IndexType, (void*)((size_t)range.IndexOffset * sizeof(unsigned int)), (GLint)range.VertexOffset);
+	}
+	else
+	{
+		glDrawArrays(mode, (GLint)range.VertexOffset, range.VertexCount);
+	}
+}
+
+void GeometryArena::DrawInstanced(const GeometryRange& range, GLenum mode, const InstanceBuffer* instances)
+{
+	if (!Bind(range, instances))
+	{
+		return;
+	}
+
+	if (range.IndexCount > 0)
+	{
+		glDrawElementsInstancedBaseVertex(mode, range.IndexCount, range.IndexType, (void*)((size_t)range.IndexOffset * sizeof(unsigned int)), instances->GetCount(), (GLint)range.VertexOffset);
+	}
+	else
+	{
+		glDrawArraysInstanced(mode, (GLint)range.VertexOffset, range.VertexCount, instances->GetCount());
+	}
+}
+
+void GeometryArena::ReleaseInstances(GLuint instanceVBO)
+{
+	for (auto& entry : PoolMap)
+	{
+		if (entry.second->InstanceVBO == instanceVBO)
+		{
+			entry.second->InstanceVBO = 0;
+		}
+	}
+}
+
+void GeometryArena::PrintStats()
+{
+	if (AllocCount == 0)
+	{
+		return;
+	}
+
+	size_t vertexUsed = 0;
+	size_t vertexCapacity = 0;
+	for (const auto& entry : PoolMap)
+	{
+		const GeometryBuffer& buffer = entry.second->Vertices;
+		vertexUsed += (size_t)buffer.Allocator.GetUsed() * buffer.UnitSize;
+		vertexCapacity += (size_t)buffer.Allocator.GetCapacity() * buffer.UnitSize;
+	}
+	size_t indexUsed = (size_t)Indices.Allocator.GetUsed() * Indices.UnitSize;
+	size_t indexCapacity = (size_t)Indices.Allocator.GetCapacity() * Indices.UnitSize;
+
+	const float MB = 1024.0f * 1024.0f;
+	std::cout << "Geometry arena: " << PoolMap.size() << " layouts, vertex " << vertexUsed / MB << "/" << vertexCapacity / MB
+		<< " MB, index " << indexUsed / MB << "/" << indexCapacity / MB << " MB, "
+		<< AllocCount << " alloc, " << FreeCount << " free, " << GrowCount << " grow" << std::endl;
+}
+
+GeometryPool* GeometryArena::GetPool(std::type_index type, unsigned int stride, int attributeCount, void (*bindAttributes)())
+{
+	auto it = PoolMap.find(type);
+	if (it != PoolMap.end())
+	{
+		return it->second;
+	}
+
+	if (Indices.ID == 0)
+	{
+		CreateBuffer(Indices, sizeof(unsigned int), InitialIndexCapacity);
+	}
+
+	GeometryPool* pool = new GeometryPool();
+	pool->AttributeCount = attributeCount;
+	pool->BindAttributes = bindAttributes;
+	CreateBuffer(pool->Vertices, stride, InitialVertexCapacity);
+
+	glGenVertexArrays(1, &pool->VAO);
+	RebindPool(pool);
+
+	PoolMap[type] = pool;
+	return pool;
+}
+
+GeometryRange GeometryArena::Allocate(GeometryPool* pool, const void* vertexData, unsigned int vertexCount, const void* indexData, unsigned int indexCount, GLenum indexType)
+{
+	GeometryRange range;
+	range.Pool = pool;
+	range.Generation = Generation;
+	range.IndexType = indexType;
+
+	size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+	unsigned int indexUnits = (unsigned int)((indexCount * indexSize + sizeof(unsigned int) - 1) / sizeof(unsigned int));
+
+	bool bVertexGrown = false;
+	bool bIndexGrown = false;
+	unsigned int vertexOffset = vertexCount > 0 ? AllocateFrom(pool->Vertices, vertexCount, bVertexGrown) : 0;
+	unsigned int indexOffset = indexUnits > 0 ? AllocateFrom(Indices, indexUnits, bIndexGrown) : 0;
+
+	// 扩容后缓冲名已改变, 需重新设置引用它的VAO
+	if (bVertexGrown)
+	{
+		RebindPool(pool);
+	}
+	if (bIndexGrown)
+	{
+		for (auto& entry : PoolMap)
+		{
+			RebindPool(entry.second);
+		}
+	}
+
+	if (vertexOffset == RangeAllocator::INVALID_OFFSET || indexOffset == RangeAllocator::INVALID_OFFSET)
+	{
+		std::cout << "ERROR::GEOMETRY_ARENA::Out of buffer space, vertices: " << vertexCount << ", indices: " << indexCount << std::endl;
+		if (vertexOffset != RangeAllocator::INVALID_OFFSET && vertexCount > 0)
+		{
+			pool->Vertices.Allocator.Free(vertexOffset, vertexCount);
+		}
+		if (indexOffset != RangeAllocator::INVALID_OFFSET && indexUnits > 0)
+		{
+			Indices.Allocator.Free(indexOffset, indexUnits);
+		}
+		return GeometryRange();
+	}
+
+	range.VertexOffset = vertexOffset;
+	range.VertexCount = vertexCount;
+	range.IndexOffset = indexOffset;
+	range.IndexUnits = indexUnits;
+	range.IndexCount = indexCount;
+
+	Upload(pool->Vertices, vertexOffset, vertexData, (size_t)vertexCount * pool->Vertices.UnitSize);
+	Upload(Indices, indexOffset, indexData, indexCount * indexSize);
+
+	AllocCount++;
+	return range;
+}
+
+void GeometryArena::CreateBuffer(GeometryBuffer& buffer, unsigned int unitSize, unsigned int capacity)
+{
+	buffer.UnitSize = unitSize;
+	buffer.Allocator.Grow(capacity);
+
+	glGenBuffers(1, &buffer.ID);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.ID);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity * unitSize, nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+unsigned int GeometryArena::AllocateFrom(GeometryBuffer& buffer, unsigned int size, bool& bGrown)
+{
+	unsigned int offset = buffer.Allocator.Allocate(size);
+	if (offset != RangeAllocator::INVALID_OFFSET)
+	{
+		return offset;
+	}
+
+	// 翻倍直至尾部新增空间足以容纳, 新增空间与原尾部空闲区间连续
+	unsigned int oldCapacity = buffer.Allocator.GetCapacity();
+	size_t newCapacity = oldCapacity > 0 ? oldCapacity : 1;
+	while (newCapacity - oldCapacity < size)
+	{
+		newCapacity *= 2;
+	}
+	if (newCapacity * buffer.UnitSize > MAX_BUFFER_BYTES)
+	{
+		return RangeAllocator::INVALID_OFFSET;
+	}
+
+	GLuint newID;
+	glGenBuffers(1, &newID);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, newID);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(newCapacity * buffer.UnitSize), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_READ_BUFFER, buffer.ID);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)oldCapacity * buffer.UnitSize);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	glDeleteBuffers(1, &buffer.ID);
+	buffer.ID = newID;
+	buffer.Allocator.Grow((unsigned int)newCapacity);
+	bGrown = true;
+	GrowCount++;
+
+	return buffer.Allocator.Allocate(size);
+}
+
+void GeometryArena::Upload(const GeometryBuffer& buffer, unsigned int offset, const void* data, size_t size)
+{
+	if (size == 0 || data == nullptr)
+	{
+		return;
+	}
+
+	// 经由GL_COPY_WRITE_BUFFER上传, 不改变当前VAO的索引缓冲绑定
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.ID);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)offset * buffer.UnitSize, size, data);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GeometryArena::RebindPool(GeometryPool* pool)
+{
+	GLStateCache::BindVertexArray(pool->VAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, pool->Vertices.ID);
+	pool->BindAttributes();
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Indices.ID);
+}
@@ -0,0 +1,157 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <map>
+#include <typeindex>
+
+#include "InstanceBuffer.h"
+
+// 区间分配器, 以单位(顶点或4字节)计, 空闲区间按偏移及大小双索引
+// 分配取能容纳的最小空闲区间, 释放时与前后相邻的空闲区间合并
+class RangeAllocator
+{
+public:
+
+	static const unsigned int INVALID_OFFSET = ~0u;
+
+public:
+
+	// 失败返回INVALID_OFFSET
+	unsigned int Allocate(unsigned int size);
+
+	void Free(unsigned int offset, unsigned int size);
+
+	// 新增的尾部空间作为空闲区间加入, 与原尾部空闲区间合并
+	void Grow(unsigned int newCapacity);
+
+	unsigned int GetCapacity() const;
+
+	unsigned int GetUsed() const;
+
+private:
+
+	unsigned int Capacity = 0;
+
+	unsigned int Used = 0;
+
+	std::map<unsigned int, unsigned int> FreeByOffset;
+
+	std::multimap<unsigned int, unsigned int> FreeBySize;
+
+private:
+
+	void InsertFree(unsigned int offset, unsigned int size);
+
+	void EraseFree(std::map<unsigned int, unsigned int>::iterator it);
+};
+
+// 一个GL缓冲及其分配器, 空间不足时按2倍扩容并以glCopyBufferSubData迁移, 已分配的偏移不变
+struct GeometryBuffer {
+	GLuint ID = 0;
+	unsigned int UnitSize = 0; // 每单位字节数
+	RangeAllocator Allocator;
+};
+
+// 同一顶点布局的网格共用一个顶点缓冲及VAO, VAO的索引缓冲为全局共享的索引缓冲
+struct GeometryPool {
+	GLuint VAO = 0;
+	GeometryBuffer Vertices;
+	int AttributeCount = 0;
+	void (*BindAttributes)() = nullptr;
+	GLuint InstanceVBO = 0; // VAO上已设置实例属性的缓冲
+};
+
+// 网格在arena中的区间, 按值保存于各渲染器
+struct GeometryRange {
+	GeometryPool* Pool = nullptr;
+	unsigned int Generation = 0; // 所属arena的代数, Shutdown后的区间失效
+	unsigned int VertexOffset = 0; // 以顶点计, 即BaseVertex
+	unsigned int VertexCount = 0;
+	unsigned int IndexOffset = 0; // 以4字节计
+	unsigned int IndexUnits = 0;
+	unsigned int IndexCount = 0;
+	GLenum IndexType = GL_UNSIGNED_INT;
+};
+
+// 全部顶点及索引数据的子分配, 替代每个渲染器各自的VAO/VBO/EBO
+// 同一布局的绘制无需切换VAO, 绘制经由glDrawElementsBaseVertex
+// 缓冲在首次分配时创建, 与当前上下文绑定, 上下文销毁前Shutdown
+class GeometryArena
+{
+public:
+
+	// 初始容量, 顶点缓冲以顶点计, 索引缓冲以4字节计
+	static unsigned int InitialVertexCapacity;
+
+	static unsigned int InitialIndexCapacity;
+
+public:
+
+	// 上下文销毁前调用, 删除全部缓冲及VAO, 之前分配的区间失效
+	static void Shutdown();
+
+	// Layout为VertexLayout, 索引可为空; IndexType为GL_UNSIGNED_SHORT或GL_UNSIGNED_INT
+	template<typename Layout>
+	static GeometryRange Allocate(const void* vertexData, unsigned int vertexCount, const void* indexData, unsigned int indexCount, GLenum indexType)
+	{
+		GeometryPool* pool = GetPool(typeid(Layout), (unsigned int)Layout::Stride, Layout::AttributeCount, &BindLayout<Layout>);
+		return Allocate(pool, vertexData, vertexCount, indexData, indexCount, indexType);
+	}
+
+	// 归还区间并置为无效, 无效区间忽略
+	static void Free(GeometryRange& range);
+
+	static bool IsValid(const GeometryRange& range);
+
+	// 绑定区间所属的VAO, instances非空时在VAO上设置实例属性, 区间无效或属性重叠时返回false
+	static bool Bind(const GeometryRange& range, const InstanceBuffer* instances = nullptr);
+
+	// 绑定区间所属的VAO后绘制, 不解绑
+	static void Draw(const GeometryRange& range, GLenum mode);
+
+	// 实例属性从INSTANCE_ATTRIB_LOCATION起, 布局本身的属性不可与之重叠
+	static void DrawInstanced(const GeometryRange& range, GLenum mode, const InstanceBuffer* instances);
+
+	// InstanceBuffer删除前调用, 名称可能被新缓冲复用, 引用它的VAO需在下次绑定时重新设置实例属性
+	static void ReleaseInstances(GLuint instanceVBO);
+
+	static void PrintStats();
+
+private:
+
+	// 每次Shutdown递增, 从1开始使默认构造的区间无效
+	static unsigned int Generation;
+
+	static GeometryBuffer Indices;
+
+	static std::map<std::type_index, GeometryPool*> PoolMap;
+
+	// 本次Shutdown前累计的分配, 释放及扩容次数
+	static unsigned int AllocCount;
+
+	static unsigned int FreeCount;
+
+	static unsigned int GrowCount;
+
+private:
+
+	template<typename Layout>
+	static void BindLayout()
+	{
+		Layout::Bind();
+	}
+
+	static GeometryPool* GetPool(std::type_index type, unsigned int stride, int attributeCount, void (*bindAttributes)());
+
+	static GeometryRange Allocate(GeometryPool* pool, const void* vertexData, unsigned int vertexCount, const void* indexData, unsigned int indexCount, GLenum indexType);
+
+	static void CreateBuffer(GeometryBuffer& buffer, unsigned int unitSize, unsigned int capacity);
+
+	// 空间不足时扩容, 超出上限返回INVALID_OFFSET; 扩容后缓冲名改变, 需RebindPool
+	static unsigned int AllocateFrom(GeometryBuffer& buffer, unsigned int size, bool& bGrown);
+
+	static void Upload(const GeometryBuffer& buffer, unsigned int offset, const void* data, size_t size);
+
+	// 缓冲名改变后重新设置各VAO的属性及索引缓冲, 之后该VAO保持绑定
+	static void RebindPool(GeometryPool* pool);
+};
@@ -0,0 +1,62 @@
+﻿#include "InstanceBuffer.h"
+#include "GeometryArena.h"
+
+InstanceBuffer::InstanceBuffer()
+{
+	glGenBuffers(1, &VBO);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	GeometryArena::ReleaseInstances(VBO);
+	glDeleteBuffers(1, &VBO);
+}
+
+void InstanceBuffer::Clear()
+{
+	InstanceList.clear();
+}
+
+void InstanceBuffer::Add(const glm::mat4& model, const glm::vec4& params)
+{
+	InstanceData instance;
+	instance.Model = model;
+	instance.Params = params;
+	InstanceList.push_back(instance);
+}
+
+int InstanceBuffer::GetCount() const
+{
+	return (int)InstanceList.size();
+}
+
+void InstanceBuffer::Upload()
+{
+	if (InstanceList.empty())
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	if (InstanceList.size() > Capacity)
+	{
+		Capacity = InstanceList.capacity();
+	}
+
+	// 同尺寸的nullptr重新分配即孤立, 驱动另给新存储
+	glBufferData(GL_ARRAY_BUFFER, Capacity * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, InstanceList.size() * sizeof(InstanceData), InstanceList.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::BindAttributes() const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	InstanceLayout::Bind(INSTANCE_ATTRIB_LOCATION, 1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GLuint InstanceBuffer::GetID() const
+{
+	return VBO;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "../render/VertexLayout.h"
+
+// 逐实例数据, 布局与shader/Include/Instancing.glsl一致
+struct InstanceData {
+	glm::mat4 Model; // 世界变换, 与网格自身的model uniform相乘
+	glm::vec4 Params; // 用户参数, 含义由shader决定, 如IBL中x金属度y粗糙度, 单色中rgb颜色
+};
+
+// mat4占4个位置, 按列读取
+typedef VertexLayout<AttrFloat<4>, AttrFloat<4>, AttrFloat<4>, AttrFloat<4>, AttrFloat<4>> InstanceLayout;
+
+static_assert(InstanceLayout::Stride == sizeof(InstanceData), "InstanceLayout must match InstanceData");
+
+// 网格属性占用0~2, 实例属性从3起占用3~7
+static const GLuint INSTANCE_ATTRIB_LOCATION = 3;
+
+// 实例列表, 收集后以一次上传写入GL_ARRAY_BUFFER, 由各渲染器的DrawInstanced以divisor 1读取
+// 一次glDrawElementsInstanced替代逐实例设置uniform及绘制
+class InstanceBuffer
+{
+public:
+
+	InstanceBuffer();
+
+	~InstanceBuffer();
+
+	void Clear();
+
+	void Add(const glm::mat4& model, const glm::vec4& params = glm::vec4(0.0f));
+
+	int GetCount() const;
+
+	// 容量足够时先孤立旧存储再写入, 避免等待上一帧仍在读取的缓冲
+	void Upload();
+
+	// 在当前绑定的VAO上设置实例属性, 缓冲名不随Upload改变, 每个VAO只需一次
+	void BindAttributes() const;
+
+	GLuint GetID() const;
+
+private:
+
+	GLuint VBO;
+
+	// 已分配的实例数
+	size_t Capacity = 0;
+
+	std::vector<InstanceData> InstanceList;
+};
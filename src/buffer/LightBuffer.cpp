@@ -0,0 +1,46 @@
+﻿#include <cstddef>
+#include <iostream>
+
+#include "LightBuffer.h"
+
+LightBuffer::LightBuffer()
+{
+	Buffer = new UniformBuffer(LIGHT_UNIFORM_BINDING, sizeof(LightBlock));
+	Clear();
+}
+
+LightBuffer::~LightBuffer()
+{
+	delete Buffer;
+}
+
+void LightBuffer::Clear()
+{
+	Block.Count = 0;
+	Block.Padding[0] = Block.Padding[1] = Block.Padding[2] = 0;
+}
+
+bool LightBuffer::Add(glm::vec3 position, glm::vec3 color, float linear, float quadratic)
+{
+	if (Block.Count >= MAX_LIGHTS)
+	{
+		std::cout << "ERROR::LIGHT_BUFFER::Light count exceeds " << MAX_LIGHTS << std::endl;
+		return false;
+	}
+
+	PackedLight& light = Block.LightList[Block.Count++];
+	light.Position = glm::vec4(position, linear);
+	light.Color = glm::vec4(color, quadratic);
+	return true;
+}
+
+int LightBuffer::GetCount() const
+{
+	return Block.Count;
+}
+
+void LightBuffer::Upload()
+{
+	GLsizeiptr size = offsetof(LightBlock, LightList) + Block.Count * sizeof(PackedLight);
+	Buffer->Update(&Block, size);
+}
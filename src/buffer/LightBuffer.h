@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "UniformBuffer.h"
+
+// 打包光源, std140下每个光源两个vec4
+struct PackedLight {
+	glm::vec4 Position; // xyz位置, w一次衰减项
+	glm::vec4 Color; // rgb颜色, a二次衰减项
+};
+
+// 头部16字节加511个光源, 总大小不超过GL保证的最小uniform block大小16KB
+static const int MAX_LIGHTS = 511;
+
+// std140布局, 与shader/Include/LightBuffer.glsl一致
+struct LightBlock {
+	int Count;
+	int Padding[3];
+	PackedLight LightList[MAX_LIGHTS];
+};
+
+static_assert(sizeof(LightBlock) <= 16384, "LightBlock must fit in the minimum uniform block size");
+
+// 场景光源列表, 收集后以一次glBufferSubData上传至LIGHT_UNIFORM_BINDING, 只上传实际使用的部分
+// 替代逐光源拼接"lights[i].xxx"名称的uniform设置
+class LightBuffer
+{
+public:
+
+	LightBuffer();
+
+	~LightBuffer();
+
+	void Clear();
+
+	// 超出MAX_LIGHTS时忽略并返回false
+	bool Add(glm::vec3 position, glm::vec3 color, float linear = 0.0f, float quadratic = 0.0f);
+
+	int GetCount() const;
+
+	void Upload();
+
+private:
+
+	UniformBuffer* Buffer;
+
+	LightBlock Block;
+};
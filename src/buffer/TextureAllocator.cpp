@@ -1,11 +1,12 @@
 ﻿#include "TextureAllocator.h"
+#include "../render/GLStateCache.h"
 
 GLuint TextureAllocator::GenTex(GLuint width, GLuint height, unsigned char* data, TexParam* param)
 {
 	GLuint TextureID;
 
 	glGenTextures(1, &TextureID);
-	glBindTexture(GL_TEXTURE_2D, TextureID);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, TextureID);
 
 	if (data)
 	{
@@ -27,7 +28,7 @@ GLuint TextureAllocator::GenTex(GLuint width, GLuint height, unsigned char* data
 		glGenerateMipmap(GL_TEXTURE_2D);
 	};
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
 
 	return TextureID;
 }
@@ -37,7 +38,7 @@ GLuint TextureAllocator::GenCubeMap(GLuint width, GLuint height, TexParam* param
 	GLuint CubeMapID;
 
 	glGenTextures(1, &CubeMapID);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, CubeMapID);
+	GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, CubeMapID);
 
 	for (unsigned int i = 0; i < 6; ++i)
 	{	
@@ -56,7 +57,7 @@ GLuint TextureAllocator::GenCubeMap(GLuint width, GLuint height, TexParam* param
 		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 	};
 
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
 	return CubeMapID;
 }
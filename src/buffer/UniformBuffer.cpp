@@ -0,0 +1,49 @@
+﻿#include "UniformBuffer.h"
+
+struct UniformBlockEntry {
+	const char* Name;
+	GLuint Binding;
+};
+
+// shader中的block名称及绑定点
+static const UniformBlockEntry BLOCK_LIST[] = {
+	{ "FrameUniforms", FRAME_UNIFORM_BINDING },
+	{ "LightBuffer", LIGHT_UNIFORM_BINDING },
+};
+
+UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr size)
+{
+	Binding = binding;
+	Size = size;
+
+	glGenBuffers(1, &UBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, UBO);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	glDeleteBuffers(1, &UBO);
+}
+
+void UniformBuffer::Update(const void* data, GLsizeiptr size, GLintptr offset)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::BindBlocks(GLuint program)
+{
+	for (const UniformBlockEntry& entry : BLOCK_LIST)
+	{
+		GLuint index = glGetUniformBlockIndex(program, entry.Name);
+		if (index != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(program, index, entry.Binding);
+		}
+	}
+}
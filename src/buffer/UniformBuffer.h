@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// 全局uniform block的固定绑定点, Shader链接后按block名称绑定
+enum EUniformBlockBinding {
+	FRAME_UNIFORM_BINDING = 0,
+	LIGHT_UNIFORM_BINDING = 1
+};
+
+// 每帧相机数据, std140布局, 与shader/Include/FrameUniforms.glsl一致
+struct FrameUniforms {
+	glm::mat4 View;
+	glm::mat4 Projection;
+	glm::mat4 ViewProj;
+	glm::vec3 ViewPos;
+	float NearPlane;
+	float FarPlane;
+	float Padding; // vec2按8字节对齐
+	glm::vec2 ScreenSize;
+};
+
+static_assert(sizeof(FrameUniforms) == 224, "FrameUniforms must match std140 layout");
+
+// 固定绑定点的uniform缓冲, 上下文内绑定一次, 之后只更新内容
+class UniformBuffer
+{
+public:
+
+	GLuint UBO;
+
+	GLuint Binding;
+
+	GLsizeiptr Size;
+
+public:
+
+	UniformBuffer(GLuint binding, GLsizeiptr size);
+
+	~UniformBuffer();
+
+	void Update(const void* data, GLsizeiptr size, GLintptr offset = 0);
+
+	// 将program中的已知uniform block绑定至对应绑定点, 未声明的block忽略
+	static void BindBlocks(GLuint program);
+};
@@ -0,0 +1,369 @@
+﻿#include "BVH.h"
+
+#include <algorithm>
+#include <cfloat>
+
+int BVH::Insert(const BoundingBox& box)
+{
+	BoxList.push_back(box);
+	return (int)BoxList.size() - 1;
+}
+
+void BVH::Update(int handle, const BoundingBox& box)
+{
+	BoxList[handle] = box;
+}
+
+void BVH::Clear()
+{
+	BoxList.clear();
+	NodeList.clear();
+	IndexList.clear();
+	CentroidList.clear();
+}
+
+void BVH::Build()
+{
+	int count = (int)BoxList.size();
+
+	NodeList.clear();
+	IndexList.resize(count);
+	CentroidList.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		IndexList[i] = i;
+		CentroidList[i] = (BoxList[i].Min + BoxList[i].Max) * 0.5f;
+	}
+	if (count == 0)
+	{
+		return;
+	}
+
+	// 二叉树节点数不超过2n - 1
+	NodeList.reserve(count * 2);
+
+	Node root;
+	root.Start = 0;
+	root.Count = count;
+	root.Left = -1;
+	root.Box = ComputeBounds(0, count);
+	NodeList.push_back(root);
+
+	std::vector<int> stack;
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		int nodeIndex = stack.back();
+		stack.pop_back();
+
+		Node node = NodeList[nodeIndex];
+		int axis;
+		float splitPos;
+		if (node.Count <= MAX_LEAF_SIZE || !FindSplit(node, axis, splitPos))
+		{
+			continue;
+		}
+
+		int* begin = IndexList.data() + node.Start;
+		int* end = begin + node.Count;
+		int* middle = std::partition(begin, end, [&](int handle) { return CentroidList[handle][axis] < splitPos; });
+
+		// 分箱边界与质心重合等退化情况按中位数划分
+		if (middle == begin || middle == end)
+		{
+			middle = begin + node.Count / 2;
+			std::nth_element(begin, middle, end, [&](int a, int b) { return CentroidList[a][axis] < CentroidList[b][axis]; });
+		}
+
+		int leftCount = (int)(middle - begin);
+
+		Node left;
+		left.Start = node.Start;
+		left.Count = leftCount;
+		left.Left = -1;
+		left.Box = ComputeBounds(left.Start, left.Count);
+
+		Node right;
+		right.Start = node.Start + leftCount;
+		right.Count = node.Count - leftCount;
+		right.Left = -1;
+		right.Box = ComputeBounds(right.Start, right.Count);
+
+		NodeList[nodeIndex].Left = (int)NodeList.size();
+		NodeList.push_back(left);
+		NodeList.push_back(right);
+
+		stack.push_back(NodeList[nodeIndex].Left);
+		stack.push_back(NodeList[nodeIndex].Left + 1);
+	}
+}
+
+bool BVH::FindSplit(const Node& node, int& axis, float& splitPos) const
+{
+	BoundingBox centroidBounds;
+	centroidBounds.Min = centroidBounds.Max = CentroidList[IndexList[node.Start]];
+	for (int i = node.Start + 1; i < node.Start + node.Count; i++)
+	{
+		centroidBounds.Min = glm::min(centroidBounds.Min, CentroidList[IndexList[i]]);
+		centroidBounds.Max = glm::max(centroidBounds.Max, CentroidList[IndexList[i]]);
+	}
+
+	// 不划分的代价, 与划分代价同以半表面积乘物体数计
+	float bestCost = node.Box.GetHalfArea() * node.Count;
+	bool bFound = false;
+
+	for (int a = 0; a < 3; a++)
+	{
+		float extent = centroidBounds.Max[a] - centroidBounds.Min[a];
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		BoundingBox binBox[BIN_COUNT];
+		int binCount[BIN_COUNT] = {};
+		float scale = BIN_COUNT / extent;
+		for (int i = node.Start; i < node.Start + node.Count; i++)
+		{
+			int handle = IndexList[i];
+			int bin = glm::min((int)((CentroidList[handle][a] - centroidBounds.Min[a]) * scale), BIN_COUNT - 1);
+			if (binCount[bin] == 0)
+			{
+				binBox[bin] = BoxList[handle];
+			}
+			else
+			{
+				binBox[bin].Merge(BoxList[handle]);
+			}
+			binCount[bin]++;
+		}
+
+		// 自右向左累计右侧, 再自左向右计算各分界的代价
+		float rightArea[BIN_COUNT];
+		int rightCount[BIN_COUNT];
+		BoundingBox accumBox;
+		int accumCount = 0;
+		for (int i = BIN_COUNT - 1; i > 0; i--)
+		{
+			if (binCount[i] > 0)
+			{
+				if (accumCount == 0)
+				{
+					accumBox = binBox[i];
+				}
+				else
+				{
+					accumBox.Merge(binBox[i]);
+				}
+				accumCount += binCount[i];
+			}
+			rightArea[i] = accumCount > 0 ? accumBox.GetHalfArea() : 0.0f;
+			rightCount[i] = accumCount;
+		}
+
+		accumCount = 0;
+		for (int i = 0; i < BIN_COUNT - 1; i++)
+		{
+			if (binCount[i] > 0)
+			{
+				if (accumCount == 0)
+				{
+					accumBox = binBox[i];
+				}
+				else
+				{
+					accumBox.Merge(binBox[i]);
+				}
+				accumCount += binCount[i];
+			}
+			if (accumCount == 0 || rightCount[i + 1] == 0)
+			{
+				continue;
+			}
+
+			float cost = accumBox.GetHalfArea() * accumCount + rightArea[i + 1] * rightCount[i + 1];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				axis = a;
+				splitPos = centroidBounds.Min[a] + (i + 1) / scale;
+				bFound = true;
+			}
+		}
+	}
+
+	return bFound;
+}
+
+BoundingBox BVH::ComputeBounds(int start, int count) const
+{
+	BoundingBox box = BoxList[IndexList[start]];
+	for (int i = start + 1; i < start + count; i++)
+	{
+		box.Merge(BoxList[IndexList[i]]);
+	}
+	return box;
+}
+
+void BVH::Refit()
+{
+	for (int i = (int)NodeList.size() - 1; i >= 0; i--)
+	{
+		Node& node = NodeList[i];
+		if (node.Left < 0)
+		{
+			node.Box = ComputeBounds(node.Start, node.Count);
+		}
+		else
+		{
+			node.Box = NodeList[node.Left].Box;
+			node.Box.Merge(NodeList[node.Left + 1].Box);
+		}
+	}
+}
+
+int BVH::GetCount() const
+{
+	return (int)BoxList.size();
+}
+
+const BoundingBox& BVH::GetBox(int handle) const
+{
+	return BoxList[handle];
+}
+
+int BVH::Cull(const Frustum& frustum, std::vector<uint8_t>& visibleList) const
+{
+	visibleList.assign(BoxList.size(), 0);
+	if (NodeList.empty())
+	{
+		return 0;
+	}
+
+	int visibleCount = 0;
+
+	// 节点及其仍需测试的平面
+	struct StackEntry {
+		int NodeIndex;
+		uint32_t PlaneMask;
+	};
+	// SAH树可能不平衡, 栈深度不设上限
+	std::vector<StackEntry> stack;
+	stack.push_back({ 0, 0x3F });
+
+	while (!stack.empty())
+	{
+		StackEntry entry = stack.back();
+		stack.pop_back();
+		const Node& node = NodeList[entry.NodeIndex];
+
+		uint32_t planeMask = entry.PlaneMask;
+		EFrustumTest result = frustum.TestBox(node.Box, planeMask);
+		if (result == FRUSTUM_OUTSIDE)
+		{
+			continue;
+		}
+
+		if (result == FRUSTUM_INSIDE)
+		{
+			for (int i = node.Start; i < node.Start + node.Count; i++)
+			{
+				visibleList[IndexList[i]] = 1;
+			}
+			visibleCount += node.Count;
+		}
+		else if (node.Left < 0)
+		{
+			for (int i = node.Start; i < node.Start + node.Count; i++)
+			{
+				uint32_t objectMask = planeMask;
+				if (frustum.TestBox(BoxList[IndexList[i]], objectMask) != FRUSTUM_OUTSIDE)
+				{
+					visibleList[IndexList[i]] = 1;
+					visibleCount++;
+				}
+			}
+		}
+		else
+		{
+			stack.push_back({ node.Left + 1, planeMask });
+			stack.push_back({ node.Left, planeMask });
+		}
+	}
+	return visibleCount;
+}
+
+bool BVH::IntersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& invDir, float maxDistance, float& distance)
+{
+	// slab法, 平行于某轴时invDir为无穷大, 比较结果仍正确
+	glm::vec3 t0 = (box.Min - origin) * invDir;
+	glm::vec3 t1 = (box.Max - origin) * invDir;
+	glm::vec3 tNear = glm::min(t0, t1);
+	glm::vec3 tFar = glm::max(t0, t1);
+
+	float enter = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+	float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDistance));
+	distance = enter;
+	return enter <= exit;
+}
+
+bool BVH::RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, RayHit& hit) const
+{
+	hit = RayHit();
+	if (NodeList.empty())
+	{
+		return false;
+	}
+
+	glm::vec3 invDir = 1.0f / dir;
+	float bestDistance = maxDistance;
+
+	std::vector<int> stack;
+	stack.push_back(0);
+
+	while (!stack.empty())
+	{
+		const Node& node = NodeList[stack.back()];
+		stack.pop_back();
+
+		float distance;
+		if (!IntersectRay(node.Box, origin, invDir, bestDistance, distance))
+		{
+			continue;
+		}
+
+		if (node.Left < 0)
+		{
+			for (int i = node.Start; i < node.Start + node.Count; i++)
+			{
+				if (IntersectRay(BoxList[IndexList[i]], origin, invDir, bestDistance, distance) && (hit.Handle < 0 || distance < bestDistance))
+				{
+					bestDistance = distance;
+					hit.Handle = IndexList[i];
+					hit.Distance = distance;
+				}
+			}
+			continue;
+		}
+
+		// 近的子节点后入栈先访问, 命中后远处节点可按距离剪枝
+		float leftDistance, rightDistance;
+		bool bLeft = IntersectRay(NodeList[node.Left].Box, origin, invDir, bestDistance, leftDistance);
+		bool bRight = IntersectRay(NodeList[node.Left + 1].Box, origin, invDir, bestDistance, rightDistance);
+		if (bLeft && bRight)
+		{
+			bool bLeftFirst = leftDistance <= rightDistance;
+			stack.push_back(bLeftFirst ? node.Left + 1 : node.Left);
+			stack.push_back(bLeftFirst ? node.Left : node.Left + 1);
+		}
+		else if (bLeft)
+		{
+			stack.push_back(node.Left);
+		}
+		else if (bRight)
+		{
+			stack.push_back(node.Left + 1);
+		}
+	}
+	return hit.Handle >= 0;
+}
@@ -0,0 +1,80 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+
+// 射线拾取结果, Distance为到包围盒的距离, 起点在盒内时为0
+struct RayHit {
+	int Handle = -1;
+	float Distance = 0.0f;
+};
+
+// 场景物体世界包围盒的层次结构, 分箱SAH构建, 物体移动后Refit只更新节点包围盒
+// 物体以句柄引用, 句柄按插入顺序从0分配; 插入或移除后需重新Build, Build前查询不含新物体
+class BVH
+{
+public:
+
+	// 叶节点物体数上限, SAH判定不值得再分时可提前成为叶节点
+	static const int MAX_LEAF_SIZE = 4;
+
+	// 每轴分箱数
+	static const int BIN_COUNT = 12;
+
+public:
+
+	int Insert(const BoundingBox& box);
+
+	// 之后调用Refit
+	void Update(int handle, const BoundingBox& box);
+
+	void Clear();
+
+	void Build();
+
+	// 自底向上重新计算节点包围盒, 拓扑不变; 物体移动幅度大时树质量下降, 可重新Build
+	void Refit();
+
+	int GetCount() const;
+
+	const BoundingBox& GetBox(int handle) const;
+
+	// visibleList[handle]为0或1, 返回可见数; 节点完全在视锥内时其下的物体不再测试
+	int Cull(const Frustum& frustum, std::vector<uint8_t>& visibleList) const;
+
+	// 最近的相交包围盒, dir需归一化, 未命中时返回false
+	bool RayCast(const glm::vec3& origin, const glm::vec3& dir, float maxDistance, RayHit& hit) const;
+
+private:
+
+	// 节点覆盖IndexList[Start, Start + Count), Left < 0为叶节点, 否则子节点为Left及Left + 1
+	// 子节点总排在父节点之后, 逆序遍历即为自底向上
+	struct Node {
+		BoundingBox Box;
+		int Start;
+		int Count;
+		int Left;
+	};
+
+	std::vector<BoundingBox> BoxList;
+
+	std::vector<Node> NodeList;
+
+	// 按节点划分重排的句柄
+	std::vector<int> IndexList;
+
+	std::vector<glm::vec3> CentroidList;
+
+private:
+
+	// 分箱SAH, 不值得划分时返回false
+	bool FindSplit(const Node& node, int& axis, float& splitPos) const;
+
+	// 节点区间内的物体按包围盒合并
+	BoundingBox ComputeBounds(int start, int count) const;
+
+	static bool IntersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& invDir, float maxDistance, float& distance);
+};
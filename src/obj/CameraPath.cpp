@@ -0,0 +1,153 @@
+﻿#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "CameraPath.h"
+
+bool CameraPath::Load(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::CAMERAPATH::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+		return false;
+	}
+
+	KeyList.clear();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		std::istringstream stream(line);
+		CameraKey key;
+		if (stream >> key.Time >> key.Pos.x >> key.Pos.y >> key.Pos.z >> key.Yaw >> key.Pitch)
+		{
+			KeyList.push_back(key);
+		}
+	}
+
+	return !KeyList.empty();
+}
+
+bool CameraPath::Save(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::CAMERAPATH::FILE_NOT_SUCCESFULLY_WRITTEN: " << path << std::endl;
+		return false;
+	}
+
+	file << "# time posX posY posZ yaw pitch" << std::endl;
+	for (const CameraKey& key : KeyList)
+	{
+		file << key.Time << " " << key.Pos.x << " " << key.Pos.y << " " << key.Pos.z << " " << key.Yaw << " " << key.Pitch << std::endl;
+	}
+
+	return true;
+}
+
+void CameraPath::AddKey(float time, const Camera* camera)
+{
+	CameraKey key;
+	key.Time = time;
+	key.Pos = camera->Pos;
+	key.Yaw = camera->Yaw;
+	key.Pitch = camera->Pitch;
+	KeyList.push_back(key);
+}
+
+void CameraPath::Apply(Camera* camera, float time) const
+{
+	if (KeyList.empty())
+	{
+		return;
+	}
+
+	float duration = GetDuration();
+	if (duration > 0.0f)
+	{
+		time = std::fmod(time, duration);
+	}
+	time += KeyList.front().Time;
+
+	// 找到time所在区间, 关键帧数量不大, 线性查找即可
+	size_t next = 0;
+	while (next < KeyList.size() && KeyList[next].Time < time)
+	{
+		next++;
+	}
+
+	CameraKey key;
+	if (next == 0)
+	{
+		key = KeyList.front();
+	}
+	else if (next == KeyList.size())
+	{
+		key = KeyList.back();
+	}
+	else
+	{
+		const CameraKey& a = KeyList[next - 1];
+		const CameraKey& b = KeyList[next];
+		float t = (b.Time > a.Time) ? (time - a.Time) / (b.Time - a.Time) : 0.0f;
+
+		key.Pos = glm::mix(a.Pos, b.Pos, t);
+		key.Yaw = a.Yaw + (b.Yaw - a.Yaw) * t;
+		key.Pitch = a.Pitch + (b.Pitch - a.Pitch) * t;
+	}
+
+	camera->Pos = key.Pos;
+	camera->Yaw = key.Yaw;
+	camera->Pitch = key.Pitch;
+	camera->UpdateCameraVectors();
+}
+
+float CameraPath::GetDuration() const
+{
+	if (KeyList.size() < 2)
+	{
+		return 0.0f;
+	}
+	return KeyList.back().Time - KeyList.front().Time;
+}
+
+bool CameraPath::IsEmpty() const
+{
+	return KeyList.empty();
+}
+
+CameraPath CameraPath::MakeOrbit(glm::vec3 center, glm::vec3 startPos, float radius, float duration, int keyCount)
+{
+	CameraPath path;
+
+	glm::vec3 offset = startPos - center;
+	float startAngle = std::atan2(offset.z, offset.x);
+	float height = offset.y;
+
+	// 俯仰角固定朝向环绕中心
+	float pitch = glm::degrees(std::atan2(-height, radius));
+
+	for (int i = 0; i <= keyCount; i++)
+	{
+		float ratio = (float)i / (float)keyCount;
+		float angle = startAngle + ratio * glm::radians(360.0f);
+
+		CameraKey key;
+		key.Time = ratio * duration;
+		key.Pos = center + glm::vec3(std::cos(angle) * radius, height, std::sin(angle) * radius);
+		// 视线方向与方位角相反, yaw不做回绕保证插值连续
+		key.Yaw = glm::degrees(angle) + 180.0f;
+		key.Pitch = pitch;
+		path.KeyList.push_back(key);
+	}
+
+	return path;
+}
@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Camera.h"
+
+// 相机路径关键帧, 时间单位秒, 角度单位度
+struct CameraKey {
+	float Time = 0.0f;
+	glm::vec3 Pos = glm::vec3(0.0f);
+	float Yaw = -90.0f;
+	float Pitch = 0.0f;
+};
+
+// 确定性相机路径, 基准测试按帧时间驱动相机, 保证每次运行画面一致
+class CameraPath
+{
+public:
+
+	std::vector<CameraKey> KeyList;
+
+public:
+
+	// 文本格式, 每行: time posX posY posZ yaw pitch, #开头为注释
+	bool Load(const std::string& path);
+
+	bool Save(const std::string& path) const;
+
+	// 录制当前相机状态, 时间需单调递增
+	void AddKey(float time, const Camera* camera);
+
+	// 按时间线性插值并写入相机, 超出路径时长后循环
+	void Apply(Camera* camera, float time) const;
+
+	float GetDuration() const;
+
+	bool IsEmpty() const;
+
+	// 绕center水平环绕一周, 起点为startPos在水平面上的方位
+	static CameraPath MakeOrbit(glm::vec3 center, glm::vec3 startPos, float radius, float duration, int keyCount = 16);
+};
@@ -0,0 +1,255 @@
+﻿#include "Frustum.h"
+
+#include <cfloat>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE
+#endif
+
+BoundingSphere BoundingSphere::FromBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+	BoundingSphere sphere;
+	sphere.Center = (boundsMin + boundsMax) * 0.5f;
+	sphere.Radius = glm::length(boundsMax - boundsMin) * 0.5f;
+	return sphere;
+}
+
+BoundingSphere BoundingSphere::Transform(const glm::mat4& model) const
+{
+	float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+	BoundingSphere sphere;
+	sphere.Center = glm::vec3(model * glm::vec4(Center, 1.0f));
+	sphere.Radius = Radius * scale;
+	return sphere;
+}
+
+BoundingBox BoundingBox::Transform(const glm::mat4& model) const
+{
+	glm::vec3 center = (Min + Max) * 0.5f;
+	glm::vec3 extent = (Max - Min) * 0.5f;
+
+	// 新半边长为|M| * extent
+	glm::vec3 newExtent(0.0f);
+	for (int c = 0; c < 3; c++)
+	{
+		newExtent += glm::abs(glm::vec3(model[c])) * extent[c];
+	}
+	glm::vec3 newCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+
+	BoundingBox box;
+	box.Min = newCenter - newExtent;
+	box.Max = newCenter + newExtent;
+	return box;
+}
+
+void BoundingBox::Merge(const BoundingBox& other)
+{
+	Min = glm::min(Min, other.Min);
+	Max = glm::max(Max, other.Max);
+}
+
+float BoundingBox::GetHalfArea() const
+{
+	glm::vec3 size = glm::max(Max - Min, glm::vec3(0.0f));
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+void SphereList::Clear()
+{
+	X.clear();
+	Y.clear();
+	Z.clear();
+	Radius.clear();
+	Count = 0;
+}
+
+void SphereList::Add(const BoundingSphere& sphere)
+{
+	if (Count == (int)X.size())
+	{
+		// 一次补齐一组, 补齐项在任何平面外
+		X.resize(X.size() + LANE_COUNT, 0.0f);
+		Y.resize(Y.size() + LANE_COUNT, 0.0f);
+		Z.resize(Z.size() + LANE_COUNT, 0.0f);
+		Radius.resize(Radius.size() + LANE_COUNT, -FLT_MAX);
+	}
+
+	X[Count] = sphere.Center.x;
+	Y[Count] = sphere.Center.y;
+	Z[Count] = sphere.Center.z;
+	Radius[Count] = sphere.Radius;
+	Count++;
+}
+
+int SphereList::GetCount() const
+{
+	return Count;
+}
+
+const float* SphereList::GetX() const
+{
+	return X.data();
+}
+
+const float* SphereList::GetY() const
+{
+	return Y.data();
+}
+
+const float* SphereList::GetZ() const
+{
+	return Z.data();
+}
+
+const float* SphereList::GetRadius() const
+{
+	return Radius.data();
+}
+
+int SphereList::GetPaddedCount() const
+{
+	return (int)X.size();
+}
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProj)
+{
+	// glm按列存储, viewProj[c][r]为第r行第c列
+	glm::vec4 row[4];
+	for (int r = 0; r < 4; r++)
+	{
+		row[r] = glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+	}
+
+	Frustum frustum;
+	frustum.Planes[0] = row[3] + row[0];
+	frustum.Planes[1] = row[3] - row[0];
+	frustum.Planes[2] = row[3] + row[1];
+	frustum.Planes[3] = row[3] - row[1];
+	frustum.Planes[4] = row[3] + row[2];
+	frustum.Planes[5] = row[3] - row[2];
+
+	for (glm::vec4& plane : frustum.Planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+	return frustum;
+}
+
+bool Frustum::TestSphere(const BoundingSphere& sphere) const
+{
+	for (const glm::vec4& plane : Planes)
+	{
+		if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+EFrustumTest Frustum::TestBox(const BoundingBox& box, uint32_t& planeMask) const
+{
+	glm::vec3 center = (box.Min + box.Max) * 0.5f;
+	glm::vec3 extent = (box.Max - box.Min) * 0.5f;
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (!(planeMask & (1u << i)))
+		{
+			continue;
+		}
+
+		// 中心距离及包围盒在法线方向上的投影半径
+		float distance = glm::dot(glm::vec3(Planes[i]), center) + Planes[i].w;
+		float radius = glm::dot(glm::abs(glm::vec3(Planes[i])), extent);
+		if (distance + radius < 0.0f)
+		{
+			return FRUSTUM_OUTSIDE;
+		}
+		if (distance - radius >= 0.0f)
+		{
+			planeMask &= ~(1u << i);
+		}
+	}
+	return planeMask == 0 ? FRUSTUM_INSIDE : FRUSTUM_INTERSECT;
+}
+
+int Frustum::Cull(const SphereList& spheres, std::vector<uint8_t>& visibleList) const
+{
+	const float* x = spheres.GetX();
+	const float* y = spheres.GetY();
+	const float* z = spheres.GetZ();
+	const float* radius = spheres.GetRadius();
+	int count = spheres.GetCount();
+	int paddedCount = spheres.GetPaddedCount();
+
+	// 按补齐长度写入, 返回前截断
+	visibleList.resize(paddedCount);
+	int visibleCount = 0;
+
+#if defined(FRUSTUM_AVX)
+	for (int i = 0; i < paddedCount; i += 8)
+	{
+		__m256 px = _mm256_loadu_ps(x + i);
+		__m256 py = _mm256_loadu_ps(y + i);
+		__m256 pz = _mm256_loadu_ps(z + i);
+		__m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const glm::vec4& plane : Planes)
+		{
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, _mm256_set1_ps(plane.x)), _mm256_mul_ps(py, _mm256_set1_ps(plane.y))),
+				_mm256_add_ps(_mm256_mul_ps(pz, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(inside);
+		for (int lane = 0; lane < 8; lane++)
+		{
+			visibleList[i + lane] = (mask >> lane) & 1;
+		}
+	}
+#elif defined(FRUSTUM_SSE)
+	for (int i = 0; i < paddedCount; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(x + i);
+		__m128 py = _mm_loadu_ps(y + i);
+		__m128 pz = _mm_loadu_ps(z + i);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+		__m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+		for (const glm::vec4& plane : Planes)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.x)), _mm_mul_ps(py, _mm_set1_ps(plane.y))),
+				_mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			visibleList[i + lane] = (mask >> lane) & 1;
+		}
+	}
+#else
+	for (int i = 0; i < paddedCount; i++)
+	{
+		BoundingSphere sphere;
+		sphere.Center = glm::vec3(x[i], y[i], z[i]);
+		sphere.Radius = radius[i];
+		visibleList[i] = TestSphere(sphere) ? 1 : 0;
+	}
+#endif
+
+	visibleList.resize(count);
+	for (uint8_t visible : visibleList)
+	{
+		visibleCount += visible;
+	}
+	return visibleCount;
+}
@@ -0,0 +1,101 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 包围球, 半径为负表示永不可见
+struct BoundingSphere {
+	glm::vec3 Center = glm::vec3(0.0f);
+	float Radius = 0.0f;
+
+	// 外接于包围盒
+	static BoundingSphere FromBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+	// 半径按model三轴中最大的缩放放大, 保证仍包含变换后的物体
+	BoundingSphere Transform(const glm::mat4& model) const;
+};
+
+// 轴对齐包围盒
+struct BoundingBox {
+	glm::vec3 Min = glm::vec3(0.0f);
+	glm::vec3 Max = glm::vec3(0.0f);
+
+	// 变换后的8个角点的包围盒(Arvo), 旋转时偏大
+	BoundingBox Transform(const glm::mat4& model) const;
+
+	void Merge(const BoundingBox& other);
+
+	// 表面积的一半, SAH代价只需相对大小
+	float GetHalfArea() const;
+};
+
+// 包围盒与视锥的关系
+enum EFrustumTest {
+	FRUSTUM_OUTSIDE,
+	FRUSTUM_INTERSECT,
+	FRUSTUM_INSIDE
+};
+
+// 包围球的SoA存储, 供Frustum批量测试; 容量按8补齐, 补齐项半径为负, 测试结果总为不可见
+class SphereList
+{
+public:
+
+	static const int LANE_COUNT = 8;
+
+public:
+
+	void Clear();
+
+	void Add(const BoundingSphere& sphere);
+
+	int GetCount() const;
+
+	// 长度为GetPaddedCount()
+	const float* GetX() const;
+
+	const float* GetY() const;
+
+	const float* GetZ() const;
+
+	const float* GetRadius() const;
+
+	int GetPaddedCount() const;
+
+private:
+
+	std::vector<float> X;
+
+	std::vector<float> Y;
+
+	std::vector<float> Z;
+
+	std::vector<float> Radius;
+
+	int Count = 0;
+};
+
+// 视锥的六个平面, 法线朝内且已归一化, 点到平面的有符号距离为dot(xyz, p) + w
+class Frustum
+{
+public:
+
+	// 左, 右, 下, 上, 近, 远
+	glm::vec4 Planes[6];
+
+public:
+
+	// 由view-projection矩阵提取(Gribb-Hartmann), 裁剪空间z为[-w, w]
+	static Frustum FromMatrix(const glm::mat4& viewProj);
+
+	// 与视锥相交或位于其内时为true, 保守测试, 角落附近可能误判为可见
+	bool TestSphere(const BoundingSphere& sphere) const;
+
+	// planeMask的第i位为1时测试平面i, 返回时清除包围盒完全位于其内侧的平面, 子节点可沿用
+	EFrustumTest TestBox(const BoundingBox& box, uint32_t& planeMask) const;
+
+	// 逐个测试列表中的包围球, visibleList[i]为0或1, 返回可见数
+	// 编译开启AVX时一次测试8个, 否则以SSE一次4个, 非x86平台逐个测试
+	int Cull(const SphereList& spheres, std::vector<uint8_t>& visibleList) const;
+};
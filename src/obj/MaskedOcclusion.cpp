@@ -0,0 +1,479 @@
+﻿#include "MaskedOcclusion.h"
+#include "../tool/ThreadPool.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MASKED_SSE2
+#endif
+
+bool MaskedOcclusion::bEnabled = true;
+
+// 每个并行任务测试的物体数
+static const int CULL_CHUNK_SIZE = 64;
+
+static const uint32_t FULL_ROW = 0xFFFFFFFFu;
+
+// 分块内坐标[left, right]的一行像素, 超出分块的部分截去
+static uint32_t SpanMask(int left, int right)
+{
+	left = std::max(left, 0);
+	right = std::min(right, MaskedOcclusion::TILE_WIDTH - 1);
+	if (left > right)
+	{
+		return 0;
+	}
+	return (FULL_ROW >> (31 - right + left)) << left;
+}
+
+// 以下为一个分块的4行掩码, SSE2下整块一次处理
+
+static bool IsMaskEmpty(const uint32_t* mask)
+{
+#if defined(MASKED_SSE2)
+	__m128i value = _mm_loadu_si128((const __m128i*)mask);
+	return _mm_movemask_epi8(_mm_cmpeq_epi32(value, _mm_setzero_si128())) == 0xFFFF;
+#else
+	return (mask[0] | mask[1] | mask[2] | mask[3]) == 0;
+#endif
+}
+
+static bool IsMaskFull(const uint32_t* mask)
+{
+#if defined(MASKED_SSE2)
+	__m128i value = _mm_loadu_si128((const __m128i*)mask);
+	return _mm_movemask_epi8(_mm_cmpeq_epi32(value, _mm_set1_epi32(-1))) == 0xFFFF;
+#else
+	return (mask[0] & mask[1] & mask[2] & mask[3]) == FULL_ROW;
+#endif
+}
+
+static void MergeMask(uint32_t* target, const uint32_t* mask)
+{
+#if defined(MASKED_SSE2)
+	__m128i value = _mm_or_si128(_mm_loadu_si128((const __m128i*)target), _mm_loadu_si128((const __m128i*)mask));
+	_mm_storeu_si128((__m128i*)target, value);
+#else
+	for (int i = 0; i < MaskedOcclusion::TILE_HEIGHT; i++)
+	{
+		target[i] |= mask[i];
+	}
+#endif
+}
+
+// mask中存在不属于layer的像素
+static bool HasUncovered(const uint32_t* mask, const uint32_t* layer)
+{
+#if defined(MASKED_SSE2)
+	__m128i value = _mm_andnot_si128(_mm_loadu_si128((const __m128i*)layer), _mm_loadu_si128((const __m128i*)mask));
+	return _mm_movemask_epi8(_mm_cmpeq_epi32(value, _mm_setzero_si128())) != 0xFFFF;
+#else
+	return ((mask[0] & ~layer[0]) | (mask[1] & ~layer[1]) | (mask[2] & ~layer[2]) | (mask[3] & ~layer[3])) != 0;
+#endif
+}
+
+MaskedOcclusion::MaskedOcclusion(int width, int height)
+{
+	TileCountX = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+	TileCountY = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+	Width = TileCountX * TILE_WIDTH;
+	Height = TileCountY * TILE_HEIGHT;
+	TileList.resize(TileCountX * TileCountY);
+
+	BeginFrame(glm::mat4(1.0f));
+}
+
+void MaskedOcclusion::BeginFrame(const glm::mat4& viewProj)
+{
+	ViewProj = viewProj;
+	TriangleList.clear();
+
+	for (Tile& tile : TileList)
+	{
+		for (int i = 0; i < TILE_HEIGHT; i++)
+		{
+			tile.Mask[i] = 0;
+		}
+		tile.Far0 = FLT_MAX;
+		tile.Far1 = FLT_MAX;
+	}
+}
+
+void MaskedOcclusion::AddOccluder(const float* vertexData, int vertexCount, int stride, const glm::mat4& model)
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	glm::mat4 transform = ViewProj * model;
+	for (int i = 0; i + 2 < vertexCount; i += 3)
+	{
+		glm::vec4 clip[3];
+		for (int k = 0; k < 3; k++)
+		{
+			const float* position = vertexData + (i + k) * stride;
+			clip[k] = transform * glm::vec4(position[0], position[1], position[2], 1.0f);
+		}
+		AddClipTriangle(clip[0], clip[1], clip[2]);
+	}
+}
+
+void MaskedOcclusion::Rasterize()
+{
+	if (!bEnabled || TriangleList.empty())
+	{
+		return;
+	}
+
+	// 每个任务独占若干分块行, 全部三角形按相同顺序写入, 结果与线程数无关
+	int bandCount = (TileCountY + BAND_TILE_ROWS - 1) / BAND_TILE_ROWS;
+	ThreadPool::Get().ParallelFor(bandCount, [this](size_t band)
+	{
+		int tileRowBegin = (int)band * BAND_TILE_ROWS;
+		int tileRowEnd = std::min(tileRowBegin + BAND_TILE_ROWS, TileCountY);
+		int pixelBegin = tileRowBegin * TILE_HEIGHT;
+		int pixelEnd = tileRowEnd * TILE_HEIGHT - 1;
+
+		for (const Triangle& triangle : TriangleList)
+		{
+			if (triangle.MaxY >= pixelBegin && triangle.MinY <= pixelEnd)
+			{
+				RasterizeTriangle(triangle, tileRowBegin, tileRowEnd);
+			}
+		}
+	});
+}
+
+bool MaskedOcclusion::TestBox(const BoundingBox& box) const
+{
+	if (!bEnabled)
+	{
+		return true;
+	}
+
+	float minX = FLT_MAX;
+	float minY = FLT_MAX;
+	float maxX = -FLT_MAX;
+	float maxY = -FLT_MAX;
+	float nearest = FLT_MAX;
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner((i & 1) ? box.Max.x : box.Min.x, (i & 2) ? box.Max.y : box.Min.y, (i & 4) ? box.Max.z : box.Min.z);
+		glm::vec4 clip = ViewProj * glm::vec4(corner, 1.0f);
+		if (clip.z + clip.w <= 0.0f)
+		{
+			return true;
+		}
+
+		float invW = 1.0f / clip.w;
+		float x = (clip.x * invW * 0.5f + 0.5f) * Width;
+		float y = (clip.y * invW * 0.5f + 0.5f) * Height;
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+		nearest = std::min(nearest, clip.z * invW);
+	}
+
+	// 屏幕外的物体交由视锥剔除
+	if (maxX < 0.0f || maxY < 0.0f || minX >= (float)Width || minY >= (float)Height)
+	{
+		return true;
+	}
+	int x0 = (int)std::max(std::floor(minX), 0.0f);
+	int y0 = (int)std::max(std::floor(minY), 0.0f);
+	int x1 = (int)std::min(std::floor(maxX), (float)(Width - 1));
+	int y1 = (int)std::min(std::floor(maxY), (float)(Height - 1));
+
+	for (int tileY = y0 / TILE_HEIGHT; tileY <= y1 / TILE_HEIGHT; tileY++)
+	{
+		for (int tileX = x0 / TILE_WIDTH; tileX <= x1 / TILE_WIDTH; tileX++)
+		{
+			const Tile& tile = TileList[tileY * TileCountX + tileX];
+
+			// 整块的遮挡物都比物体近
+			if (nearest > tile.Far0)
+			{
+				continue;
+			}
+
+			uint32_t rect[TILE_HEIGHT];
+			for (int row = 0; row < TILE_HEIGHT; row++)
+			{
+				int y = tileY * TILE_HEIGHT + row;
+				rect[row] = (y >= y0 && y <= y1) ? SpanMask(x0 - tileX * TILE_WIDTH, x1 - tileX * TILE_WIDTH) : 0;
+			}
+
+			// 矩形内有只受参考层约束的像素, 或工作层也不比物体近
+			if (HasUncovered(rect, tile.Mask) || nearest <= tile.Far1)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+int MaskedOcclusion::Cull(const BVH& tree, std::vector<uint8_t>& visibleList) const
+{
+	int count = tree.GetCount();
+
+	if (bEnabled && !TriangleList.empty())
+	{
+		// 各任务只写入自己区间内的句柄
+		int chunkCount = (count + CULL_CHUNK_SIZE - 1) / CULL_CHUNK_SIZE;
+		ThreadPool::Get().ParallelFor(chunkCount, [&](size_t chunk)
+		{
+			int begin = (int)chunk * CULL_CHUNK_SIZE;
+			int end = std::min(begin + CULL_CHUNK_SIZE, count);
+			for (int handle = begin; handle < end; handle++)
+			{
+				if (visibleList[handle] && !TestBox(tree.GetBox(handle)))
+				{
+					visibleList[handle] = 0;
+				}
+			}
+		});
+	}
+
+	int visibleCount = 0;
+	for (int handle = 0; handle < count; handle++)
+	{
+		visibleCount += visibleList[handle];
+	}
+	return visibleCount;
+}
+
+int MaskedOcclusion::GetOccluderTriangleCount() const
+{
+	return (int)TriangleList.size();
+}
+
+void MaskedOcclusion::AddClipTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2)
+{
+	// 近平面为z = -w, 平面后的部分裁掉, 结果至多为四边形
+	const glm::vec4 input[3] = { v0, v1, v2 };
+	glm::vec4 output[4];
+	int count = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec4& a = input[i];
+		const glm::vec4& b = input[(i + 1) % 3];
+		float distanceA = a.z + a.w;
+		float distanceB = b.z + b.w;
+		if (distanceA >= 0.0f)
+		{
+			output[count++] = a;
+		}
+		if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+		{
+			output[count++] = a + (b - a) * (distanceA / (distanceA - distanceB));
+		}
+	}
+
+	for (int i = 1; i + 1 < count; i++)
+	{
+		SetupTriangle(output[0], output[i], output[i + 1]);
+	}
+}
+
+void MaskedOcclusion::SetupTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2)
+{
+	const glm::vec4* clip[3] = { &v0, &v1, &v2 };
+	glm::vec3 screen[3];
+	for (int k = 0; k < 3; k++)
+	{
+		if (clip[k]->w <= 0.0f)
+		{
+			return;
+		}
+		float invW = 1.0f / clip[k]->w;
+		screen[k] = glm::vec3((clip[k]->x * invW * 0.5f + 0.5f) * Width, (clip[k]->y * invW * 0.5f + 0.5f) * Height, clip[k]->z * invW);
+	}
+
+	// 统一为逆时针, 遮挡物不区分正反面
+	float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+	if (std::abs(area) < 1e-6f)
+	{
+		return;
+	}
+	if (area < 0.0f)
+	{
+		std::swap(screen[1], screen[2]);
+		area = -area;
+	}
+
+	float minX = std::min(screen[0].x, std::min(screen[1].x, screen[2].x));
+	float minY = std::min(screen[0].y, std::min(screen[1].y, screen[2].y));
+	float maxX = std::max(screen[0].x, std::max(screen[1].x, screen[2].x));
+	float maxY = std::max(screen[0].y, std::max(screen[1].y, screen[2].y));
+	if (maxX < 0.0f || maxY < 0.0f || minX >= (float)Width || minY >= (float)Height)
+	{
+		return;
+	}
+
+	Triangle triangle;
+	triangle.MinX = (int)std::max(std::floor(minX), 0.0f);
+	triangle.MinY = (int)std::max(std::floor(minY), 0.0f);
+	triangle.MaxX = (int)std::min(std::floor(maxX), (float)(Width - 1));
+	triangle.MaxY = (int)std::min(std::floor(maxY), (float)(Height - 1));
+
+	glm::vec3 edge1 = screen[1] - screen[0];
+	glm::vec3 edge2 = screen[2] - screen[0];
+	float depthX = (edge1.z * edge2.y - edge2.z * edge1.y) / area;
+	float depthY = (edge2.z * edge1.x - edge1.z * edge2.x) / area;
+	triangle.DepthPlane = glm::vec3(depthX, depthY, screen[0].z - depthX * screen[0].x - depthY * screen[0].y);
+	triangle.MaxDepth = std::max(screen[0].z, std::max(screen[1].z, screen[2].z));
+
+	for (int k = 0; k < 3; k++)
+	{
+		triangle.Pos[k] = glm::vec2(screen[k]);
+	}
+	TriangleList.push_back(triangle);
+}
+
+void MaskedOcclusion::RasterizeTriangle(const Triangle& triangle, int tileRowBegin, int tileRowEnd)
+{
+	int firstTileRow = std::max(triangle.MinY / TILE_HEIGHT, tileRowBegin);
+	int lastTileRow = std::min(triangle.MaxY / TILE_HEIGHT, tileRowEnd - 1);
+
+	for (int tileY = firstTileRow; tileY <= lastTileRow; tileY++)
+	{
+		// 各像素行中心处被三条边限定的区间, 边向下(dy < 0)时为左界, 向上时为右界
+		int left[TILE_HEIGHT];
+		int right[TILE_HEIGHT];
+		int spanMin = Width;
+		int spanMax = -1;
+		int rowMin = TILE_HEIGHT;
+		int rowMax = -1;
+		for (int row = 0; row < TILE_HEIGHT; row++)
+		{
+			int y = tileY * TILE_HEIGHT + row;
+			left[row] = 0;
+			right[row] = -1;
+			if (y < triangle.MinY || y > triangle.MaxY)
+			{
+				continue;
+			}
+
+			float centerY = y + 0.5f;
+			float leftX = -FLT_MAX;
+			float rightX = FLT_MAX;
+			bool bEmpty = false;
+			for (int k = 0; k < 3; k++)
+			{
+				const glm::vec2& a = triangle.Pos[k];
+				const glm::vec2& b = triangle.Pos[(k + 1) % 3];
+				float dx = b.x - a.x;
+				float dy = b.y - a.y;
+				if (dy == 0.0f)
+				{
+					bEmpty |= dx * (centerY - a.y) < 0.0f;
+					continue;
+				}
+
+				float x = a.x + dx * (centerY - a.y) / dy;
+				if (dy < 0.0f)
+				{
+					leftX = std::max(leftX, x);
+				}
+				else
+				{
+					rightX = std::min(rightX, x);
+				}
+			}
+			if (bEmpty)
+			{
+				continue;
+			}
+
+			// 像素中心在区间内才算覆盖
+			left[row] = (int)std::ceil(std::max(leftX - 0.5f, (float)triangle.MinX));
+			right[row] = (int)std::floor(std::min(rightX - 0.5f, (float)triangle.MaxX));
+			if (left[row] <= right[row])
+			{
+				spanMin = std::min(spanMin, left[row]);
+				spanMax = std::max(spanMax, right[row]);
+				rowMin = std::min(rowMin, row);
+				rowMax = std::max(rowMax, row);
+			}
+		}
+		if (spanMin > spanMax)
+		{
+			continue;
+		}
+
+		for (int tileX = spanMin / TILE_WIDTH; tileX <= spanMax / TILE_WIDTH; tileX++)
+		{
+			int tileLeft = tileX * TILE_WIDTH;
+
+			uint32_t mask[TILE_HEIGHT];
+			for (int row = 0; row < TILE_HEIGHT; row++)
+			{
+				mask[row] = SpanMask(left[row] - tileLeft, right[row] - tileLeft);
+			}
+			if (IsMaskEmpty(mask))
+			{
+				continue;
+			}
+
+			// 覆盖像素所在矩形四角处平面深度的最大值, 不超过顶点的最大深度
+			float x0 = (float)std::max(spanMin, tileLeft);
+			float x1 = (float)(std::min(spanMax, tileLeft + TILE_WIDTH - 1) + 1);
+			float y0 = (float)(tileY * TILE_HEIGHT + rowMin);
+			float y1 = (float)(tileY * TILE_HEIGHT + rowMax + 1);
+			float depth = triangle.DepthPlane.z + std::max(triangle.DepthPlane.x * x0, triangle.DepthPlane.x * x1) + std::max(triangle.DepthPlane.y * y0, triangle.DepthPlane.y * y1);
+			depth = std::min(depth, triangle.MaxDepth);
+
+			UpdateTile(TileList[tileY * TileCountX + tileX], mask, depth);
+		}
+	}
+}
+
+void MaskedOcclusion::UpdateTile(Tile& tile, const uint32_t* mask, float depth)
+{
+	// 不比参考层近, 无法改进
+	if (depth >= tile.Far0)
+	{
+		return;
+	}
+
+	// 整块被覆盖时直接成为参考层, 工作层不比它近时丢弃
+	if (IsMaskFull(mask))
+	{
+		tile.Far0 = depth;
+		if (tile.Far1 >= depth)
+		{
+			for (int i = 0; i < TILE_HEIGHT; i++)
+			{
+				tile.Mask[i] = 0;
+			}
+		}
+		return;
+	}
+
+	// 并入工作层, 深度取两者较远者
+	if (IsMaskEmpty(tile.Mask))
+	{
+		tile.Far1 = depth;
+	}
+	else
+	{
+		tile.Far1 = std::max(tile.Far1, depth);
+	}
+	MergeMask(tile.Mask, mask);
+
+	// 工作层铺满后成为参考层
+	if (IsMaskFull(tile.Mask))
+	{
+		tile.Far0 = tile.Far1;
+		for (int i = 0; i < TILE_HEIGHT; i++)
+		{
+			tile.Mask[i] = 0;
+		}
+	}
+}
@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+#include "BVH.h"
+
+// CPU遮挡剔除, 参照Intel的Masked Occlusion Culling:
+// 指定的遮挡物以低分辨率光栅化, 每个32x4像素的分块只存一个128位覆盖掩码及两个保守深度, 不存逐像素深度
+// 光栅化按分块行划分给线程池, 物体以包围盒的屏幕矩形及最近深度与分块比较; 不调用GL, 无GPU时同样可用
+class MaskedOcclusion
+{
+public:
+
+	// --no-soft-occlusion关闭, Cull不改变可见性
+	static bool bEnabled;
+
+	static const int TILE_WIDTH = 32;
+
+	static const int TILE_HEIGHT = 4;
+
+	// 每个线程任务负责的分块行数
+	static const int BAND_TILE_ROWS = 4;
+
+public:
+
+	// 宽高按分块大小向上取整, 与窗口比例不同时像素非正方形, 不影响结果
+	MaskedOcclusion(int width = 256, int height = 128);
+
+	// 清空深度并设置本帧的view-projection, 之后加入遮挡物
+	void BeginFrame(const glm::mat4& viewProj);
+
+	// 三角形列表, 每个顶点stride个float, 前三个为位置; 不区分正反面, 遮挡物需为实心或双面绘制
+	void AddOccluder(const float* vertexData, int vertexCount, int stride, const glm::mat4& model);
+
+	// 光栅化本帧全部遮挡物, 之后才可测试
+	void Rasterize();
+
+	// 包围盒可能可见时返回true, 与近平面相交时总为可见
+	bool TestBox(const BoundingBox& box) const;
+
+	// 只测试visibleList中为1的物体, 被遮挡的置0, 返回可见数; 接在BVH::Cull之后
+	int Cull(const BVH& tree, std::vector<uint8_t>& visibleList) const;
+
+	int GetOccluderTriangleCount() const;
+
+private:
+
+	// 深度为NDC z, 越大越远
+	// 分块内全部像素不远于Far0; Mask中的像素同时不远于Far1, Far1比Far0近
+	struct Tile {
+		uint32_t Mask[TILE_HEIGHT];
+		float Far0;
+		float Far1;
+	};
+
+	// 屏幕空间三角形, 顶点已按逆时针排列, 像素范围已限制在屏幕内
+	struct Triangle {
+		glm::vec2 Pos[3];
+		// z = x * DepthPlane.x + y * DepthPlane.y + DepthPlane.z
+		glm::vec3 DepthPlane;
+		float MaxDepth;
+		int MinX;
+		int MaxX;
+		int MinY;
+		int MaxY;
+	};
+
+	int Width;
+
+	int Height;
+
+	int TileCountX;
+
+	int TileCountY;
+
+	glm::mat4 ViewProj = glm::mat4(1.0f);
+
+	std::vector<Tile> TileList;
+
+	std::vector<Triangle> TriangleList;
+
+private:
+
+	// 裁剪空间三角形经近平面裁剪后加入TriangleList
+	void AddClipTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+
+	void SetupTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+
+	// 只写入分块行[tileRowBegin, tileRowEnd), 不同的行区间可并行
+	void RasterizeTriangle(const Triangle& triangle, int tileRowBegin, int tileRowEnd);
+
+	void UpdateTile(Tile& tile, const uint32_t* mask, float depth);
+};
@@ -6,21 +6,22 @@
 #include <iostream>
 
 #include "FrameBuffer.h"
+#include "GLStateCache.h"
 
 FrameBuffer::FrameBuffer(bool bAttachRBO, const float SCR_WIDTH, const float SCR_HEIGHT, GLenum ChannelType)
 {
 	// 创建帧缓冲对象并绑定
 	glGenFramebuffers(1, &FBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, FBO);
 
 	// 生成帧缓冲附加纹理
 	glGenTextures(1, &TexAttached);
 
-	glBindTexture(GL_TEXTURE_2D, TexAttached);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, TexAttached);
 	glTexImage2D(GL_TEXTURE_2D, 0, ChannelType, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0);
 
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, TexAttached, 0); // 将它附加到当前绑定的帧缓冲对象
 
@@ -43,23 +44,23 @@ FrameBuffer::FrameBuffer(bool bAttachRBO, const float SCR_WIDTH, const float SCR
 	}
 
 	// 解绑帧缓冲对象操作
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 FrameBuffer::FrameBuffer(bool bAttachRBO, int sampleNum, const float SCR_WIDTH, const float SCR_HEIGHT)
 {
 	// 创建帧缓冲对象并绑定
 	glGenFramebuffers(1, &FBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, FBO);
 
 	// 生成帧缓冲附加纹理
 	glGenTextures(1, &TexAttached);
 	// MSAA设置
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, TexAttached);
+	GLStateCache::BindTexture(GL_TEXTURE_2D_MULTISAMPLE, TexAttached);
 	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, sampleNum, GL_RGB, SCR_WIDTH, SCR_HEIGHT, GL_TRUE);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
 
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, TexAttached, 0); // 将它附加到当前绑定的帧缓冲对象
 
@@ -82,5 +83,5 @@ FrameBuffer::FrameBuffer(bool bAttachRBO, int sampleNum, const float SCR_WIDTH,
 		std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
 	}
 	// 解绑帧缓冲对象操作
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -1,13 +1,14 @@
 ﻿#include "GBuffer.h"
+#include "GLStateCache.h"
 
 GBuffer::GBuffer(float SCR_WIDTH, float SCR_HEIGHT)
 {
 	glGenFramebuffers(1, &ID);
-	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, ID);
 
 	// - 位置颜色缓冲, 16位精度
 	glGenTextures(1, &gPosition);
-	glBindTexture(GL_TEXTURE_2D, gPosition);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, gPosition);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -17,7 +18,7 @@ GBuffer::GBuffer(float SCR_WIDTH, float SCR_HEIGHT)
 
 	// - 法线颜色缓冲, 16位精度
 	glGenTextures(1, &gNormal);
-	glBindTexture(GL_TEXTURE_2D, gNormal);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, gNormal);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -25,7 +26,7 @@ GBuffer::GBuffer(float SCR_WIDTH, float SCR_HEIGHT)
 
 	// - 颜色 + 镜面颜色缓冲, 默认8位精度
 	glGenTextures(1, &gColorSpec);
-	glBindTexture(GL_TEXTURE_2D, gColorSpec);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, gColorSpec);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -50,17 +51,17 @@ GBuffer::GBuffer(float SCR_WIDTH, float SCR_HEIGHT)
 
 
 	// 解绑帧缓冲对象操作
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void GBuffer::ApplyBuffers()
 {
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, gPosition);
+	GLStateCache::ActiveTexture(GL_TEXTURE0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, gPosition);
 
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, gNormal);
+	GLStateCache::ActiveTexture(GL_TEXTURE1);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, gNormal);
 
-	glActiveTexture(GL_TEXTURE2);
-	glBindTexture(GL_TEXTURE_2D, gColorSpec);
+	GLStateCache::ActiveTexture(GL_TEXTURE2);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, gColorSpec);
 }
@@ -0,0 +1,267 @@
+﻿#include "GLStateCache.h"
+
+GLuint GLStateCache::Program = GLStateCache::UNKNOWN;
+GLuint GLStateCache::VertexArray = GLStateCache::UNKNOWN;
+GLuint GLStateCache::ActiveUnit = GLStateCache::UNKNOWN;
+GLuint GLStateCache::Textures[GLStateCache::MAX_TEXTURE_UNITS][GLStateCache::TEXTURE_TARGET_COUNT];
+GLuint GLStateCache::ReadFramebuffer = GLStateCache::UNKNOWN;
+GLuint GLStateCache::DrawFramebuffer = GLStateCache::UNKNOWN;
+GLint GLStateCache::ViewportRect[4] = { -1, -1, -1, -1 };
+GLuint GLStateCache::Capabilities[GLStateCache::CAP_COUNT];
+GLuint GLStateCache::DepthFuncValue = GLStateCache::UNKNOWN;
+GLuint GLStateCache::DepthMaskValue = GLStateCache::UNKNOWN;
+GLuint GLStateCache::BlendSrc = GLStateCache::UNKNOWN;
+GLuint GLStateCache::BlendDst = GLStateCache::UNKNOWN;
+GLuint GLStateCache::CullFaceMode = GLStateCache::UNKNOWN;
+unsigned int GLStateCache::SkippedCount = 0;
+
+void GLStateCache::Reset()
+{
+	Program = UNKNOWN;
+	VertexArray = UNKNOWN;
+	ActiveUnit = UNKNOWN;
+	for (int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+	{
+		for (int target = 0; target < TEXTURE_TARGET_COUNT; target++)
+		{
+			Textures[unit][target] = UNKNOWN;
+		}
+	}
+	ReadFramebuffer = UNKNOWN;
+	DrawFramebuffer = UNKNOWN;
+	for (int i = 0; i < 4; i++)
+	{
+		ViewportRect[i] = -1;
+	}
+	for (int i = 0; i < CAP_COUNT; i++)
+	{
+		Capabilities[i] = UNKNOWN;
+	}
+	DepthFuncValue = UNKNOWN;
+	DepthMaskValue = UNKNOWN;
+	BlendSrc = UNKNOWN;
+	BlendDst = UNKNOWN;
+	CullFaceMode = UNKNOWN;
+	SkippedCount = 0;
+}
+
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (Program == program)
+	{
+		SkippedCount++;
+		return;
+	}
+	glUseProgram(program);
+	Program = program;
+}
+
+void GLStateCache::DeleteProgram(GLuint program)
+{
+	// 删除正在使用的程序时驱动延后到切换后才真正删除, 名称复用前需重新设置
+	if (Program == program)
+	{
+		Program = UNKNOWN;
+	}
+	glDeleteProgram(program);
+}
+
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+	if (VertexArray == vao)
+	{
+		SkippedCount++;
+		return;
+	}
+	glBindVertexArray(vao);
+	VertexArray = vao;
+}
+
+void GLStateCache::DeleteVertexArray(GLuint vao)
+{
+	if (VertexArray == vao)
+	{
+		VertexArray = 0;
+	}
+	glDeleteVertexArrays(1, &vao);
+}
+
+void GLStateCache::ActiveTexture(GLenum unit)
+{
+	if (ActiveUnit == unit)
+	{
+		SkippedCount++;
+		return;
+	}
+	glActiveTexture(unit);
+	ActiveUnit = unit;
+}
+
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+	int targetIndex = GetTargetIndex(target);
+	GLuint unit = ActiveUnit - GL_TEXTURE0;
+	if (targetIndex < 0 || ActiveUnit == UNKNOWN || unit >= (GLuint)MAX_TEXTURE_UNITS)
+	{
+		glBindTexture(target, texture);
+		return;
+	}
+
+	if (Textures[unit][targetIndex] == texture)
+	{
+		SkippedCount++;
+		return;
+	}
+	glBindTexture(target, texture);
+	Textures[unit][targetIndex] = texture;
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	bool bRead = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+	bool bDraw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+	if ((!bRead || ReadFramebuffer == framebuffer) && (!bDraw || DrawFramebuffer == framebuffer))
+	{
+		SkippedCount++;
+		return;
+	}
+
+	glBindFramebuffer(target, framebuffer);
+	if (bRead)
+	{
+		ReadFramebuffer = framebuffer;
+	}
+	if (bDraw)
+	{
+		DrawFramebuffer = framebuffer;
+	}
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if (ViewportRect[0] == x && ViewportRect[1] == y && ViewportRect[2] == width && ViewportRect[3] == height)
+	{
+		SkippedCount++;
+		return;
+	}
+	glViewport(x, y, width, height);
+	ViewportRect[0] = x;
+	ViewportRect[1] = y;
+	ViewportRect[2] = width;
+	ViewportRect[3] = height;
+}
+
+void GLStateCache::Enable(GLenum cap)
+{
+	SetCapability(cap, true);
+}
+
+void GLStateCache::Disable(GLenum cap)
+{
+	SetCapability(cap, false);
+}
+
+void GLStateCache::DepthFunc(GLenum func)
+{
+	if (DepthFuncValue == func)
+	{
+		SkippedCount++;
+		return;
+	}
+	glDepthFunc(func);
+	DepthFuncValue = func;
+}
+
+void GLStateCache::DepthMask(GLboolean flag)
+{
+	if (DepthMaskValue == flag)
+	{
+		SkippedCount++;
+		return;
+	}
+	glDepthMask(flag);
+	DepthMaskValue = flag;
+}
+
+void GLStateCache::BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (BlendSrc == sfactor && BlendDst == dfactor)
+	{
+		SkippedCount++;
+		return;
+	}
+	glBlendFunc(sfactor, dfactor);
+	BlendSrc = sfactor;
+	BlendDst = dfactor;
+}
+
+void GLStateCache::CullFace(GLenum mode)
+{
+	if (CullFaceMode == mode)
+	{
+		SkippedCount++;
+		return;
+	}
+	glCullFace(mode);
+	CullFaceMode = mode;
+}
+
+unsigned int GLStateCache::GetSkippedCount()
+{
+	return SkippedCount;
+}
+
+int GLStateCache::GetTargetIndex(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D:
+		return TEXTURE_TARGET_2D;
+	case GL_TEXTURE_CUBE_MAP:
+		return TEXTURE_TARGET_CUBE_MAP;
+	case GL_TEXTURE_2D_MULTISAMPLE:
+		return TEXTURE_TARGET_2D_MULTISAMPLE;
+	default:
+		return -1;
+	}
+}
+
+int GLStateCache::GetCapabilityIndex(GLenum cap)
+{
+	switch (cap)
+	{
+	case GL_DEPTH_TEST:
+		return CAP_DEPTH_TEST;
+	case GL_BLEND:
+		return CAP_BLEND;
+	case GL_CULL_FACE:
+		return CAP_CULL_FACE;
+	default:
+		return -1;
+	}
+}
+
+void GLStateCache::SetCapability(GLenum cap, bool bEnable)
+{
+	int index = GetCapabilityIndex(cap);
+	GLuint value = bEnable ? 1 : 0;
+	if (index >= 0 && Capabilities[index] == value)
+	{
+		SkippedCount++;
+		return;
+	}
+
+	if (bEnable)
+	{
+		glEnable(cap);
+	}
+	else
+	{
+		glDisable(cap);
+	}
+
+	if (index >= 0)
+	{
+		Capabilities[index] = value;
+	}
+}
@@ -0,0 +1,110 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+
+// GL状态的影子副本, 与当前值相同的设置不再转发给驱动
+// 参数与同名GL函数一致, 渲染代码中的绑定及状态设置均经由此处, 直接调用GL会使记录失效
+// 记录属于当前上下文, 上下文创建后Reset; 未知状态的首次设置总会转发
+class GLStateCache
+{
+public:
+
+	static const int MAX_TEXTURE_UNITS = 32;
+
+public:
+
+	// 全部记录置为未知
+	static void Reset();
+
+	static void UseProgram(GLuint program);
+
+	// 删除当前程序时清除记录, 名称可能被新程序复用
+	static void DeleteProgram(GLuint program);
+
+	static void BindVertexArray(GLuint vao);
+
+	// 删除已绑定的VAO时驱动解绑为0
+	static void DeleteVertexArray(GLuint vao);
+
+	static void ActiveTexture(GLenum unit);
+
+	// 绑定至当前活动单元; 2D, CUBE_MAP及2D_MULTISAMPLE之外的目标直接转发
+	static void BindTexture(GLenum target, GLuint texture);
+
+	// GL_FRAMEBUFFER同时设置读及写
+	static void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+	static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	// 记录GL_DEPTH_TEST, GL_BLEND及GL_CULL_FACE, 其余直接转发
+	static void Enable(GLenum cap);
+
+	static void Disable(GLenum cap);
+
+	static void DepthFunc(GLenum func);
+
+	static void DepthMask(GLboolean flag);
+
+	static void BlendFunc(GLenum sfactor, GLenum dfactor);
+
+	static void CullFace(GLenum mode);
+
+	// 被省略的调用数, 自上次Reset起
+	static unsigned int GetSkippedCount();
+
+private:
+
+	enum ETextureTarget {
+		TEXTURE_TARGET_2D,
+		TEXTURE_TARGET_CUBE_MAP,
+		TEXTURE_TARGET_2D_MULTISAMPLE,
+		TEXTURE_TARGET_COUNT
+	};
+
+	enum ECapability {
+		CAP_DEPTH_TEST,
+		CAP_BLEND,
+		CAP_CULL_FACE,
+		CAP_COUNT
+	};
+
+	// 未知状态, 任何GL名称或枚举均不等于此值
+	static const GLuint UNKNOWN = ~0u;
+
+	static GLuint Program;
+
+	static GLuint VertexArray;
+
+	static GLuint ActiveUnit;
+
+	static GLuint Textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+
+	static GLuint ReadFramebuffer;
+
+	static GLuint DrawFramebuffer;
+
+	static GLint ViewportRect[4];
+
+	// 0关闭, 1开启, UNKNOWN未知
+	static GLuint Capabilities[CAP_COUNT];
+
+	static GLuint DepthFuncValue;
+
+	static GLuint DepthMaskValue;
+
+	static GLuint BlendSrc;
+
+	static GLuint BlendDst;
+
+	static GLuint CullFaceMode;
+
+	static unsigned int SkippedCount;
+
+private:
+
+	static int GetTargetIndex(GLenum target);
+
+	static int GetCapabilityIndex(GLenum cap);
+
+	static void SetCapability(GLenum cap, bool bEnable);
+};
@@ -0,0 +1,97 @@
+﻿#include "Material.h"
+#include "GLStateCache.h"
+
+static const std::string MATERIAL_PREFIX = "material.";
+
+void Material::AddTexture(const std::string& samplerName, GLuint texture, GLenum target)
+{
+	MaterialTexture materialTexture;
+	materialTexture.SamplerName = samplerName;
+	materialTexture.Target = target;
+	materialTexture.TextureID = texture;
+	TextureList.push_back(materialTexture);
+
+	// 已解析的表不含新纹理, 重新解析
+	TableList.clear();
+	LastTable = 0;
+}
+
+void Material::AddTypedTexture(const std::string& type, GLuint texture)
+{
+	int number = 1;
+	bool bFound = false;
+	for (auto& typeCount : TypeCountList)
+	{
+		if (typeCount.first == type)
+		{
+			number = ++typeCount.second;
+			bFound = true;
+			break;
+		}
+	}
+	if (!bFound)
+	{
+		TypeCountList.push_back(std::make_pair(type, 1));
+	}
+
+	AddTexture(MATERIAL_PREFIX + type + std::to_string(number), texture);
+}
+
+void Material::Bind(Shader* shader)
+{
+	const BindingTable& table = GetTable(shader);
+
+	for (size_t i = 0; i < TextureList.size(); i++)
+	{
+		if (table.UnitList[i] >= 0)
+		{
+			GLStateCache::ActiveTexture(GL_TEXTURE0 + table.UnitList[i]);
+			GLStateCache::BindTexture(TextureList[i].Target, TextureList[i].TextureID);
+		}
+	}
+
+	// 调用方可能默认单元0为活动单元
+	GLStateCache::ActiveTexture(GL_TEXTURE0);
+}
+
+int Material::GetTextureCount() const
+{
+	return (int)TextureList.size();
+}
+
+const Material::BindingTable& Material::GetTable(Shader* shader)
+{
+	if (LastTable < TableList.size() && TableList[LastTable].Program == shader && TableList[LastTable].ProgramID == shader->ID)
+	{
+		return TableList[LastTable];
+	}
+
+	for (size_t i = 0; i < TableList.size(); i++)
+	{
+		// 程序ID一并比较, 地址被新Shader复用时重新解析
+		if (TableList[i].Program == shader && TableList[i].ProgramID == shader->ID)
+		{
+			LastTable = i;
+			return TableList[i];
+		}
+	}
+
+	BindingTable table;
+	table.Program = shader;
+	table.UnitList.reserve(TextureList.size());
+	for (const MaterialTexture& texture : TextureList)
+	{
+		int unit = shader->ResolveSamplerUnit(texture.SamplerName);
+		if (unit < 0 && texture.SamplerName.compare(0, MATERIAL_PREFIX.size(), MATERIAL_PREFIX) == 0)
+		{
+			unit = shader->ResolveSamplerUnit(texture.SamplerName.substr(MATERIAL_PREFIX.size()));
+		}
+		table.UnitList.push_back(unit);
+	}
+	// 解析会等待编译完成, 之后ID才确定
+	table.ProgramID = shader->ID;
+
+	TableList.push_back(table);
+	LastTable = TableList.size() - 1;
+	return TableList[LastTable];
+}
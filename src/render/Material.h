@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+
+// 一组按sampler名引用的纹理, 可由多个网格共用, RenderQueue按材质排序
+// 首次绑定到某个Shader时解析各sampler的纹理单元(Shader::ResolveSamplerUnit)并记录,
+// 之后每次绑定只按表绑定纹理, 不再查找uniform及设置sampler
+class Material
+{
+public:
+
+	// samplerName以"material."开头而shader中不存在时, 退回去掉前缀的名称
+	void AddTexture(const std::string& samplerName, GLuint texture, GLenum target = GL_TEXTURE_2D);
+
+	// 按Model.fs的约定命名, type如texture_diffuse, 同类型依次编号为material.texture_diffuse1, 2...
+	void AddTypedTexture(const std::string& type, GLuint texture);
+
+	// shader需为即将绘制所用的程序
+	void Bind(Shader* shader);
+
+	int GetTextureCount() const;
+
+private:
+
+	struct MaterialTexture {
+		std::string SamplerName;
+		GLenum Target;
+		GLuint TextureID;
+	};
+
+	// 一个程序的解析结果, UnitList与TextureList一一对应, -1为程序中不存在的sampler
+	struct BindingTable {
+		const Shader* Program;
+		GLuint ProgramID;
+		std::vector<int> UnitList;
+	};
+
+	std::vector<MaterialTexture> TextureList;
+
+	std::vector<BindingTable> TableList;
+
+	// 最近使用的绑定表, 相邻绘制通常使用同一程序
+	size_t LastTable = 0;
+
+	// 每种类型已加入的数量, 用于编号
+	std::vector<std::pair<std::string, int>> TypeCountList;
+
+private:
+
+	const BindingTable& GetTable(Shader* shader);
+};
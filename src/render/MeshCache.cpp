@@ -0,0 +1,417 @@
+﻿#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "MeshCache.h"
+
+bool MeshCache::bEnabled = true;
+std::string MeshCache::CacheDir = "mesh_cache";
+int MeshCache::HitCount = 0;
+int MeshCache::MissCount = 0;
+
+// 缓存文件头, 格式或导入参数变更时递增Version
+static const uint32_t CACHE_MAGIC = 0x434d5253; // "SRMC"
+static const uint32_t CACHE_VERSION = 2;
+
+// 数据块按16字节对齐, 映射后可直接作为顶点/索引数组读取
+static const uint64_t BLOB_ALIGN = 16;
+
+// 文件布局: CacheHeader, MeshEntry[MeshCount], MaterialEntry[MaterialCount], TextureEntry[TextureCount], 顶点及索引数据块
+struct CacheHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t VertexSize;
+	uint32_t MeshCount;
+	uint32_t MaterialCount;
+	uint32_t TextureCount;
+	uint64_t SourceSize;
+	int64_t SourceTime;
+};
+
+struct MeshEntry {
+	uint64_t VertexOffset;
+	uint64_t IndexOffset;
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t MaterialIndex;
+	float BoundsMin[3];
+	float BoundsMax[3];
+	uint32_t IndexSize;
+};
+
+struct MaterialEntry {
+	uint32_t FirstTexture;
+	uint32_t TextureCount;
+};
+
+struct TextureEntry {
+	char Type[32];
+	char Path[224];
+};
+
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex must stay tightly packed for the mesh cache");
+
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	FileHandle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		return;
+	}
+	MappingHandle = mapping;
+
+	Data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	Size = Data ? (size_t)size.QuadPart : 0;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			Data = (const char*)data;
+			Size = info.st_size;
+		}
+	}
+
+	// 映射建立后文件描述符可立即关闭
+	close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (Data)
+	{
+		UnmapViewOfFile(Data);
+	}
+	if (MappingHandle)
+	{
+		CloseHandle(MappingHandle);
+	}
+	if (FileHandle)
+	{
+		CloseHandle(FileHandle);
+	}
+#else
+	if (Data)
+	{
+		munmap((void*)Data, Size);
+	}
+#endif
+}
+
+
+static bool GetSourceInfo(const std::string& path, uint64_t& size, int64_t& time)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+	{
+		return false;
+	}
+
+	size = (uint64_t)info.st_size;
+	time = (int64_t)info.st_mtime;
+	return true;
+}
+
+// [offset, offset + size)位于文件内
+static bool InRange(const MappedFile& file, uint64_t offset, uint64_t size)
+{
+	return offset <= file.Size && size <= file.Size - offset;
+}
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+	return (offset + BLOB_ALIGN - 1) & ~(BLOB_ALIGN - 1);
+}
+
+static void CopyName(char* dest, size_t destSize, const std::string& src)
+{
+	size_t length = src.size() < destSize - 1 ? src.size() : destSize - 1;
+	memcpy(dest, src.data(), length);
+	memset(dest + length, 0, destSize - length);
+}
+
+bool MeshCache::Load(const std::string& sourcePath, std::unique_ptr<MappedFile>& file, std::vector<MeshCacheMesh>& meshList, std::vector<MeshCacheMaterial>& materialList)
+{
+	if (!bEnabled)
+	{
+		return false;
+	}
+
+	uint64_t sourceSize = 0;
+	int64_t sourceTime = 0;
+	if (!GetSourceInfo(sourcePath, sourceSize, sourceTime))
+	{
+		return false;
+	}
+
+	file.reset(new MappedFile(GetCachePath(sourcePath)));
+	if (!file->Data || file->Size < sizeof(CacheHeader))
+	{
+		file.reset();
+		MissCount++;
+		return false;
+	}
+
+	CacheHeader header;
+	memcpy(&header, file->Data, sizeof(header));
+	if (header.Magic != CACHE_MAGIC || header.Version != CACHE_VERSION || header.VertexSize != sizeof(Vertex)
+		|| header.SourceSize != sourceSize || header.SourceTime != sourceTime)
+	{
+		// 源文件已修改, 重新导入后覆盖
+		file.reset();
+		MissCount++;
+		return false;
+	}
+
+	uint64_t meshOffset = sizeof(CacheHeader);
+	uint64_t materialOffset = meshOffset + (uint64_t)header.MeshCount * sizeof(MeshEntry);
+	uint64_t textureOffset = materialOffset + (uint64_t)header.MaterialCount * sizeof(MaterialEntry);
+	if (!InRange(*file, textureOffset, (uint64_t)header.TextureCount * sizeof(TextureEntry)))
+	{
+		file.reset();
+		MissCount++;
+		return false;
+	}
+
+	const MeshEntry* meshEntryList = (const MeshEntry*)(file->Data + meshOffset);
+	const MaterialEntry* materialEntryList = (const MaterialEntry*)(file->Data + materialOffset);
+	const TextureEntry* textureEntryList = (const TextureEntry*)(file->Data + textureOffset);
+
+	meshList.clear();
+	materialList.clear();
+
+	for (uint32_t i = 0; i < header.MeshCount; i++)
+	{
+		const MeshEntry& entry = meshEntryList[i];
+		if (!InRange(*file, entry.VertexOffset, (uint64_t)entry.VertexCount * sizeof(Vertex))
+			|| (entry.IndexSize != sizeof(uint16_t) && entry.IndexSize != sizeof(uint32_t))
+			|| !InRange(*file, entry.IndexOffset, (uint64_t)entry.IndexCount * entry.IndexSize)
+			|| entry.MaterialIndex >= header.MaterialCount)
+		{
+			file.reset();
+			MissCount++;
+			return false;
+		}
+
+		MeshCacheMesh mesh;
+		mesh.VertexData = (const Vertex*)(file->Data + entry.VertexOffset);
+		mesh.VertexCount = entry.VertexCount;
+		mesh.IndexData = file->Data + entry.IndexOffset;
+		mesh.IndexCount = entry.IndexCount;
+		mesh.IndexSize = entry.IndexSize;
+		mesh.MaterialIndex = entry.MaterialIndex;
+		mesh.BoundsMin = glm::vec3(entry.BoundsMin[0], entry.BoundsMin[1], entry.BoundsMin[2]);
+		mesh.BoundsMax = glm::vec3(entry.BoundsMax[0], entry.BoundsMax[1], entry.BoundsMax[2]);
+		meshList.push_back(mesh);
+	}
+
+	for (uint32_t i = 0; i < header.MaterialCount; i++)
+	{
+		const MaterialEntry& entry = materialEntryList[i];
+		if (entry.FirstTexture > header.TextureCount || entry.TextureCount > header.TextureCount - entry.FirstTexture)
+		{
+			file.reset();
+			MissCount++;
+			return false;
+		}
+
+		MeshCacheMaterial material;
+		for (uint32_t t = 0; t < entry.TextureCount; t++)
+		{
+			const TextureEntry& texEntry = textureEntryList[entry.FirstTexture + t];
+
+			MeshCacheTexture texture;
+			texture.Type.assign(texEntry.Type, strnlen(texEntry.Type, sizeof(texEntry.Type)));
+			texture.Path.assign(texEntry.Path, strnlen(texEntry.Path, sizeof(texEntry.Path)));
+			material.TextureList.push_back(texture);
+		}
+		materialList.push_back(material);
+	}
+
+	HitCount++;
+	return true;
+}
+
+void MeshCache::Save(const std::string& sourcePath, const std::vector<MeshCacheMesh>& meshList, const std::vector<MeshCacheMaterial>& materialList)
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	CacheHeader header;
+	header.Magic = CACHE_MAGIC;
+	header.Version = CACHE_VERSION;
+	header.VertexSize = sizeof(Vertex);
+	header.MeshCount = (uint32_t)meshList.size();
+	header.MaterialCount = (uint32_t)materialList.size();
+	header.TextureCount = 0;
+	if (!GetSourceInfo(sourcePath, header.SourceSize, header.SourceTime))
+	{
+		return;
+	}
+
+	std::vector<MaterialEntry> materialEntryList;
+	std::vector<TextureEntry> textureEntryList;
+	for (const MeshCacheMaterial& material : materialList)
+	{
+		MaterialEntry entry;
+		entry.FirstTexture = (uint32_t)textureEntryList.size();
+		entry.TextureCount = (uint32_t)material.TextureList.size();
+		materialEntryList.push_back(entry);
+
+		for (const MeshCacheTexture& texture : material.TextureList)
+		{
+			if (texture.Path.size() >= sizeof(TextureEntry::Path))
+			{
+				std::cout << "ERROR::MESH_CACHE::Texture path too long: " << texture.Path << std::endl;
+				return;
+			}
+
+			TextureEntry texEntry;
+			CopyName(texEntry.Type, sizeof(texEntry.Type), texture.Type);
+			CopyName(texEntry.Path, sizeof(texEntry.Path), texture.Path);
+			textureEntryList.push_back(texEntry);
+		}
+	}
+	header.TextureCount = (uint32_t)textureEntryList.size();
+
+	// 先排布数据块偏移, 顶点与索引交替存放, 上传时按网格顺序读取
+	uint64_t offset = sizeof(CacheHeader) + meshList.size() * sizeof(MeshEntry)
+		+ materialEntryList.size() * sizeof(MaterialEntry) + textureEntryList.size() * sizeof(TextureEntry);
+
+	std::vector<MeshEntry> meshEntryList;
+	for (const MeshCacheMesh& mesh : meshList)
+	{
+		MeshEntry entry;
+		memset(&entry, 0, sizeof(entry));
+
+		offset = AlignOffset(offset);
+		entry.VertexOffset = offset;
+		entry.VertexCount = mesh.VertexCount;
+		offset += (uint64_t)mesh.VertexCount * sizeof(Vertex);
+
+		offset = AlignOffset(offset);
+		entry.IndexOffset = offset;
+		entry.IndexCount = mesh.IndexCount;
+		entry.IndexSize = mesh.IndexSize;
+		offset += (uint64_t)mesh.IndexCount * mesh.IndexSize;
+
+		entry.MaterialIndex = mesh.MaterialIndex;
+		for (int i = 0; i < 3; i++)
+		{
+			entry.BoundsMin[i] = mesh.BoundsMin[i];
+			entry.BoundsMax[i] = mesh.BoundsMax[i];
+		}
+		meshEntryList.push_back(entry);
+	}
+
+#ifdef _WIN32
+	_mkdir(CacheDir.c_str());
+#else
+	mkdir(CacheDir.c_str(), 0755);
+#endif
+
+	// 先写临时文件再改名, 避免中断时留下不完整的缓存
+	std::string path = GetCachePath(sourcePath);
+	std::string tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary);
+		if (!file.is_open())
+		{
+			std::cout << "ERROR::MESH_CACHE::Failed to write: " << tempPath << std::endl;
+			return;
+		}
+
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)meshEntryList.data(), meshEntryList.size() * sizeof(MeshEntry));
+		file.write((const char*)materialEntryList.data(), materialEntryList.size() * sizeof(MaterialEntry));
+		file.write((const char*)textureEntryList.data(), textureEntryList.size() * sizeof(TextureEntry));
+
+		static const char padding[BLOB_ALIGN] = {};
+		for (size_t i = 0; i < meshList.size(); i++)
+		{
+			const MeshCacheMesh& mesh = meshList[i];
+			const MeshEntry& entry = meshEntryList[i];
+
+			file.write(padding, entry.VertexOffset - (uint64_t)file.tellp());
+			file.write((const char*)mesh.VertexData, (uint64_t)mesh.VertexCount * sizeof(Vertex));
+			file.write(padding, entry.IndexOffset - (uint64_t)file.tellp());
+			file.write((const char*)mesh.IndexData, (uint64_t)mesh.IndexCount * mesh.IndexSize);
+		}
+
+		if (!file)
+		{
+			std::cout << "ERROR::MESH_CACHE::Failed to write: " << tempPath << std::endl;
+			return;
+		}
+	}
+
+	std::remove(path.c_str());
+	if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		std::cout << "ERROR::MESH_CACHE::Failed to write: " << path << std::endl;
+		std::remove(tempPath.c_str());
+	}
+}
+
+void MeshCache::PrintStats()
+{
+	if (bEnabled && HitCount + MissCount > 0)
+	{
+		std::cout << "Mesh cache: " << HitCount << " hit, " << MissCount << " miss" << std::endl;
+	}
+}
+
+std::string MeshCache::GetCachePath(const std::string& sourcePath)
+{
+	// 按源路径哈希命名, 不同模型互不覆盖
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : sourcePath)
+	{
+		hash ^= (unsigned char)c;
+		hash *= 1099511628211ull;
+	}
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+	return CacheDir + "/" + name + ".mesh";
+}
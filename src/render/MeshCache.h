@@ -0,0 +1,87 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "MeshRender.h"
+
+// 只读内存映射文件, 映射失败时Data为nullptr
+class MappedFile
+{
+public:
+
+	const char* Data = nullptr;
+
+	size_t Size = 0;
+
+public:
+
+	MappedFile(const std::string& path);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+
+#ifdef _WIN32
+	void* FileHandle = nullptr;
+
+	void* MappingHandle = nullptr;
+#endif
+};
+
+// 单个网格, 顶点及索引指向导入结果或映射文件内部
+struct MeshCacheMesh {
+	const Vertex* VertexData = nullptr;
+	uint32_t VertexCount = 0;
+	const void* IndexData = nullptr;
+	uint32_t IndexCount = 0;
+	uint32_t IndexSize = sizeof(unsigned int); // 2或4字节
+	uint32_t MaterialIndex = 0;
+	glm::vec3 BoundsMin = glm::vec3(0.0f);
+	glm::vec3 BoundsMax = glm::vec3(0.0f);
+};
+
+struct MeshCacheTexture {
+	std::string Type; // texture_diffuse等, 对应MeshRender::Draw中的采样器名
+	std::string Path; // 相对模型目录
+};
+
+struct MeshCacheMaterial {
+	std::vector<MeshCacheTexture> TextureList;
+};
+
+// 模型网格的二进制缓存, 首次经Assimp导入后写入, 之后映射文件直接上传
+// 文件头记录源文件大小及修改时间, 不一致时视为失效并重新导入
+class MeshCache
+{
+public:
+
+	// --no-mesh-cache关闭
+	static bool bEnabled;
+
+	static std::string CacheDir;
+
+	static int HitCount;
+
+	static int MissCount;
+
+public:
+
+	// 成功时meshList的数据指针指向file, 上传完成前file需保持映射
+	static bool Load(const std::string& sourcePath, std::unique_ptr<MappedFile>& file, std::vector<MeshCacheMesh>& meshList, std::vector<MeshCacheMaterial>& materialList);
+
+	static void Save(const std::string& sourcePath, const std::vector<MeshCacheMesh>& meshList, const std::vector<MeshCacheMaterial>& materialList);
+
+	static void PrintStats();
+
+private:
+
+	static std::string GetCachePath(const std::string& sourcePath);
+};
@@ -0,0 +1,351 @@
+﻿#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "MeshOptimizer.h"
+
+float MeshOptimizeStats::GetAcmrBefore() const
+{
+	return TriangleCount > 0 ? (float)TransformBefore / TriangleCount : 0.0f;
+}
+
+float MeshOptimizeStats::GetAcmrAfter() const
+{
+	return TriangleCount > 0 ? (float)TransformAfter / TriangleCount : 0.0f;
+}
+
+void MeshOptimizeStats::Add(const MeshOptimizeStats& other)
+{
+	VertexCountBefore += other.VertexCountBefore;
+	VertexCountAfter += other.VertexCountAfter;
+	TriangleCount += other.TriangleCount;
+	TransformBefore += other.TransformBefore;
+	TransformAfter += other.TransformAfter;
+}
+
+
+MeshOptimizeStats MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	MeshOptimizeStats stats;
+	stats.VertexCountBefore = (unsigned int)vertices.size();
+	stats.TriangleCount = (unsigned int)(indices.size() / 3);
+	stats.TransformBefore = SimulateCache(indices, vertices.size());
+
+	// 非三角形列表(如点或线)保持原样
+	if (indices.empty() || indices.size() % 3 != 0)
+	{
+		stats.VertexCountAfter = stats.VertexCountBefore;
+		stats.TransformAfter = stats.TransformBefore;
+		return stats;
+	}
+
+	WeldVertices(vertices, indices);
+
+	std::vector<unsigned int> clusterList;
+	OptimizeVertexCache(indices, vertices.size(), clusterList);
+	OptimizeOverdraw(indices, vertices, clusterList);
+	OptimizeVertexFetch(vertices, indices);
+
+	stats.VertexCountAfter = (unsigned int)vertices.size();
+	stats.TransformAfter = SimulateCache(indices, vertices.size());
+	return stats;
+}
+
+// 按字节比较及哈希, Vertex无填充字节
+struct VertexHash {
+	size_t operator()(const Vertex& vertex) const
+	{
+		const unsigned char* data = (const unsigned char*)&vertex;
+		size_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < sizeof(Vertex); i++)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+};
+
+struct VertexEqual {
+	bool operator()(const Vertex& a, const Vertex& b) const
+	{
+		return memcmp(&a, &b, sizeof(Vertex)) == 0;
+	}
+};
+
+void MeshOptimizer::WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	std::unordered_map<Vertex, unsigned int, VertexHash, VertexEqual> vertexMap;
+	vertexMap.reserve(vertices.size());
+
+	std::vector<unsigned int> remap(vertices.size());
+	std::vector<Vertex> weldList;
+	weldList.reserve(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		auto result = vertexMap.emplace(vertices[i], (unsigned int)weldList.size());
+		if (result.second)
+		{
+			weldList.push_back(vertices[i]);
+		}
+		remap[i] = result.first->second;
+	}
+
+	for (unsigned int& index : indices)
+	{
+		index = remap[index];
+	}
+	vertices.swap(weldList);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>& clusterList)
+{
+	size_t triangleCount = indices.size() / 3;
+	clusterList.clear();
+
+	// 顶点到三角形的邻接表, offsetList[v]起共liveCount[v]项
+	std::vector<unsigned int> liveCount(vertexCount, 0);
+	for (unsigned int index : indices)
+	{
+		liveCount[index]++;
+	}
+
+	std::vector<unsigned int> offsetList(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		offsetList[v + 1] = offsetList[v] + liveCount[v];
+	}
+
+	std::vector<unsigned int> adjacency(indices.size());
+	std::vector<unsigned int> fillList(offsetList.begin(), offsetList.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			adjacency[fillList[indices[t * 3 + k]]++] = (unsigned int)t;
+		}
+	}
+
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned int> deadEndStack;
+	std::vector<unsigned int> candidateList;
+	std::vector<unsigned int> output;
+	output.reserve(indices.size());
+
+	unsigned int time = CACHE_SIZE + 1;
+	size_t cursor = 0;
+	int fanning = 0;
+
+	// 从第一个被引用的顶点开始
+	while (cursor < vertexCount && liveCount[cursor] == 0)
+	{
+		cursor++;
+	}
+	fanning = cursor < vertexCount ? (int)cursor : -1;
+	bool bNewCluster = true;
+
+	while (fanning >= 0)
+	{
+		if (bNewCluster)
+		{
+			clusterList.push_back((unsigned int)(output.size() / 3));
+			bNewCluster = false;
+		}
+
+		// 输出fanning顶点周围所有未输出的三角形
+		candidateList.clear();
+		for (unsigned int a = offsetList[fanning]; a < offsetList[fanning + 1]; a++)
+		{
+			unsigned int t = adjacency[a];
+			if (emitted[t])
+			{
+				continue;
+			}
+
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = indices[t * 3 + k];
+				output.push_back(v);
+				deadEndStack.push_back(v);
+				candidateList.push_back(v);
+				liveCount[v]--;
+				if (time - cacheTime[v] > CACHE_SIZE)
+				{
+					cacheTime[v] = time++;
+				}
+			}
+			emitted[t] = true;
+		}
+
+		// 在一环邻域中选择仍在缓存内且剩余三角形最多的顶点
+		int next = -1;
+		int bestPriority = -1;
+		for (unsigned int v : candidateList)
+		{
+			if (liveCount[v] == 0)
+			{
+				continue;
+			}
+
+			int priority = 0;
+			if (time - cacheTime[v] + 2 * liveCount[v] <= CACHE_SIZE)
+			{
+				priority = time - cacheTime[v];
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = (int)v;
+			}
+		}
+
+		if (next < 0)
+		{
+			// 死端: 先回溯最近输出的顶点, 再按顺序扫描, 此处局部性中断, 作为簇边界
+			bNewCluster = true;
+			while (!deadEndStack.empty() && next < 0)
+			{
+				unsigned int v = deadEndStack.back();
+				deadEndStack.pop_back();
+				if (liveCount[v] > 0)
+				{
+					next = (int)v;
+				}
+			}
+			while (cursor < vertexCount && next < 0)
+			{
+				if (liveCount[cursor] > 0)
+				{
+					next = (int)cursor;
+				}
+				cursor++;
+			}
+		}
+
+		fanning = next;
+	}
+
+	indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& clusterList)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (clusterList.size() < 2)
+	{
+		return;
+	}
+
+	// 按面积加权的网格中心
+	std::vector<glm::vec3> centroidList(clusterList.size(), glm::vec3(0.0f));
+	std::vector<glm::vec3> normalList(clusterList.size(), glm::vec3(0.0f));
+	std::vector<float> areaList(clusterList.size(), 0.0f);
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (size_t c = 0; c < clusterList.size(); c++)
+	{
+		size_t end = c + 1 < clusterList.size() ? clusterList[c + 1] : triangleCount;
+		for (size_t t = clusterList[c]; t < end; t++)
+		{
+			const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+			const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+			const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+
+			centroidList[c] += center * area;
+			normalList[c] += normal;
+			areaList[c] += area;
+		}
+
+		meshCentroid += centroidList[c];
+		meshArea += areaList[c];
+		if (areaList[c] > 0.0f)
+		{
+			centroidList[c] /= areaList[c];
+		}
+	}
+	if (meshArea > 0.0f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	// 簇中心相对网格中心沿簇法线的距离, 越大越靠外
+	std::vector<float> sortKey(clusterList.size(), 0.0f);
+	for (size_t c = 0; c < clusterList.size(); c++)
+	{
+		float length = glm::length(normalList[c]);
+		if (length > 0.0f)
+		{
+			sortKey[c] = glm::dot(centroidList[c] - meshCentroid, normalList[c] / length);
+		}
+	}
+
+	std::vector<unsigned int> order(clusterList.size());
+	for (size_t c = 0; c < order.size(); c++)
+	{
+		order[c] = (unsigned int)c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<unsigned int> output;
+	output.reserve(indices.size());
+	for (unsigned int c : order)
+	{
+		size_t end = c + 1 < clusterList.size() ? clusterList[c + 1] : triangleCount;
+		output.insert(output.end(), indices.begin() + clusterList[c] * 3, indices.begin() + end * 3);
+	}
+	indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	const unsigned int UNUSED = ~0u;
+	std::vector<unsigned int> remap(vertices.size(), UNUSED);
+	std::vector<Vertex> fetchList;
+	fetchList.reserve(vertices.size());
+
+	for (unsigned int& index : indices)
+	{
+		if (remap[index] == UNUSED)
+		{
+			remap[index] = (unsigned int)fetchList.size();
+			fetchList.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(fetchList);
+}
+
+unsigned int MeshOptimizer::SimulateCache(const std::vector<unsigned int>& indices, size_t vertexCount)
+{
+	// 时间戳模拟FIFO, 与Tipsify的缓存模型一致
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int time = CACHE_SIZE + 1;
+	unsigned int missCount = 0;
+
+	for (unsigned int index : indices)
+	{
+		if (time - cacheTime[index] > CACHE_SIZE)
+		{
+			cacheTime[index] = time++;
+			missCount++;
+		}
+	}
+	return missCount;
+}
+
+bool MeshOptimizer::CanUseShortIndex(size_t vertexCount)
+{
+	return vertexCount <= 65536;
+}
+
+std::vector<uint16_t> MeshOptimizer::NarrowIndices(const std::vector<unsigned int>& indices)
+{
+	return std::vector<uint16_t>(indices.begin(), indices.end());
+}
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MeshRender.h"
+
+// 优化前后的统计, ACMR为每个三角形平均的顶点着色次数, 按FIFO缓存模拟
+struct MeshOptimizeStats {
+	unsigned int VertexCountBefore = 0;
+	unsigned int VertexCountAfter = 0;
+	unsigned int TriangleCount = 0;
+	unsigned int TransformBefore = 0; // 模拟缓存未命中次数
+	unsigned int TransformAfter = 0;
+
+	float GetAcmrBefore() const;
+
+	float GetAcmrAfter() const;
+
+	void Add(const MeshOptimizeStats& other);
+};
+
+// 导入时的网格优化, 输入为三角形列表, 顺序执行:
+// 顶点焊接 -> Tipsify顶点缓存排序 -> 按簇的overdraw排序 -> 顶点按首次使用重排
+// 均为纯CPU计算, 可在工作线程调用
+class MeshOptimizer
+{
+public:
+
+	// 模拟的post-transform缓存大小
+	static const unsigned int CACHE_SIZE = 16;
+
+public:
+
+	static MeshOptimizeStats Optimize(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	// 合并逐字节相同的顶点
+	static void WeldVertices(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	// Tipsify(Sander et al. 2007), clusterList输出每个簇的起始三角形, 簇边界为缓存失去局部性处
+	static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>& clusterList);
+
+	// 簇内顺序不变, 簇按朝外程度由高到低排列, 使靠外的表面先绘制以遮挡内部
+	static void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& clusterList);
+
+	// 顶点按索引中首次出现的顺序重排, 并去除未被引用的顶点
+	static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	// 返回模拟FIFO缓存的未命中次数
+	static unsigned int SimulateCache(const std::vector<unsigned int>& indices, size_t vertexCount);
+
+	// 顶点数不超过65536时可使用GL_UNSIGNED_SHORT索引
+	static bool CanUseShortIndex(size_t vertexCount);
+
+	static std::vector<uint16_t> NarrowIndices(const std::vector<unsigned int>& indices);
+};
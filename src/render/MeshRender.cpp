@@ -1,4 +1,9 @@
-﻿#include "MeshRender.h"
+﻿#include <cstdint>
+#include <glm/gtc/packing.hpp>
+
+#include "MeshRender.h"
+#include "../app/Profiler.h"
+#include "GLStateCache.h"
 
 using namespace std;
 
@@ -46,129 +51,196 @@ MeshRender::MeshRender(vector<Vertex> InVertices, vector<unsigned int> InIndices
 	indices = InIndices;
 	textures = InTextures;
 
+	SetupMaterial();
 	SetupMesh();
 }
 
-void MeshRender::SetupMesh()
+MeshRender::MeshRender(const Vertex* VertexData, unsigned int VertexCount, const void* IndexData, unsigned int IndexCount, GLenum IndexType, vector<Texture> InTextures, EVertexFormat Format, const glm::mat4* SharedDequantizeMatrix)
 {
-	// 绑定VAO
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	// 绑定VBO
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	textures = InTextures;
+	VertexFormat = Format;
+	SetupMaterial();
 
-	// 如果有, 则绑定EBO
-	if (!indices.empty()) {
-		glGenBuffers(1, &EBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+	if (SharedDequantizeMatrix)
+	{
+		DequantizeMatrix = *SharedDequantizeMatrix;
+		bSharedDequantize = true;
 	}
 
-	// 顶点位置
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	// 顶点法线
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-	// 顶点纹理坐标
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoord));
+	SetupMesh(VertexData, VertexCount, IndexData, IndexCount, IndexType);
+}
 
-	glBindVertexArray(0);
+void MeshRender::SetupMesh()
+{
+	SetupMesh(vertices.data(), vertices.size(), indices.data(), indices.size(), GL_UNSIGNED_INT);
 }
 
-void MeshRender::Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::mat4 projection)
+void MeshRender::SetupMesh(const Vertex* VertexData, unsigned int VertexCount, const void* IndexData, unsigned int IndexCount, GLenum IndexType)
 {
-	if (!textures.empty())
+	BoundsMin = BoundsMax = glm::vec3(0.0f);
+	if (VertexCount > 0)
 	{
-		unsigned int diffuseNr = 1;
-		unsigned int specularNr = 1;
-		unsigned int relfectNr = 1;
-
-		for (unsigned int i = 0; i < textures.size(); i++)
-		{
-			glActiveTexture(GL_TEXTURE0 + i); // 在绑定之前激活相应的纹理单元
-
-			string number;
-			string name = textures[i].type;
-
-			if (name == "texture_diffuse")
-			{
-				number = std::to_string(diffuseNr++);
-			}
-			else if (name == "texture_specular")
-			{
-				number = std::to_string(specularNr++);
-			}
-			else if (name == "texture_reflect")
-			{
-				number = std::to_string(relfectNr++);
-			}
-
-			shader->SetInt(("material." + name + number).c_str(), i);
-			glBindTexture(GL_TEXTURE_2D, textures[i].ID);
-		}
+		BoundsMin = BoundsMax = VertexData[0].Position;
+	}
+	for (unsigned int i = 1; i < VertexCount; i++)
+	{
+		BoundsMin = glm::min(BoundsMin, VertexData[i].Position);
+		BoundsMax = glm::max(BoundsMax, VertexData[i].Position);
+	}
 
-		glActiveTexture(GL_TEXTURE0);
+	// 着色器输入均为vec3/vec3/vec2, 紧凑位置经model中的DequantizeMatrix还原
+	switch (VertexFormat)
+	{
+	case VERTEX_FORMAT_HALF:
+		Geometry = GeometryArena::Allocate<HalfVertexLayout>(BuildCompactVertices(VertexData, VertexCount).data(), VertexCount, IndexData, IndexCount, IndexType);
+		break;
+	case VERTEX_FORMAT_SNORM16:
+		Geometry = GeometryArena::Allocate<Snorm16VertexLayout>(BuildCompactVertices(VertexData, VertexCount).data(), VertexCount, IndexData, IndexCount, IndexType);
+		break;
+	default:
+		Geometry = GeometryArena::Allocate<FloatVertexLayout>(VertexData, VertexCount, IndexData, IndexCount, IndexType);
+		break;
 	}
+}
 
-	if (!customTexList.empty())
+vector<CompactVertex> MeshRender::BuildCompactVertices(const Vertex* VertexData, unsigned int VertexCount)
+{
+	if (!bSharedDequantize)
 	{
-		for (unsigned int i = 0; i < customTexList.size(); i++)
-		{
-			glActiveTexture(GL_TEXTURE0 + i);
+		DequantizeMatrix = MakeDequantizeMatrix(BoundsMin, BoundsMax);
+	}
 
-			CustomTex customTex = customTexList[i];
+	glm::vec3 center = glm::vec3(DequantizeMatrix[3]);
+	float scale = DequantizeMatrix[0][0];
 
-			shader->SetInt(customTex.ShaderTarget, i);
-			glBindTexture(GL_TEXTURE_2D, customTex.TexID);
+	vector<CompactVertex> compactList(VertexCount);
+	for (unsigned int i = 0; i < VertexCount; i++)
+	{
+		const Vertex& vertex = VertexData[i];
+		CompactVertex& compact = compactList[i];
+
+		glm::vec3 position = glm::clamp((vertex.Position - center) / scale, glm::vec3(-1.0f), glm::vec3(1.0f));
+		for (int k = 0; k < 3; k++)
+		{
+			compact.Position[k] = VertexFormat == VERTEX_FORMAT_HALF ? glm::packHalf1x16(position[k]) : glm::packSnorm1x16(position[k]);
 		}
+		compact.Position[3] = 0;
+
+		compact.Normal = PackNormal(vertex.Normal);
+		compact.TexCoord[0] = glm::packHalf1x16(vertex.TexCoord.x);
+		compact.TexCoord[1] = glm::packHalf1x16(vertex.TexCoord.y);
 	}
 
-	// Model矩阵
-	int modelLoc = glGetUniformLocation(shader->ID, "model");
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+	return compactList;
+}
 
-	// View矩阵
-	int viewLoc = glGetUniformLocation(shader->ID, "view");
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+void MeshRender::Draw(Shader* shader, glm::mat4 model)
+{
+	MeshMaterial->Bind(shader);
 
-	// Projection矩阵
-	int projectionLoc = glGetUniformLocation(shader->ID, "projection");
-	glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+	// Model矩阵, 句柄在Shader链接时取得, View及Projection位于每帧上传的FrameUniforms
+	shader->SetMat4(shader->ModelHandle, VertexFormat == VERTEX_FORMAT_FLOAT ? model : model * DequantizeMatrix);
 
 	DrawShape();
 }
 
+void MeshRender::DrawInstanced(Shader* shader, const InstanceBuffer* instances)
+{
+	if (instances->GetCount() == 0)
+	{
+		return;
+	}
+
+	MeshMaterial->Bind(shader);
+
+	// 实例的世界变换在shader中左乘, model只保留网格自身的局部变换
+	shader->SetMat4(shader->ModelHandle, DequantizeMatrix);
+
+	DrawShapeInstanced(instances);
+}
+
 void MeshRender::AddCustomTexture(unsigned int TexID, string ShaderTarget)
 {
-	CustomTex customTex;
-	customTex.TexID = TexID;
-	customTex.ShaderTarget = ShaderTarget;
+	MeshMaterial->AddTexture(ShaderTarget, TexID);
+}
 
-	customTexList.push_back(customTex);
+Material* MeshRender::GetMaterial() const
+{
+	return MeshMaterial.get();
 }
 
-// 仅绘制顶点
-void MeshRender::DrawShape()
+void MeshRender::SetMaterial(shared_ptr<Material> InMaterial)
 {
-	// 绘制网格
-	glBindVertexArray(VAO);
+	MeshMaterial = InMaterial;
+}
 
-	// 根据有无EBO选择不同的绘制方式
-	if (!indices.empty())
-	{
-		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-	}
-	else
+void MeshRender::SetupMaterial()
+{
+	for (const Texture& texture : textures)
 	{
-		glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+		MeshMaterial->AddTypedTexture(texture.type, texture.ID);
 	}
+}
+
+// 仅绘制顶点, 有索引时经由glDrawElementsBaseVertex
+void MeshRender::DrawShape()
+{
+	GeometryArena::Draw(Geometry, GL_TRIANGLES);
+	Profiler::Get().AddDrawCall();
+}
+
+void MeshRender::DrawShapeInstanced(const InstanceBuffer* instances)
+{
+	GeometryArena::DrawInstanced(Geometry, GL_TRIANGLES, instances);
+	Profiler::Get().AddDrawCall();
+}
+
+EVertexFormat MeshRender::GetVertexFormat() const
+{
+	return VertexFormat;
+}
 
-	glBindVertexArray(0);
+const glm::mat4& MeshRender::GetDequantizeMatrix() const
+{
+	return DequantizeMatrix;
 }
 
+void MeshRender::Release()
+{
+	GeometryArena::Free(Geometry);
+}
+
+const GeometryRange& MeshRender::GetGeometry() const
+{
+	return Geometry;
+}
+
+BoundingSphere MeshRender::GetBoundingSphere() const
+{
+	return BoundingSphere::FromBounds(BoundsMin, BoundsMax);
+}
 
+BoundingBox MeshRender::GetBoundingBox() const
+{
+	BoundingBox box;
+	box.Min = BoundsMin;
+	box.Max = BoundsMax;
+	return box;
+}
+
+glm::mat4 MeshRender::MakeDequantizeMatrix(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+	// 以包围盒中心及最大半边长做统一缩放, 统一缩放不改变法线方向
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+	glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+	float scale = glm::max(glm::max(extent.x, extent.y), glm::max(extent.z, 1e-6f));
+
+	return glm::translate(glm::mat4(1.0f), center) * glm::scale(glm::mat4(1.0f), glm::vec3(scale));
+}
+
+uint32_t MeshRender::PackNormal(const glm::vec3& normal, float w)
+{
+	float length = glm::length(normal);
+	glm::vec3 unit = length > 0.0f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+	return glm::packSnorm3x10_1x2(glm::vec4(unit, w));
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <iostream>
 #include <vector>
@@ -11,6 +13,11 @@
 #include <assimp/postprocess.h>
 
 #include "Shader.h"
+#include "Material.h"
+#include "VertexLayout.h"
+#include "../obj/Frustum.h"
+#include "../buffer/InstanceBuffer.h"
+#include "../buffer/GeometryArena.h"
 
 using namespace std;
 
@@ -20,17 +27,35 @@ struct Vertex {
 	glm::vec2 TexCoord;
 };
 
+// GPU端顶点格式, CPU端始终为Vertex, 上传时转换
+enum EVertexFormat {
+	VERTEX_FORMAT_FLOAT, // Vertex原样, 32字节
+	VERTEX_FORMAT_HALF, // 半精度位置, 16字节
+	VERTEX_FORMAT_SNORM16 // 归一化16位位置, 16字节
+};
+
+// 紧凑顶点: 位置按包围盒归一化到[-1, 1]后以half或snorm16存储, 第4分量为填充
+// 法线为GL_INT_2_10_10_10_REV, w的2位可存切线的副切线方向符号; 纹理坐标为half
+struct CompactVertex {
+	uint16_t Position[4];
+	uint32_t Normal;
+	uint16_t TexCoord[2];
+};
+
+typedef PosNormalTexLayout FloatVertexLayout;
+typedef VertexLayout<AttrHalf<3>, AttrPadding<2>, AttrPacked1010102, AttrHalf<2>> HalfVertexLayout;
+typedef VertexLayout<AttrSnorm16<3>, AttrPadding<2>, AttrPacked1010102, AttrHalf<2>> Snorm16VertexLayout;
+
+static_assert(FloatVertexLayout::Stride == sizeof(Vertex), "FloatVertexLayout must match Vertex");
+static_assert(HalfVertexLayout::Stride == sizeof(CompactVertex), "HalfVertexLayout must match CompactVertex");
+static_assert(Snorm16VertexLayout::Stride == sizeof(CompactVertex), "Snorm16VertexLayout must match CompactVertex");
+
 struct Texture {
 	unsigned int ID;
 	string type;
 	aiString path;
 };
 
-struct CustomTex {
-	unsigned int TexID;
-	string ShaderTarget;
-};
-
 class MeshRender
 {
 public:
@@ -39,9 +64,13 @@ public:
 	
 	vector<Vertex> vertices;
 
+	// 导入时的纹理记录, 绑定经由材质
 	vector<Texture> textures;
 
-	vector<CustomTex> customTexList;
+	// 局部空间包围盒, 上传时由顶点计算
+	glm::vec3 BoundsMin = glm::vec3(0.0f);
+
+	glm::vec3 BoundsMax = glm::vec3(0.0f);
 
 public:
 
@@ -53,16 +82,72 @@ public:
 	
 	MeshRender(vector<Vertex> InVertices, vector<unsigned int> InIndices, vector<Texture> InTextures);
 
-	virtual void Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::mat4 projection);
+	// 直接上传外部数据(如映射的网格缓存), 不保留CPU端副本, vertices与indices为空
+	// IndexType为GL_UNSIGNED_SHORT或GL_UNSIGNED_INT, Format非FLOAT时上传前转换为CompactVertex
+	// SharedDequantizeMatrix非空时紧凑位置按其量化, 同一模型的网格可共用一个model矩阵合并绘制
+	MeshRender(const Vertex* VertexData, unsigned int VertexCount, const void* IndexData, unsigned int IndexCount, GLenum IndexType, vector<Texture> InTextures, EVertexFormat Format = VERTEX_FORMAT_FLOAT, const glm::mat4* SharedDequantizeMatrix = nullptr);
+
+	virtual void Draw(Shader* shader, glm::mat4 model);
 
+	// 一次绘制全部实例, shader需为INSTANCED变体, 实例数据需已Upload
+	void DrawInstanced(Shader* shader, const InstanceBuffer* instances);
+
+	// 加入材质, ShaderTarget为sampler名
 	void AddCustomTexture(unsigned int TexID, string ShaderTarget);
 
+	// 不设置model, 紧凑格式的网格需由调用方将model乘以GetDequantizeMatrix()
 	void DrawShape();
 
+	void DrawShapeInstanced(const InstanceBuffer* instances);
+
+	EVertexFormat GetVertexFormat() const;
+
+	// 紧凑位置还原到局部空间的变换, FLOAT格式为单位矩阵
+	const glm::mat4& GetDequantizeMatrix() const;
+
+	// 归还arena中的顶点及索引区间, 之后不可再绘制
+	void Release();
+
+	const GeometryRange& GetGeometry() const;
+
+	// 局部空间, 外接于包围盒, 视锥剔除使用
+	BoundingSphere GetBoundingSphere() const;
+
+	BoundingBox GetBoundingBox() const;
+
+	// 构造时由textures生成, 同材质的网格可共用同一对象
+	Material* GetMaterial() const;
+
+	void SetMaterial(shared_ptr<Material> InMaterial);
+
+	// 包围盒内的位置量化到[-1, 1]后的还原变换
+	static glm::mat4 MakeDequantizeMatrix(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+	// w为[-1, 1], 切线可用w保存副切线方向
+	static uint32_t PackNormal(const glm::vec3& normal, float w = 0.0f);
+
 private:
 	
-	unsigned int VAO, VBO, EBO;
+	// 顶点及索引位于GeometryArena, 同一顶点格式的网格共用VAO
+	GeometryRange Geometry;
+
+	EVertexFormat VertexFormat = VERTEX_FORMAT_FLOAT;
+
+	glm::mat4 DequantizeMatrix = glm::mat4(1.0f);
+
+	bool bSharedDequantize = false;
+
+	shared_ptr<Material> MeshMaterial = make_shared<Material>();
+
+	// textures按类型编号加入材质
+	void SetupMaterial();
+
 	
 	void SetupMesh();
+
+	void SetupMesh(const Vertex* VertexData, unsigned int VertexCount, const void* IndexData, unsigned int IndexCount, GLenum IndexType);
+
+	// 转换为CompactVertex, 未共用时按自身包围盒计算DequantizeMatrix, 需在包围盒计算后调用
+	vector<CompactVertex> BuildCompactVertices(const Vertex* VertexData, unsigned int VertexCount);
 };
 
@@ -5,52 +5,267 @@
 #include "ModelRender.h"
 #include "../tool/stb_image.h"
 #include "RenderUtil.h"
+#include "../app/Profiler.h"
+#include "../tool/ThreadPool.h"
+
+EVertexFormat ModelRender::VertexFormat = VERTEX_FORMAT_SNORM16;
 
 ModelRender::ModelRender(char* path)
 {
 	loadModel(path);
 }
 
+ModelRender::~ModelRender()
+{
+	for (unsigned int i = 0; i < batches.size(); i++)
+	{
+		delete batches[i].Batch;
+	}
+
+	for (unsigned int i = 0; i < meshes.size(); i++)
+	{
+		meshes[i].Release();
+	}
+}
+
 void ModelRender::loadModel(string path)
 {
+	ProfileScope scope("LoadModel");
+
+	directory = path.substr(0, path.find_last_of('/'));
+
+	/*  CPU阶段: 网格转换及纹理解码在线程池中执行, 不调用GL  */
+
+	// 缓存命中时直接从映射文件上传, 跳过Assimp解析
+	unique_ptr<MappedFile> cacheFile;
+	vector<MeshCacheMesh> meshList;
+	vector<MeshCacheMaterial> materialList;
+	bool bCacheHit = MeshCache::Load(path, cacheFile, meshList, materialList);
+
 	Assimp::Importer importer;
-	const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+	vector<aiMesh*> sourceList;
+	if (!bCacheHit)
+	{
+		const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenBoundingBoxes);
+
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			cout << "ERROR::ASSIMP::" << importer.GetErrorString() << endl;
+			return;
+		}
 
-	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		processNode(scene->mRootNode, scene, sourceList);
+
+		// 材质表按场景材质索引排列, 只记录纹理路径
+		for (unsigned int i = 0; i < scene->mNumMaterials; i++)
+		{
+			aiMaterial* material = scene->mMaterials[i];
+
+			MeshCacheMaterial cacheMaterial;
+			loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", cacheMaterial);
+			loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", cacheMaterial);
+			loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_reflect", cacheMaterial);
+			materialList.push_back(cacheMaterial);
+		}
+	}
+
+	// 需要解码的纹理, 按路径去重并跳过已加载的
+	vector<TextureImage> imageList;
+	for (const MeshCacheMaterial& material : materialList)
 	{
-		cout << "ERROR::ASSIMP::" << importer.GetErrorString() << endl;
-		return;
+		for (const MeshCacheTexture& texture : material.TextureList)
+		{
+			bool bFound = findLoadedTexture(texture.Path) != nullptr;
+			for (unsigned int i = 0; i < imageList.size() && !bFound; i++)
+			{
+				bFound = imageList[i].Path == texture.Path;
+			}
+
+			if (!bFound)
+			{
+				TextureImage image;
+				image.Path = texture.Path;
+				imageList.push_back(image);
+			}
+		}
+	}
+
+	// 网格与纹理混合为同一批任务, 图片解码耗时较长, 排在前面
+	vector<ImportedMesh> importList(sourceList.size());
+	ThreadPool::Get().ParallelFor(imageList.size() + sourceList.size(), [&](size_t i)
+	{
+		if (i < imageList.size())
+		{
+			DecodeTextureFile(imageList[i].Path.c_str(), directory, imageList[i]);
+		}
+		else
+		{
+			size_t meshIndex = i - imageList.size();
+			importList[meshIndex] = processMesh(sourceList[meshIndex]);
+		}
+	});
+
+	if (!bCacheHit)
+	{
+		MeshOptimizeStats stats;
+		for (const ImportedMesh& imported : importList)
+		{
+			stats.Add(imported.Stats);
+
+			MeshCacheMesh mesh;
+			mesh.VertexData = imported.Vertices.data();
+			mesh.VertexCount = imported.Vertices.size();
+			if (imported.ShortIndices.empty())
+			{
+				mesh.IndexData = imported.Indices.data();
+				mesh.IndexCount = imported.Indices.size();
+				mesh.IndexSize = sizeof(unsigned int);
+			}
+			else
+			{
+				mesh.IndexData = imported.ShortIndices.data();
+				mesh.IndexCount = imported.ShortIndices.size();
+				mesh.IndexSize = sizeof(uint16_t);
+			}
+			mesh.MaterialIndex = imported.MaterialIndex;
+			mesh.BoundsMin = imported.BoundsMin;
+			mesh.BoundsMax = imported.BoundsMax;
+			meshList.push_back(mesh);
+		}
+
+		cout << "Mesh optimize: " << path << " vertices " << stats.VertexCountBefore << " -> " << stats.VertexCountAfter
+			<< ", ACMR " << stats.GetAcmrBefore() << " -> " << stats.GetAcmrAfter() << endl;
+
+		MeshCache::Save(path, meshList, materialList);
+	}
+
+	/*  GL阶段: 在上下文线程上传纹理及网格  */
+
+	for (TextureImage& image : imageList)
+	{
+		Texture texture;
+		texture.ID = UploadTextureImage(image);
+		texture.path = aiString(image.Path);
+		textures_loaded.push_back(texture); // 添加到已加载的纹理中, type在网格引用时按材质填写
+
+		FreeTextureImage(image);
+	}
+
+	createMeshes(meshList, materialList);
+}
+
+void ModelRender::createMeshes(const vector<MeshCacheMesh>& meshList, const vector<MeshCacheMaterial>& materialList)
+{
+	unsigned int firstMesh = (unsigned int)meshes.size();
+	meshes.reserve(meshes.size() + meshList.size());
+
+	if (!meshList.empty())
+	{
+		BoundsMin = meshList[0].BoundsMin;
+		BoundsMax = meshList[0].BoundsMax;
+		for (const MeshCacheMesh& mesh : meshList)
+		{
+			BoundsMin = glm::min(BoundsMin, mesh.BoundsMin);
+			BoundsMax = glm::max(BoundsMax, mesh.BoundsMax);
+		}
+	}
+
+	if (VertexFormat != VERTEX_FORMAT_FLOAT)
+	{
+		DequantizeMatrix = MeshRender::MakeDequantizeMatrix(BoundsMin, BoundsMax);
+	}
+	const glm::mat4* sharedDequantize = VertexFormat != VERTEX_FORMAT_FLOAT ? &DequantizeMatrix : nullptr;
+
+	// 按材质表下标共用, 越界的材质索引各自使用空材质
+	vector<shared_ptr<Material>> materialRefList(materialList.size());
+
+	for (const MeshCacheMesh& mesh : meshList)
+	{
+		vector<Texture> textures;
+		if (mesh.MaterialIndex < materialList.size())
+		{
+			for (const MeshCacheTexture& texture : materialList[mesh.MaterialIndex].TextureList)
+			{
+				textures.push_back(loadTexture(texture));
+			}
+		}
+
+		GLenum indexType = mesh.IndexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		MeshRender meshRender(mesh.VertexData, mesh.VertexCount, mesh.IndexData, mesh.IndexCount, indexType, textures, VertexFormat, sharedDequantize);
+		if (mesh.MaterialIndex < materialRefList.size())
+		{
+			if (!materialRefList[mesh.MaterialIndex])
+			{
+				materialRefList[mesh.MaterialIndex] = make_shared<Material>(*meshRender.GetMaterial());
+			}
+			meshRender.SetMaterial(materialRefList[mesh.MaterialIndex]);
+		}
+		meshes.push_back(meshRender);
 	}
-	directory = path.substr(0, path.find_last_of('/'));
 
-	processNode(scene->mRootNode, scene);
+	buildBatches(meshList, firstMesh);
 }
 
-void ModelRender::processNode(aiNode* node, const aiScene* scene)
+void ModelRender::buildBatches(const vector<MeshCacheMesh>& meshList, unsigned int firstMesh)
+{
+	// 同材质的网格在索引类型相同时合并, 否则另开一批
+	unsigned int firstBatch = (unsigned int)batches.size();
+	for (unsigned int i = 0; i < meshList.size(); i++)
+	{
+		const GeometryRange& geometry = meshes[firstMesh + i].GetGeometry();
+		Material* material = meshes[firstMesh + i].GetMaterial();
+
+		bool bAdded = false;
+		for (unsigned int j = firstBatch; j < batches.size() && !bAdded; j++)
+		{
+			bAdded = batches[j].BatchMaterial == material && batches[j].Batch->Add(geometry);
+		}
+
+		if (!bAdded)
+		{
+			MaterialBatch batch;
+			batch.BatchMaterial = material;
+			batch.Batch = new DrawBatch();
+			if (!batch.Batch->Add(geometry))
+			{
+				delete batch.Batch;
+				continue;
+			}
+			batches.push_back(batch);
+		}
+	}
+
+	for (unsigned int i = firstBatch; i < batches.size(); i++)
+	{
+		batches[i].Batch->Build();
+	}
+
+	cout << "Model batches: " << meshes.size() << " meshes -> " << batches.size() << " draws" << endl;
+}
+
+void ModelRender::processNode(aiNode* node, const aiScene* scene, vector<aiMesh*>& sourceList)
 {
 	// 处理节点所有的网格（如果有的话）
 	for (unsigned int i = 0; i < node->mNumMeshes; i++)
 	{
-		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		meshes.push_back(processMesh(mesh, scene));
+		sourceList.push_back(scene->mMeshes[node->mMeshes[i]]);
 	}
 	// 接下来对它的子节点重复这一过程
 	for (unsigned int i = 0; i < node->mNumChildren; i++)
 	{
-		processNode(node->mChildren[i], scene);
+		processNode(node->mChildren[i], scene, sourceList);
 	}
 
 }
 
-MeshRender ModelRender::processMesh(aiMesh* mesh, const aiScene* scene)
+ModelRender::ImportedMesh ModelRender::processMesh(const aiMesh* mesh)
 {
-	vector<Vertex> vertices;
-	vector<unsigned int> indices;
-	vector<Texture> textures;
+	ImportedMesh imported;
+	imported.Vertices.resize(mesh->mNumVertices);
 
 	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
 	{
-		Vertex vertex;
+		Vertex& vertex = imported.Vertices[i];
 
 		// 处理顶点位置、法线和纹理坐标
 		vertex.Position.x = mesh->mVertices[i].x;
@@ -71,85 +286,137 @@ MeshRender ModelRender::processMesh(aiMesh* mesh, const aiScene* scene)
 		{
 			vertex.TexCoord = glm::vec2(0.0f, 0.0f);
 		}
-
-		vertices.push_back(vertex);
 	}
-	// 处理索引
+	// 处理索引, Triangulate后每个面均为三角形
+	imported.Indices.reserve(mesh->mNumFaces * 3);
 	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
 	{
-		aiFace face = mesh->mFaces[i];
-		for (unsigned int j = 0; j < face.mNumIndices; j++) 
-		{
-			indices.push_back(face.mIndices[j]);
-		}
-			
+		const aiFace& face = mesh->mFaces[i];
+		imported.Indices.insert(imported.Indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
 	}
 
-	// 处理材质
-	if (mesh->mMaterialIndex >= 0)
+	// 焊接, 缓存及overdraw排序, 顶点重排后尽量使用16位索引
+	imported.Stats = MeshOptimizer::Optimize(imported.Vertices, imported.Indices);
+	if (MeshOptimizer::CanUseShortIndex(imported.Vertices.size()))
 	{
-		aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-		vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-		textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-
-		vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-		textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
-
-		vector<Texture> reflectMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_reflect");
-		textures.insert(textures.end(), reflectMaps.begin(), reflectMaps.end());
+		imported.ShortIndices = MeshOptimizer::NarrowIndices(imported.Indices);
+		vector<unsigned int>().swap(imported.Indices);
 	}
 
-	return MeshRender(vertices, indices, textures);
+	imported.MaterialIndex = mesh->mMaterialIndex;
+	imported.BoundsMin = glm::vec3(mesh->mAABB.mMin.x, mesh->mAABB.mMin.y, mesh->mAABB.mMin.z);
+	imported.BoundsMax = glm::vec3(mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z);
+
+	return imported;
 }
 
-vector<Texture> ModelRender::loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName)
+void ModelRender::loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName, MeshCacheMaterial& material)
 {
-	vector<Texture> textures;
-
 	for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
 	{
 		aiString str;
 		mat->GetTexture(type, i, &str);
 
-		bool bSkip = false;
-		for (unsigned int j = 0; j < textures_loaded.size(); j++)
+		MeshCacheTexture texture;
+		texture.Type = typeName;
+		texture.Path = str.C_Str();
+		material.TextureList.push_back(texture);
+	}
+}
+
+const Texture* ModelRender::findLoadedTexture(const string& path) const
+{
+	for (unsigned int j = 0; j < textures_loaded.size(); j++)
+	{
+		if (path == textures_loaded[j].path.C_Str())
 		{
-			aiString texture_path = textures_loaded[j].path;
-			if (std::strcmp(texture_path.data, str.C_Str()) == 0)
-			{
-				textures.push_back(textures_loaded[j]);
-				bSkip = true;
-				break;
-			}
+			return &textures_loaded[j];
 		}
+	}
+	return nullptr;
+}
 
-		if (!bSkip) {
-			Texture texture;
-			texture.ID = TextureFromFile(str.C_Str(), directory);
-			texture.type = typeName;
-			texture.path = str;
-			textures.push_back(texture);
+Texture ModelRender::loadTexture(const MeshCacheTexture& texture)
+{
+	const Texture* found = findLoadedTexture(texture.Path);
+	if (found)
+	{
+		Texture loaded = *found;
+		loaded.type = texture.Type;
+		return loaded;
+	}
 
-			textures_loaded.push_back(texture); // 添加到已加载的纹理中
-		}
+	Texture loaded;
+	loaded.ID = TextureFromFile(texture.Path.c_str(), directory);
+	loaded.type = texture.Type;
+	loaded.path = aiString(texture.Path);
+
+	textures_loaded.push_back(loaded); // 添加到已加载的纹理中
+
+	return loaded;
+}
+
+void ModelRender::Draw(Shader* shader, glm::mat4 model)
+{
+	// 全部网格共用同一还原变换, model只需设置一次
+	shader->SetMat4(shader->ModelHandle, model * DequantizeMatrix);
+
+	for (unsigned int i = 0; i < batches.size(); i++)
+	{
+		batches[i].BatchMaterial->Bind(shader);
+		Profiler::Get().AddDrawCall(batches[i].Batch->Draw(GL_TRIANGLES));
 	}
+}
 
-	return textures;
+void ModelRender::DrawInstanced(Shader* shader, const InstanceBuffer* instances)
+{
+	if (instances->GetCount() == 0)
+	{
+		return;
+	}
+
+	// 实例的世界变换在shader中左乘, model只保留还原变换
+	shader->SetMat4(shader->ModelHandle, DequantizeMatrix);
+
+	for (unsigned int i = 0; i < batches.size(); i++)
+	{
+		batches[i].BatchMaterial->Bind(shader);
+		Profiler::Get().AddDrawCall(batches[i].Batch->DrawInstanced(GL_TRIANGLES, instances));
+	}
 }
 
-void ModelRender::Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::mat4 projection)
+void ModelRender::Submit(RenderQueue& queue, ERenderPass pass, Shader* shader, const glm::mat4& model)
 {
-	for (unsigned int i = 0; i < meshes.size(); i++)
+	BoundingSphere worldSphere = GetBoundingSphere().Transform(model);
+	glm::mat4 packetModel = model * DequantizeMatrix;
+	for (unsigned int i = 0; i < batches.size(); i++)
 	{
-		meshes[i].Draw(shader, model, view, projection);
+		queue.AddBatch(pass, shader, batches[i].BatchMaterial, batches[i].Batch, packetModel, worldSphere);
 	}
 }
 
 void ModelRender::DrawShape()
 {
-	for (unsigned int i = 0; i < meshes.size(); i++)
+	for (unsigned int i = 0; i < batches.size(); i++)
 	{
-		meshes[i].DrawShape();
+		Profiler::Get().AddDrawCall(batches[i].Batch->Draw(GL_TRIANGLES));
 	}
 }
+
+const glm::mat4& ModelRender::GetDequantizeMatrix() const
+{
+	return DequantizeMatrix;
+}
+
+BoundingSphere ModelRender::GetBoundingSphere() const
+{
+	return BoundingSphere::FromBounds(BoundsMin, BoundsMax);
+}
+
+BoundingBox ModelRender::GetBoundingBox() const
+{
+	BoundingBox box;
+	box.Min = BoundsMin;
+	box.Max = BoundsMax;
+	return box;
+}
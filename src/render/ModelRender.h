@@ -13,19 +13,52 @@
 
 #include "Shader.h"
 #include "MeshRender.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "../buffer/DrawBatch.h"
+#include "RenderQueue.h"
 
 using namespace std;
 
 class ModelRender
 {
+public:
+
+	// --vertex-format float|half|snorm16, 模型网格上传时使用的顶点格式
+	static EVertexFormat VertexFormat;
+
+	// 局部空间包围盒, 全部网格的并集
+	glm::vec3 BoundsMin = glm::vec3(0.0f);
+
+	glm::vec3 BoundsMax = glm::vec3(0.0f);
+
 public:
 	/*  函数   */
 	ModelRender(char* path);
 
-	void Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::mat4 projection);
+	// 归还全部网格在GeometryArena中的区间
+	~ModelRender();
 
+	// 每个材质一次多绘制, 同材质的网格共用纹理绑定
+	void Draw(Shader* shader, glm::mat4 model);
+
+	// 每个材质一次实例化多绘制
+	void DrawInstanced(Shader* shader, const InstanceBuffer* instances);
+
+	// 每个材质一个绘制包加入队列, 深度及视锥剔除均取模型的包围球
+	void Submit(RenderQueue& queue, ERenderPass pass, Shader* shader, const glm::mat4& model);
+
+	// 不设置model及纹理, 紧凑格式需由调用方将model乘以GetDequantizeMatrix()
 	void DrawShape();
 
+	// 全部网格共用的还原变换, FLOAT格式为单位矩阵
+	const glm::mat4& GetDequantizeMatrix() const;
+
+	// 局部空间, 外接于全部网格的包围盒
+	BoundingSphere GetBoundingSphere() const;
+
+	BoundingBox GetBoundingBox() const;
+
 private:
 	/*  模型数据  */
 	vector<MeshRender> meshes;
@@ -34,13 +67,48 @@ private:
 
 	string directory;
 
+	// 按材质合并的绘制, 材质由同材质的网格共用
+	struct MaterialBatch {
+		Material* BatchMaterial = nullptr;
+		DrawBatch* Batch = nullptr;
+	};
+
+	vector<MaterialBatch> batches;
+
+	glm::mat4 DequantizeMatrix = glm::mat4(1.0f);
+
+	// Assimp导入并优化后的CPU端网格, 写入缓存及上传后释放
+	// 顶点数允许时索引收窄至ShortIndices, 此时Indices为空
+	struct ImportedMesh {
+		vector<Vertex> Vertices;
+		vector<unsigned int> Indices;
+		vector<uint16_t> ShortIndices;
+		MeshOptimizeStats Stats;
+		unsigned int MaterialIndex = 0;
+		glm::vec3 BoundsMin = glm::vec3(0.0f);
+		glm::vec3 BoundsMax = glm::vec3(0.0f);
+	};
+
 	/*  函数   */
 	void loadModel(string path);
 
-	void processNode(aiNode* node, const aiScene* scene);
+	// 网格缓存命中时meshList指向映射文件, 否则指向importList
+	// 紧凑格式下全部网格按模型整体包围盒量化, 使各网格可共用一个model矩阵; 同材质索引的网格共用一个Material
+	void createMeshes(const vector<MeshCacheMesh>& meshList, const vector<MeshCacheMaterial>& materialList);
+
+	// meshList[i]对应meshes[firstMesh + i]
+	void buildBatches(const vector<MeshCacheMesh>& meshList, unsigned int firstMesh);
+
+	// 只收集网格, 转换在线程池中进行
+	void processNode(aiNode* node, const aiScene* scene, vector<aiMesh*>& sourceList);
+
+	// 可在工作线程调用, 不访问GL及成员状态
+	static ImportedMesh processMesh(const aiMesh* mesh);
+
+	void loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName, MeshCacheMaterial& material);
 
-	MeshRender processMesh(aiMesh* mesh, const aiScene* scene);
+	const Texture* findLoadedTexture(const string& path) const;
 
-	vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, string typeName);
+	Texture loadTexture(const MeshCacheTexture& texture);
 };
 
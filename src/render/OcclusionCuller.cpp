@@ -0,0 +1,193 @@
+﻿#include <glm/gtc/matrix_transform.hpp>
+
+#include "OcclusionCuller.h"
+#include "GLStateCache.h"
+#include "VertexLayout.h"
+#include "../app/Profiler.h"
+
+bool OcclusionCuller::bEnabled = true;
+
+OcclusionCuller::~OcclusionCuller()
+{
+	for (ObjectState& state : StateList)
+	{
+		if (state.Query)
+		{
+			glDeleteQueries(1, &state.Query);
+		}
+	}
+	GeometryArena::Free(CubeGeometry);
+	delete ProxyShader;
+}
+
+void OcclusionCuller::Resize(int count)
+{
+	for (size_t i = count; i < StateList.size(); i++)
+	{
+		if (StateList[i].Query)
+		{
+			glDeleteQueries(1, &StateList[i].Query);
+		}
+	}
+	StateList.resize(count);
+}
+
+void OcclusionCuller::BeginFrame(const glm::vec3& viewPos)
+{
+	ViewPos = viewPos;
+	FrameIndex++;
+
+	for (ObjectState& state : StateList)
+	{
+		if (!state.bPending)
+		{
+			continue;
+		}
+
+		GLuint bAvailable = GL_FALSE;
+		glGetQueryObjectuiv(state.Query, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (bAvailable)
+		{
+			GLuint result = 0;
+			glGetQueryObjectuiv(state.Query, GL_QUERY_RESULT, &result);
+			state.bVisible = result != 0;
+			state.bPending = false;
+		}
+	}
+}
+
+bool OcclusionCuller::IsVisible(int handle) const
+{
+	return !bEnabled || StateList[handle].bVisible;
+}
+
+bool OcclusionCuller::IsQueryDue(int handle) const
+{
+	return bEnabled && !StateList[handle].bPending && (FrameIndex + handle) % VISIBLE_QUERY_INTERVAL == 0;
+}
+
+void OcclusionCuller::BeginQueries()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	if (!ProxyShader)
+	{
+		CreateProxy();
+	}
+
+	// 代理不写入任何缓冲, 深度测试沿用当前设置
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	GLStateCache::DepthMask(GL_FALSE);
+	ProxyShader->Use();
+}
+
+void OcclusionCuller::IssueQuery(int handle, const BoundingBox& box)
+{
+	ObjectState& state = StateList[handle];
+	if (!bEnabled || state.bPending)
+	{
+		return;
+	}
+
+	// 相机在包围盒内(含近平面附近)时代理的正面被裁掉, 查询不可靠
+	glm::vec3 margin(0.1f);
+	if (glm::all(glm::greaterThanEqual(ViewPos, box.Min - margin)) && glm::all(glm::lessThanEqual(ViewPos, box.Max + margin)))
+	{
+		state.bVisible = true;
+		return;
+	}
+
+	if (!state.Query)
+	{
+		glGenQueries(1, &state.Query);
+	}
+
+	glm::vec3 center = (box.Min + box.Max) * 0.5f;
+	glm::vec3 extent = glm::max((box.Max - box.Min) * 0.5f, glm::vec3(1e-4f));
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), center) * glm::scale(glm::mat4(1.0f), extent);
+	ProxyShader->SetMat4(ProxyShader->ModelHandle, model);
+
+	glBeginQuery(QueryTarget, state.Query);
+	GeometryArena::Draw(CubeGeometry, GL_TRIANGLES);
+	glEndQuery(QueryTarget);
+	Profiler::Get().AddDrawCall();
+
+	state.bPending = true;
+	state.bIssued = true;
+}
+
+void OcclusionCuller::EndQueries()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	GLStateCache::DepthMask(GL_TRUE);
+}
+
+void OcclusionCuller::BeginConditional(int handle)
+{
+	const ObjectState& state = StateList[handle];
+	// 上次可见的物体直接绘制, 复查的结果留待之后的帧读取
+	if (!bEnabled || !state.bIssued || state.bVisible)
+	{
+		return;
+	}
+
+	// GPU等待查询完成后决定是否执行, 不阻塞CPU
+	glBeginConditionalRender(state.Query, GL_QUERY_WAIT);
+	bConditionalActive = true;
+}
+
+void OcclusionCuller::EndConditional()
+{
+	if (bConditionalActive)
+	{
+		glEndConditionalRender();
+		bConditionalActive = false;
+	}
+}
+
+int OcclusionCuller::GetOccludedCount() const
+{
+	int count = 0;
+	for (const ObjectState& state : StateList)
+	{
+		count += state.bVisible ? 0 : 1;
+	}
+	return count;
+}
+
+void OcclusionCuller::CreateProxy()
+{
+	bool bConservative = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3) || GLAD_GL_ARB_ES3_compatibility;
+	QueryTarget = bConservative ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED;
+
+	ProxyShader = new Shader("shader/Occlusion/BoundingBox.vs", "shader/Occlusion/BoundingBox.fs");
+
+	static const float cubeVertices[] = {
+		-1.0f, -1.0f, -1.0f,
+		 1.0f, -1.0f, -1.0f,
+		 1.0f,  1.0f, -1.0f,
+		-1.0f,  1.0f, -1.0f,
+		-1.0f, -1.0f,  1.0f,
+		 1.0f, -1.0f,  1.0f,
+		 1.0f,  1.0f,  1.0f,
+		-1.0f,  1.0f,  1.0f
+	};
+	// 逆时针为正面
+	static const unsigned int cubeIndices[] = {
+		0, 2, 1, 0, 3, 2, // -z
+		4, 5, 6, 4, 6, 7, // +z
+		0, 4, 7, 0, 7, 3, // -x
+		1, 2, 6, 1, 6, 5, // +x
+		0, 1, 5, 0, 5, 4, // -y
+		3, 7, 6, 3, 6, 2  // +y
+	};
+	CubeGeometry = GeometryArena::Allocate<PosLayout>(cubeVertices, 8, cubeIndices, 36, GL_UNSIGNED_INT);
+}
@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "../buffer/GeometryArena.h"
+#include "../obj/Frustum.h"
+
+// 硬件遮挡查询的可见性, 参照CHC++的时间相关性:
+// 上次查询可见的物体直接绘制, 每隔数帧以包围盒代理复查, 结果在之后的帧读取;
+// 上次被遮挡的物体先以包围盒代理查询, 再以该查询为条件绘制, 由GPU按结果跳过, CPU不等待
+// 查询结果只在BeginFrame中非阻塞读取; 物体以句柄引用, 可与BVH的句柄一致
+class OcclusionCuller
+{
+public:
+
+	// --no-occlusion关闭, 全部物体视为可见且不发出查询
+	static bool bEnabled;
+
+	// 可见物体的复查间隔(帧), 按句柄错开
+	static const int VISIBLE_QUERY_INTERVAL = 8;
+
+public:
+
+	~OcclusionCuller();
+
+	// 物体数, 新物体视为可见
+	void Resize(int count);
+
+	// 每帧开始时调用, 读取已返回的查询结果
+	void BeginFrame(const glm::vec3& viewPos);
+
+	// 上次查询的结果, 尚未查询过的物体为可见
+	bool IsVisible(int handle) const;
+
+	// 可见物体的复查到期且没有未返回的查询
+	bool IsQueryDue(int handle) const;
+
+	// 关闭颜色及深度写入并绑定代理shader, 之后调用IssueQuery, 需在遮挡物的深度写入之后
+	void BeginQueries();
+
+	// box为世界包围盒, 物体已有未返回的查询时不重复发出; 相机位于包围盒内时直接视为可见
+	void IssueQuery(int handle, const BoundingBox& box);
+
+	// 恢复写入, 之后需重新绑定绘制所用的shader
+	void EndQueries();
+
+	// 上次被遮挡的物体以最近的查询为条件绘制; 上次可见, 未查询过或已关闭时不设条件
+	void BeginConditional(int handle);
+
+	void EndConditional();
+
+	// 上次查询为遮挡的物体数
+	int GetOccludedCount() const;
+
+private:
+
+	struct ObjectState {
+		GLuint Query = 0;
+		bool bVisible = true;
+		bool bPending = false;
+		bool bIssued = false;
+	};
+
+	std::vector<ObjectState> StateList;
+
+	glm::vec3 ViewPos = glm::vec3(0.0f);
+
+	unsigned int FrameIndex = 0;
+
+	// GL 4.3或ARB_ES3_compatibility时为GL_ANY_SAMPLES_PASSED_CONSERVATIVE
+	GLenum QueryTarget = 0;
+
+	Shader* ProxyShader = nullptr;
+
+	GeometryRange CubeGeometry;
+
+	bool bConditionalActive = false;
+
+private:
+
+	// 首次BeginQueries时创建代理shader及立方体
+	void CreateProxy();
+};
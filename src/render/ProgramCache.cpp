@@ -0,0 +1,217 @@
+﻿#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ProgramCache.h"
+
+bool ProgramCache::bEnabled = true;
+std::string ProgramCache::CacheDir = "shader_cache";
+int ProgramCache::HitCount = 0;
+int ProgramCache::MissCount = 0;
+
+// 缓存文件头, 格式变更时递增Version
+static const uint32_t CACHE_MAGIC = 0x42505253; // "SRPB"
+static const uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t Format;
+	uint32_t Length;
+};
+
+// FNV-1a 64位
+static void HashBytes(uint64_t& hash, const char* data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ull;
+	}
+}
+
+static void HashString(uint64_t& hash, const std::string& str)
+{
+	// 带长度, 避免不同切分得到相同的拼接结果
+	uint32_t size = (uint32_t)str.size();
+	HashBytes(hash, (const char*)&size, sizeof(size));
+	HashBytes(hash, str.data(), str.size());
+}
+
+static void HashGLString(uint64_t& hash, GLenum name)
+{
+	const char* str = (const char*)glGetString(name);
+	HashString(hash, str ? str : "");
+}
+
+std::string ProgramCache::MakeKey(const std::vector<std::string>& stageList)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const std::string& str : stageList)
+	{
+		HashString(hash, str);
+	}
+	HashGLString(hash, GL_VENDOR);
+	HashGLString(hash, GL_RENDERER);
+	HashGLString(hash, GL_VERSION);
+
+	char key[17];
+	snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash);
+	return key;
+}
+
+void ProgramCache::PrepareProgram(GLuint program)
+{
+	if (IsSupported())
+	{
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+}
+
+bool ProgramCache::Load(GLuint program, const std::string& key)
+{
+	if (!IsSupported())
+	{
+		return false;
+	}
+
+	std::ifstream file(GetCachePath(key), std::ios::binary);
+	if (!file.is_open())
+	{
+		MissCount++;
+		return false;
+	}
+
+	CacheHeader header;
+	file.read((char*)&header, sizeof(header));
+	if (!file || header.Magic != CACHE_MAGIC || header.Version != CACHE_VERSION || header.Length == 0)
+	{
+		MissCount++;
+		return false;
+	}
+
+	std::vector<char> binary(header.Length);
+	file.read(binary.data(), binary.size());
+	if (!file)
+	{
+		MissCount++;
+		return false;
+	}
+
+	glProgramBinary(program, header.Format, binary.data(), (GLsizei)binary.size());
+
+	GLint success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		// 驱动版本变化等原因被拒绝, 重新编译后会覆盖该文件
+		MissCount++;
+		return false;
+	}
+
+	HitCount++;
+	return true;
+}
+
+void ProgramCache::Save(GLuint program, const std::string& key)
+{
+	if (!IsSupported())
+	{
+		return;
+	}
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+#ifdef _WIN32
+	_mkdir(CacheDir.c_str());
+#else
+	mkdir(CacheDir.c_str(), 0755);
+#endif
+
+	// 先写临时文件再改名, 避免中断时留下不完整的缓存; 临时文件名按进程及线程区分, 共用缓存目录时互不覆盖
+#ifdef _WIN32
+	int processID = _getpid();
+#else
+	int processID = (int)getpid();
+#endif
+	std::string path = GetCachePath(key);
+	std::string tempPath = path + "." + std::to_string(processID) + "_" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary);
+		if (!file.is_open())
+		{
+			std::cout << "ERROR::PROGRAM_CACHE::Failed to write: " << tempPath << std::endl;
+			return;
+		}
+
+		CacheHeader header;
+		header.Magic = CACHE_MAGIC;
+		header.Version = CACHE_VERSION;
+		header.Format = format;
+		header.Length = (uint32_t)length;
+		file.write((const char*)&header, sizeof(header));
+		file.write(binary.data(), binary.size());
+
+		if (!file)
+		{
+			std::cout << "ERROR::PROGRAM_CACHE::Failed to write: " << tempPath << std::endl;
+			file.close();
+			std::remove(tempPath.c_str());
+			return;
+		}
+	}
+
+	// POSIX下rename原子替换已有文件, Windows下目标存在时失败需先删除
+#ifdef _WIN32
+	std::remove(path.c_str());
+#endif
+	if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		std::cout << "ERROR::PROGRAM_CACHE::Failed to write: " << path << std::endl;
+		std::remove(tempPath.c_str());
+	}
+}
+
+void ProgramCache::PrintStats()
+{
+	if (bEnabled)
+	{
+		std::cout << "Program cache: " << HitCount << " hit, " << MissCount << " miss" << std::endl;
+	}
+}
+
+bool ProgramCache::IsSupported()
+{
+	if (!bEnabled || !GLAD_GL_ARB_get_program_binary)
+	{
+		return false;
+	}
+
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	return formatCount > 0;
+}
+
+std::string ProgramCache::GetCachePath(const std::string& key)
+{
+	return CacheDir + "/" + key + ".bin";
+}
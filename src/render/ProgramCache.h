@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+// 程序二进制磁盘缓存, 键为各阶段源码, 阶段组合及驱动字符串的哈希
+// 驱动拒绝缓存的二进制时(驱动升级等)返回false, 由调用方正常编译
+class ProgramCache
+{
+public:
+
+	// --no-shader-cache关闭
+	static bool bEnabled;
+
+	static std::string CacheDir;
+
+	static int HitCount;
+
+	static int MissCount;
+
+public:
+
+	// stageList按"阶段名, 源码"依次排列, 如{ "vs", vertexCode, "fs", fragmentCode }
+	static std::string MakeKey(const std::vector<std::string>& stageList);
+
+	// 链接前调用, 提示驱动保留可读取的二进制
+	static void PrepareProgram(GLuint program);
+
+	// 成功时program已处于链接完成状态
+	static bool Load(GLuint program, const std::string& key);
+
+	static void Save(GLuint program, const std::string& key);
+
+	static void PrintStats();
+
+private:
+
+	// 驱动不支持任何二进制格式时关闭缓存
+	static bool IsSupported();
+
+	static std::string GetCachePath(const std::string& key);
+};
@@ -0,0 +1,247 @@
+﻿#include "RenderQueue.h"
+#include "../app/Profiler.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+
+static const int PASS_SHIFT = 62;
+static const uint64_t PROGRAM_MASK = (1u << 10) - 1;
+static const uint64_t MATERIAL_MASK = (1u << 14) - 1;
+static const uint64_t VAO_MASK = (1u << 14) - 1;
+static const uint64_t DEPTH_MASK = (1u << 24) - 1;
+
+void RenderQueue::Begin(const glm::vec3& viewPos, float farPlane, const Frustum& frustum)
+{
+	ViewPos = viewPos;
+	FarPlane = farPlane;
+	ViewFrustum = frustum;
+	bCullEnabled = true;
+
+	PacketList.clear();
+	BoundsList.Clear();
+	KeyList.clear();
+	ProgramIndexMap.clear();
+	MaterialIndexMap.clear();
+}
+
+void RenderQueue::Begin(const glm::vec3& viewPos, float farPlane)
+{
+	Begin(viewPos, farPlane, Frustum());
+	bCullEnabled = false;
+}
+
+void RenderQueue::Add(ERenderPass pass, Shader* shader, MeshRender* mesh, const glm::mat4& model, bool bTwoSided)
+{
+	RenderPacket packet;
+	packet.Program = shader;
+	packet.PacketMaterial = mesh->GetMaterial();
+	packet.Mesh = mesh;
+	packet.Model = model * mesh->GetDequantizeMatrix();
+	packet.bTwoSided = bTwoSided;
+
+	const GeometryRange& geometry = mesh->GetGeometry();
+	GLuint vao = geometry.Pool ? geometry.Pool->VAO : 0;
+
+	AddPacket(pass, packet, vao, mesh->GetBoundingSphere().Transform(model));
+}
+
+void RenderQueue::AddBatch(ERenderPass pass, Shader* shader, Material* material, DrawBatch* batch, const glm::mat4& model, const BoundingSphere& worldSphere)
+{
+	RenderPacket packet;
+	packet.Program = shader;
+	packet.PacketMaterial = material;
+	packet.Batch = batch;
+	packet.Model = model;
+
+	const GeometryRange& geometry = batch->GetGeometry();
+	GLuint vao = geometry.Pool ? geometry.Pool->VAO : 0;
+
+	AddPacket(pass, packet, vao, worldSphere);
+}
+
+void RenderQueue::AddPacket(ERenderPass pass, const RenderPacket& packet, GLuint vao, const BoundingSphere& worldSphere)
+{
+	KeyList.push_back(MakeKey(pass, packet, vao, glm::length(worldSphere.Center - ViewPos)));
+	PacketList.push_back(packet);
+	BoundsList.Add(worldSphere);
+}
+
+uint64_t RenderQueue::MakeKey(ERenderPass pass, const RenderPacket& packet, GLuint vao, float distance)
+{
+	// 下标按首次出现分配, emplace在已存在时返回原值
+	uint64_t program = ProgramIndexMap.emplace(packet.Program, (uint32_t)ProgramIndexMap.size()).first->second & PROGRAM_MASK;
+	uint64_t material = MaterialIndexMap.emplace(packet.PacketMaterial, (uint32_t)MaterialIndexMap.size()).first->second & MATERIAL_MASK;
+
+	float depth = glm::clamp(distance / FarPlane, 0.0f, 1.0f);
+	uint64_t quantized = (uint64_t)(depth * (float)DEPTH_MASK) & DEPTH_MASK;
+
+	uint64_t key = (uint64_t)pass << PASS_SHIFT;
+	if (pass == RENDER_PASS_TRANSPARENT)
+	{
+		key |= (DEPTH_MASK - quantized) << 38;
+		key |= program << 28;
+		key |= material << 14;
+		key |= (uint64_t)vao & VAO_MASK;
+	}
+	else
+	{
+		key |= program << 52;
+		key |= material << 38;
+		key |= ((uint64_t)vao & VAO_MASK) << 24;
+		key |= quantized;
+	}
+	return key;
+}
+
+void RenderQueue::Sort()
+{
+	if (!bCullEnabled)
+	{
+		OrderList.resize(PacketList.size());
+		for (size_t i = 0; i < PacketList.size(); i++)
+		{
+			OrderList[i] = (uint32_t)i;
+		}
+		RadixSort();
+		return;
+	}
+
+	ViewFrustum.Cull(BoundsList, VisibleList);
+
+	// 可见包的键原位前移, 排序只处理可见部分
+	size_t visibleCount = 0;
+	OrderList.clear();
+	for (size_t i = 0; i < PacketList.size(); i++)
+	{
+		if (VisibleList[i])
+		{
+			KeyList[visibleCount++] = KeyList[i];
+			OrderList.push_back((uint32_t)i);
+		}
+	}
+	KeyList.resize(visibleCount);
+	Profiler::Get().AddCulled((int)(PacketList.size() - visibleCount));
+
+	RadixSort();
+}
+
+void RenderQueue::RadixSort()
+{
+	size_t count = KeyList.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	// 一次遍历得到全部8轮的直方图
+	size_t histogram[8][256] = {};
+	for (uint64_t key : KeyList)
+	{
+		for (int digit = 0; digit < 8; digit++)
+		{
+			histogram[digit][(key >> (digit * 8)) & 0xFF]++;
+		}
+	}
+
+	TempKeyList.resize(count);
+	TempOrderList.resize(count);
+
+	for (int digit = 0; digit < 8; digit++)
+	{
+		int shift = digit * 8;
+		if (histogram[digit][(KeyList[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		size_t offset[256];
+		size_t sum = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			offset[i] = sum;
+			sum += histogram[digit][i];
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t target = offset[(KeyList[i] >> shift) & 0xFF]++;
+			TempKeyList[target] = KeyList[i];
+			TempOrderList[target] = OrderList[i];
+		}
+
+		KeyList.swap(TempKeyList);
+		OrderList.swap(TempOrderList);
+	}
+}
+
+void RenderQueue::Execute(ERenderPass pass)
+{
+	// 键已有序, pass位于最高位, 二分得到该pass的区间
+	uint64_t passBegin = (uint64_t)pass << PASS_SHIFT;
+	size_t begin = std::lower_bound(KeyList.begin(), KeyList.end(), passBegin) - KeyList.begin();
+	size_t end = KeyList.size();
+	if (pass + 1 < RENDER_PASS_COUNT)
+	{
+		end = std::lower_bound(KeyList.begin(), KeyList.end(), (uint64_t)(pass + 1) << PASS_SHIFT) - KeyList.begin();
+	}
+
+	Shader* curProgram = nullptr;
+	Material* curMaterial = nullptr;
+	bool bCullDisabled = false;
+
+	for (size_t i = begin; i < end; i++)
+	{
+		const RenderPacket& packet = PacketList[OrderList[i]];
+
+		if (packet.Program != curProgram)
+		{
+			packet.Program->Use();
+			curProgram = packet.Program;
+
+			// sampler uniform属于程序, 换程序后需重新设置
+			curMaterial = nullptr;
+		}
+
+		if (packet.PacketMaterial != curMaterial)
+		{
+			packet.PacketMaterial->Bind(packet.Program);
+			curMaterial = packet.PacketMaterial;
+		}
+
+		if (packet.bTwoSided != bCullDisabled)
+		{
+			if (packet.bTwoSided)
+			{
+				GLStateCache::Disable(GL_CULL_FACE);
+			}
+			else
+			{
+				GLStateCache::Enable(GL_CULL_FACE);
+			}
+			bCullDisabled = packet.bTwoSided;
+		}
+
+		packet.Program->SetMat4(packet.Program->ModelHandle, packet.Model);
+
+		// 同一VAO的相邻包由GLStateCache跳过重复绑定
+		if (packet.Batch)
+		{
+			Profiler::Get().AddDrawCall(packet.Batch->Draw(GL_TRIANGLES));
+		}
+		else
+		{
+			GeometryArena::Draw(packet.Mesh->GetGeometry(), GL_TRIANGLES);
+			Profiler::Get().AddDrawCall();
+		}
+	}
+
+	if (bCullDisabled)
+	{
+		GLStateCache::Enable(GL_CULL_FACE);
+	}
+}
+
+int RenderQueue::GetCount() const
+{
+	return (int)PacketList.size();
+}
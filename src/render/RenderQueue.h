@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "MeshRender.h"
+#include "../buffer/DrawBatch.h"
+#include "../obj/Frustum.h"
+
+// 排序键的最高两位, 数值小的先提交
+enum ERenderPass {
+	RENDER_PASS_OPAQUE = 0, // 同状态内由近及远, 利于early-z
+	RENDER_PASS_TRANSPARENT = 1, // 由远及近, 深度优先于状态
+	RENDER_PASS_COUNT
+};
+
+// 一次绘制, Batch非空时绘制合并批次, 否则绘制Mesh的区间
+struct RenderPacket {
+	Shader* Program = nullptr;
+	Material* PacketMaterial = nullptr;
+	MeshRender* Mesh = nullptr;
+	DrawBatch* Batch = nullptr;
+	glm::mat4 Model = glm::mat4(1.0f); // 已并入还原变换
+	bool bTwoSided = false; // 提交时关闭面剔除
+};
+
+// 帧内收集绘制包, 视锥剔除后按64位键基数排序提交, 相邻包相同的程序, 材质及剔除状态不重复设置, VAO由GLStateCache省略
+// 材质为共用的Material对象, 纹理相同的网格共用材质时可排在一起
+// 不透明: pass(2) | 程序(10) | 材质(14) | VAO(14) | 深度(24)
+// 透明:   pass(2) | 反转深度(24) | 程序(10) | 材质(14) | VAO(14)
+// 程序及材质按帧内首次出现编号, 超出位宽时回绕, 只影响合并程度不影响正确性
+class RenderQueue
+{
+public:
+
+	// 每帧收集前调用, 深度为到viewPos的距离按farPlane量化, 包围球在frustum外的包不提交
+	void Begin(const glm::vec3& viewPos, float farPlane, const Frustum& frustum);
+
+	// 调用方已按BVH剔除, 只加入可见物体时使用, Sort不再逐包剔除
+	void Begin(const glm::vec3& viewPos, float farPlane);
+
+	// 深度及剔除取网格包围球
+	void Add(ERenderPass pass, Shader* shader, MeshRender* mesh, const glm::mat4& model, bool bTwoSided = false);
+
+	// 合并批次, 由ModelRender::Submit按材质调用; model已并入还原变换, worldSphere为深度参考及剔除范围
+	void AddBatch(ERenderPass pass, Shader* shader, Material* material, DrawBatch* batch, const glm::mat4& model, const BoundingSphere& worldSphere);
+
+	// 全部包加入后调用一次, 批量剔除后排序, 剔除数计入Profiler
+	void Sort();
+
+	// 按排序提交指定pass的包; 默认面剔除开启, 双面包提交后恢复
+	void Execute(ERenderPass pass);
+
+	// 加入的包数, 含被剔除的
+	int GetCount() const;
+
+private:
+
+	glm::vec3 ViewPos = glm::vec3(0.0f);
+
+	float FarPlane = 100.0f;
+
+	Frustum ViewFrustum;
+
+	bool bCullEnabled = true;
+
+	std::vector<RenderPacket> PacketList;
+
+	// 与PacketList一一对应的世界空间包围球
+	SphereList BoundsList;
+
+	std::vector<uint8_t> VisibleList;
+
+	// 加入时与PacketList一一对应, 剔除后只保留可见包, 排序只移动键及下标
+	std::vector<uint64_t> KeyList;
+
+	std::vector<uint32_t> OrderList;
+
+	std::vector<uint64_t> TempKeyList;
+
+	std::vector<uint32_t> TempOrderList;
+
+	std::unordered_map<const Shader*, uint32_t> ProgramIndexMap;
+
+	std::unordered_map<const Material*, uint32_t> MaterialIndexMap;
+
+private:
+
+	void AddPacket(ERenderPass pass, const RenderPacket& packet, GLuint vao, const BoundingSphere& worldSphere);
+
+	uint64_t MakeKey(ERenderPass pass, const RenderPacket& packet, GLuint vao, float distance);
+
+	// LSD基数排序, 每轮8位, 全部键在该位相同的轮次跳过
+	void RadixSort();
+};
@@ -4,6 +4,7 @@
 
 #include "RenderUtil.h"
 #include "../tool/stb_image.h"
+#include "GLStateCache.h"
 
 using namespace std;
 
@@ -29,7 +30,7 @@ unsigned int LoadTexture(const char* ImagePath, bool bFlip)
 		else if (nrChannels == 4)
 			format = GL_RGBA;
 
-		glBindTexture(GL_TEXTURE_2D, Texture);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, Texture);
 		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -52,47 +53,67 @@ unsigned int LoadTexture(const char* ImagePath, bool bFlip)
 }
 
 unsigned int TextureFromFile(const char* path, const string& directory, bool gamma)
+{
+	TextureImage image;
+	DecodeTextureFile(path, directory, image);
+
+	unsigned int textureID = UploadTextureImage(image);
+	FreeTextureImage(image);
+
+	return textureID;
+}
+
+bool DecodeTextureFile(const char* path, const string& directory, TextureImage& image)
 {
 	string filename = string(path);
 	filename = directory + '/' + filename;
 
+	image.Path = path;
+	image.Data = stbi_load(filename.c_str(), &image.Width, &image.Height, &image.Components, 0);
+
+	return image.Data != nullptr;
+}
+
+unsigned int UploadTextureImage(const TextureImage& image)
+{
 	unsigned int textureID;
 	glGenTextures(1, &textureID);
 
-	int width, height, nrComponents;
-	unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-	if (data)
+	if (image.Data)
 	{
 		GLenum format;
-		if (nrComponents == 1)
+		if (image.Components == 1)
 		{
 			format = GL_RED;
 		}
-		else if (nrComponents == 3)
+		else if (image.Components == 3)
 		{
 			format = GL_RGB;
 		}
-		else if (nrComponents == 4)
+		else if (image.Components == 4)
 		{
 			format = GL_RGBA;
 		}
 
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, image.Width, image.Height, 0, format, GL_UNSIGNED_BYTE, image.Data);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		stbi_image_free(data);
 	}
 	else
 	{
-		std::cout << "Texture failed to load at path: " << path << std::endl;
-		stbi_image_free(data);
+		std::cout << "Texture failed to load at path: " << image.Path << std::endl;
 	}
 
 	return textureID;
 }
+
+void FreeTextureImage(TextureImage& image)
+{
+	stbi_image_free(image.Data);
+	image.Data = nullptr;
+}
@@ -5,3 +5,19 @@
 unsigned int LoadTexture(const char* ImagePath, bool bFlip = false);
 
 unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false);
+
+// 解码后的图片, 解码可在任意线程进行, 上传须在GL上下文线程
+struct TextureImage {
+	std::string Path;
+	unsigned char* Data = nullptr;
+	int Width = 0;
+	int Height = 0;
+	int Components = 0;
+};
+
+// 失败时Data为nullptr, 上传时仍生成空纹理并输出错误, 与TextureFromFile一致
+bool DecodeTextureFile(const char* path, const std::string& directory, TextureImage& image);
+
+unsigned int UploadTextureImage(const TextureImage& image);
+
+void FreeTextureImage(TextureImage& image);
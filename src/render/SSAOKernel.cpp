@@ -1,4 +1,5 @@
 ﻿#include "SSAOKernel.h"
+#include "GLStateCache.h"
 #include <random>
 
 SSAOKernel::SSAOKernel(GLuint InKernelSize, GLuint InNoiseSize)
@@ -58,7 +59,7 @@ void SSAOKernel::GenNoiseTex()
 
 	// 生成REPEATE形式的铺屏Noise纹理
 	glGenTextures(1, &NoiseTex);
-	glBindTexture(GL_TEXTURE_2D, NoiseTex);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, NoiseTex);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, NoiseSize, NoiseSize, 0, GL_RGB, GL_FLOAT, &ssaoNoise[0]);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -5,84 +5,160 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Shader.h"
+#include "ProgramCache.h"
+#include "ShaderCompileQueue.h"
+#include "../buffer/UniformBuffer.h"
+#include "GLStateCache.h"
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
 {
-	// 从文件路径中获取顶点/片段着色器
-	std::string vertexCode;
-	std::string fragmentCode;
+	Load(vertexPath, fragmentPath, nullptr, ShaderDefines());
+}
 
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+{
+	Load(vertexPath, fragmentPath, geometryPath, ShaderDefines());
+}
 
-	// 保证ifstream对象可以抛出异常：
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	try
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines)
+{
+	Load(vertexPath, fragmentPath, nullptr, defines);
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const ShaderDefines& defines)
+{
+	Load(vertexPath, fragmentPath, geometryPath, defines);
+}
+
+Shader::~Shader()
+{
+	Resolve();
+	GLStateCache::DeleteProgram(this->ID);
+}
+
+void Shader::Use()
+{
+	Resolve();
+	GLStateCache::UseProgram(this->ID);
+}
+
+bool Shader::IsReady()
+{
+	return !bPending || ShaderCompileQueue::IsReady(this);
+}
+
+void Shader::Resolve()
+{
+	if (bPending)
 	{
-		// 打开文件
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-
-		// 读取文件的缓冲内容到数据流中
-		std::stringstream vShaderStream, fShaderStream;
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-
-		// 关闭文件处理器
-		vShaderFile.close();
-		fShaderFile.close();
-
-		// 转换数据流到string
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+		ShaderCompileQueue::Finish(this);
+		bPending = false;
 	}
-	catch (std::ifstream::failure e)
+}
+
+void Shader::Load(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const ShaderDefines& defines)
+{
+	// 各阶段源码经预处理展开#include并插入宏定义, 任一阶段失败时不再查找缓存及编译
+	bool bLoaded = AddStage(GL_VERTEX_SHADER, "VERTEX", vertexPath, defines);
+	if (bLoaded && geometryPath)
 	{
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		bLoaded = AddStage(GL_GEOMETRY_SHADER, "GEOMETRY", geometryPath, defines);
 	}
+	bLoaded = bLoaded && AddStage(GL_FRAGMENT_SHADER, "FRAGMENT", fragmentPath, defines);
 
-	const char* vShaderCode = vertexCode.c_str();
-	const char* fShaderCode = fragmentCode.c_str();
+	if (!bLoaded)
+	{
+		StageList.clear();
+		this->ID = 0;
+		return;
+	}
+	Submit();
+}
 
-	// 创建vertexShader
-	unsigned int vertexShader;
-	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+bool Shader::AddStage(GLenum type, const char* name, const char* path, const ShaderDefines& defines)
+{
+	ShaderStage stage;
+	stage.Type = type;
+	stage.Name = name;
+	if (!ShaderPreprocessor::Load(path, defines, stage.Code, stage.FileList))
+	{
+		std::cout << "ERROR::SHADER::" << name << "::PREPROCESS_FAILED: " << path << std::endl;
+		return false;
+	}
+	StageList.push_back(stage);
+	return true;
+}
 
-	// 绑定源码并编译
-	glShaderSource(vertexShader, 1, &vShaderCode, NULL);
-	glCompileShader(vertexShader);
+void Shader::Submit()
+{
+	// 键按阶段顺序包含阶段名及源码
+	std::vector<std::string> keyList;
+	for (const ShaderStage& stage : StageList)
+	{
+		keyList.push_back(stage.Name);
+		keyList.push_back(stage.Code);
+	}
+	CacheKey = ProgramCache::MakeKey(keyList);
 
-	// vertex编译异常捕获
-	int  success;
-	char infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+	// 优先加载程序二进制缓存, 失败时提交编译
+	this->ID = glCreateProgram();
+	if (ProgramCache::Load(this->ID, CacheKey))
 	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+		StageList.clear();
+		BuildUniformTable();
+		return;
 	}
+	GLStateCache::DeleteProgram(this->ID);
 
-	unsigned int fragmentShader;
-	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fShaderCode, NULL);
-	glCompileShader(fragmentShader);
+	// 编译线程模式下程序对象也在主线程创建, 保证ID立即可用
+	this->ID = glCreateProgram();
+	bPending = true;
+	ShaderCompileQueue::Submit(this);
+}
 
-	// fragment编译异常捕获
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+void Shader::BeginCompile()
+{
+	for (const ShaderStage& stage : StageList)
 	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+		const char* code = stage.Code.c_str();
+
+		GLuint shader = glCreateShader(stage.Type);
+		glShaderSource(shader, 1, &code, NULL);
+		glCompileShader(shader);
+		StageShaderList.push_back(shader);
 	}
 
-	// 创建绘制Program
-	this->ID = glCreateProgram();
+	ProgramCache::PrepareProgram(this->ID);
 
-	// 链接shader
-	glAttachShader(this->ID, vertexShader);
-	glAttachShader(this->ID, fragmentShader);
+	// 链接shader, 不查询状态以免打断驱动的后台编译
+	for (GLuint shader : StageShaderList)
+	{
+		glAttachShader(this->ID, shader);
+	}
 	glLinkProgram(this->ID);
+}
+
+void Shader::FinishCompile()
+{
+	// 编译异常捕获
+	int success;
+	char infoLog[512];
+	for (size_t i = 0; i < StageShaderList.size(); i++)
+	{
+		glGetShaderiv(StageShaderList[i], GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(StageShaderList[i], 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::" << StageList[i].Name << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+
+			// 错误信息中的源码串编号对应的文件
+			const std::vector<std::string>& fileList = StageList[i].FileList;
+			for (size_t f = 0; f < fileList.size() && fileList.size() > 1; f++)
+			{
+				std::cout << f << ": " << fileList[f] << std::endl;
+			}
+		}
+	}
 
 	// 链接异常捕获
 	glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
@@ -90,197 +166,257 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
 		glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
 		std::cout << "ERROR::SHADER::LINK_FAILED\n" << infoLog << std::endl;
 	}
+	else
+	{
+		ProgramCache::Save(this->ID, CacheKey);
+		BuildUniformTable();
+	}
 
 	// 删除Shader缓存
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
+	for (GLuint shader : StageShaderList)
+	{
+		glDeleteShader(shader);
+	}
+	StageShaderList.clear();
+	StageList.clear();
 }
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+void Shader::SetBool(const std::string& name, bool value)
 {
-	// 从文件路径中获取着色器
-	std::string vertexCode;
-	std::string fragmentCode;
-	std::string geometryCode;
-
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
-	std::ifstream gShaderFile;
+	glUniform1i(FindLocation(name), (int)value);
+}
+void Shader::SetInt(const std::string& name, int value)
+{
+	glUniform1i(FindLocation(name), value);
+}
+void Shader::SetFloat(const std::string& name, float value)
+{
+	glUniform1f(FindLocation(name), value);
+}
 
-	// 保证ifstream对象可以抛出异常：
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	gShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	try
-	{
-		// 打开文件
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-		gShaderFile.open(geometryPath);
-
-		// 读取文件的缓冲内容到数据流中
-		std::stringstream vShaderStream, fShaderStream, gShaderStream;
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		gShaderStream << gShaderFile.rdbuf();
-
-		// 关闭文件处理器
-		vShaderFile.close();
-		fShaderFile.close();
-		gShaderFile.close();
-
-		// 转换数据流到string
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-		geometryCode = gShaderStream.str();
-	}
-	catch (std::ifstream::failure e)
-	{
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
-	}
+void Shader::SetVec3(const std::string& name, glm::vec3 value)
+{
+	glUniform3fv(FindLocation(name), 1, glm::value_ptr(value));
+}
 
-	const char* vShaderCode = vertexCode.c_str();
-	const char* fShaderCode = fragmentCode.c_str();
-	const char* gShaderCode = geometryCode.c_str();
+void Shader::SetMat4(const std::string& name, glm::mat4 value)
+{
+	glUniformMatrix4fv(FindLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+}
 
+void Shader::SetMat3(const std::string& name, glm::mat3 value)
+{
+	glUniformMatrix3fv(FindLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+}
 
-	// 创建vertexShader
-	unsigned int vertexShader;
-	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+UniformHandle Shader::GetUniform(const std::string& name)
+{
+	UniformHandle handle;
+	handle.Location = FindLocation(name);
+	return handle;
+}
 
-	// 绑定源码并编译
-	glShaderSource(vertexShader, 1, &vShaderCode, NULL);
-	glCompileShader(vertexShader);
+void Shader::SetBool(UniformHandle handle, bool value) const
+{
+	glUniform1i(handle.Location, (int)value);
+}
+void Shader::SetInt(UniformHandle handle, int value) const
+{
+	glUniform1i(handle.Location, value);
+}
+void Shader::SetFloat(UniformHandle handle, float value) const
+{
+	glUniform1f(handle.Location, value);
+}
 
-	// vertex编译异常捕获
-	int  success;
-	char infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
+void Shader::SetVec3(UniformHandle handle, glm::vec3 value) const
+{
+	glUniform3fv(handle.Location, 1, glm::value_ptr(value));
+}
 
+void Shader::SetMat4(UniformHandle handle, const glm::mat4& value) const
+{
+	glUniformMatrix4fv(handle.Location, 1, GL_FALSE, glm::value_ptr(value));
+}
 
-	unsigned int fragmentShader;
-	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+void Shader::SetMat3(UniformHandle handle, const glm::mat3& value) const
+{
+	glUniformMatrix3fv(handle.Location, 1, GL_FALSE, glm::value_ptr(value));
+}
 
-	glShaderSource(fragmentShader, 1, &fShaderCode, NULL);
-	glCompileShader(fragmentShader);
+void Shader::SetVec3Array(UniformHandle handle, const glm::vec3* value, int count) const
+{
+	glUniform3fv(handle.Location, count, glm::value_ptr(value[0]));
+}
 
-	// fragment编译异常捕获
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+int Shader::ResolveSamplerUnit(const std::string& name)
+{
+	GLint location = FindLocation(name);
+	if (location < 0)
 	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+		return -1;
 	}
 
+	for (size_t unit = 0; unit < SamplerLocationList.size(); unit++)
+	{
+		if (SamplerLocationList[unit] == location)
+		{
+			return (int)unit;
+		}
+	}
 
-	unsigned int geometryShader;
-	geometryShader = glCreateShader(GL_GEOMETRY_SHADER);
-
-	glShaderSource(geometryShader, 1, &gShaderCode, NULL);
-	glCompileShader(geometryShader);
+	// uniform属于程序对象, 写入一次即可
+	int unit = (int)SamplerLocationList.size();
+	SamplerLocationList.push_back(location);
+	GLStateCache::UseProgram(ID);
+	glUniform1i(location, unit);
+	return unit;
+}
 
-	// geometry编译异常捕获
-	glGetShaderiv(geometryShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+// FNV-1a
+static unsigned int HashUniformName(const std::string& name)
+{
+	unsigned int hash = 2166136261u;
+	for (char c : name)
 	{
-		glGetShaderInfoLog(geometryShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::GEOMETRY::COMPILATION_FAILED\n" << infoLog << std::endl;
+		hash ^= (unsigned char)c;
+		hash *= 16777619u;
 	}
+	return hash;
+}
 
+void Shader::BuildUniformTable()
+{
+	GLint uniformCount = 0, maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	// 数组每个元素各占一项, 负载因子不超过0.5
+	std::vector<std::string> nameList;
+	std::vector<char> nameBuffer(maxNameLength + 1);
+	for (GLint i = 0; i < uniformCount; i++)
+	{
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), nullptr, &size, &type, nameBuffer.data());
+
+		std::string name = nameBuffer.data();
+		size_t bracket = name.find("[0]");
+		if (size >= 1 && bracket != std::string::npos && bracket + 3 == name.size())
+		{
+			// 数组只返回"name[0]", 展开为"name"及"name[i]"
+			std::string baseName = name.substr(0, bracket);
+			nameList.push_back(baseName);
+			for (GLint e = 0; e < size; e++)
+			{
+				nameList.push_back(baseName + "[" + std::to_string(e) + "]");
+			}
+		}
+		else
+		{
+			nameList.push_back(name);
+		}
+	}
 
-	// 创建绘制Program
-	this->ID = glCreateProgram();
-
-	// 链接shader
-	glAttachShader(this->ID, vertexShader);
-	glAttachShader(this->ID, geometryShader);
-	glAttachShader(this->ID, fragmentShader);
-	glLinkProgram(this->ID);
+	size_t capacity = 16;
+	while (capacity < nameList.size() * 2)
+	{
+		capacity *= 2;
+	}
+	UniformTable.assign(capacity, UniformSlot());
 
-	// 链接异常捕获
-	glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::LINK_FAILED\n" << infoLog << std::endl;
+	for (const std::string& name : nameList)
+	{
+		// uniform block成员的location为-1, 无需记录
+		GLint location = glGetUniformLocation(ID, name.c_str());
+		if (location >= 0)
+		{
+			AddUniform(name, location);
+		}
 	}
 
-	// 删除Shader缓存
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-	glDeleteShader(geometryShader);
-}
+	// 可能位于编译线程, 不能经由GetUniform等待自身
+	ModelHandle.Location = LookupLocation("model");
 
-Shader::~Shader()
-{
-	glDeleteProgram(this->ID);
+	// 程序二进制加载后block绑定同样需要重新设置
+	UniformBuffer::BindBlocks(ID);
 }
 
-void Shader::Use()
+void Shader::AddUniform(const std::string& name, GLint location)
 {
-	glUseProgram(this->ID);
-}
+	unsigned int hash = HashUniformName(name);
+	size_t mask = UniformTable.size() - 1;
+	size_t index = hash & mask;
+	while (UniformTable[index].Location >= 0)
+	{
+		if (UniformTable[index].Hash == hash && UniformTable[index].Name == name)
+		{
+			return;
+		}
+		index = (index + 1) & mask;
+	}
 
-void Shader::SetBool(const std::string& name, bool value) const
-{
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
-}
-void Shader::SetInt(const std::string& name, int value) const
-{
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-}
-void Shader::SetFloat(const std::string& name, float value) const
-{
-	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+	UniformTable[index].Name = name;
+	UniformTable[index].Hash = hash;
+	UniformTable[index].Location = location;
 }
 
-void Shader::SetVec3(const std::string& name, glm::vec3 value) const
+GLint Shader::FindLocation(const std::string& name)
 {
-	glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+	Resolve();
+	return LookupLocation(name);
 }
 
-void Shader::SetMat4(const std::string& name, glm::mat4 value) const
+GLint Shader::LookupLocation(const std::string& name) const
 {
-	int matLoc = glGetUniformLocation(ID, name.c_str());
-	glUniformMatrix4fv(matLoc, 1, GL_FALSE, glm::value_ptr(value));
-}
+	if (UniformTable.empty())
+	{
+		return -1;
+	}
 
-void Shader::SetMat3(const std::string& name, glm::mat3 value) const
-{
-	int matLoc = glGetUniformLocation(ID, name.c_str());
-	glUniformMatrix3fv(matLoc, 1, GL_FALSE, glm::value_ptr(value));
+	unsigned int hash = HashUniformName(name);
+	size_t mask = UniformTable.size() - 1;
+	size_t index = hash & mask;
+	while (UniformTable[index].Location >= 0)
+	{
+		if (UniformTable[index].Hash == hash && UniformTable[index].Name == name)
+		{
+			return UniformTable[index].Location;
+		}
+		index = (index + 1) & mask;
+	}
+	return -1;
 }
 
 // 平行光参数
-void Shader::SetParaLightParams()
+void Shader::SetParaLightParams(int index)
 {
-	SetVec3("paraLight.direction", glm::vec3(-0.2f, -1.0f, -0.3f));
-	SetVec3("paraLight.ambient", glm::vec3(0.02f, 0.02f, 0.02f));
-	SetVec3("paraLight.diffuse", glm::vec3(0.05f, 0.05f, 0.05f));
-	SetVec3("paraLight.specular", glm::vec3(0.1f, 0.1f, 0.1f));
+	std::string name = "paraLights[" + std::to_string(index) + "].";
+	SetVec3(name + "direction", glm::vec3(-0.2f, -1.0f, -0.3f));
+	SetVec3(name + "ambient", glm::vec3(0.02f, 0.02f, 0.02f));
+	SetVec3(name + "diffuse", glm::vec3(0.05f, 0.05f, 0.05f));
+	SetVec3(name + "specular", glm::vec3(0.1f, 0.1f, 0.1f));
 }
 
 // 点光源静态参数
-void Shader::SetPointLightParams(glm::vec3 LightPos)
+void Shader::SetPointLightParams(glm::vec3 LightPos, int index)
 {
-	SetVec3("pointLight.position", LightPos);
-	SetVec3("pointLight.ambient", glm::vec3(0.2f, 0.2f, 0.2f));
-	SetVec3("pointLight.diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
-	SetVec3("pointLight.specular", glm::vec3(1.0f, 1.0f, 1.0f));
-	SetFloat("pointLight.constant", 1.0f);
-	SetFloat("pointLight.linear", 0.09f);
-	SetFloat("pointLight.quadratic", 0.032f);
+	std::string name = "pointLights[" + std::to_string(index) + "].";
+	SetVec3(name + "position", LightPos);
+	SetVec3(name + "ambient", glm::vec3(0.2f, 0.2f, 0.2f));
+	SetVec3(name + "diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
+	SetVec3(name + "specular", glm::vec3(1.0f, 1.0f, 1.0f));
+	SetFloat(name + "constant", 1.0f);
+	SetFloat(name + "linear", 0.09f);
+	SetFloat(name + "quadratic", 0.032f);
 }
 
 // 投射光静态参数
-void Shader::SetSpotLightParams()
+void Shader::SetSpotLightParams(int index)
 {
-	SetVec3("spotLight.diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
-	SetVec3("spotLight.specular", glm::vec3(1.0f, 1.0f, 1.0f));
-	SetFloat("spotLight.innerCutOff", glm::cos(glm::radians(12.5f)));
-	SetFloat("spotLight.outerCutOff", glm::cos(glm::radians(17.5f)));
-}
+	std::string name = "spotLights[" + std::to_string(index) + "].";
+	SetVec3(name + "diffuse", glm::vec3(0.5f, 0.5f, 0.5f));
+	SetVec3(name + "specular", glm::vec3(1.0f, 1.0f, 1.0f));
+	SetFloat(name + "innerCutOff", glm::cos(glm::radians(12.5f)));
+	SetFloat(name + "outerCutOff", glm::cos(glm::radians(17.5f)));
+}
\ No newline at end of file
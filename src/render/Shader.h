@@ -3,41 +3,141 @@
 #define SHADER_H
 
 #include <glad/glad.h>;
+#include <glm/glm.hpp>
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+#include "ShaderPreprocessor.h"
+
+// uniform句柄, 即链接时反射得到的location, 不存在的uniform为-1(glUniform*会忽略)
+struct UniformHandle {
+	GLint Location = -1;
+};
 
 class Shader
 {
 public:
-    // 程序ID, 即编译链接而成的ShaderProgram
+    // 程序ID, 即编译链接而成的ShaderProgram, 源码预处理失败时为0
     unsigned int ID;
 
+	// 各渲染器通用的Model矩阵句柄, View及Projection位于FrameUniforms
+	UniformHandle ModelHandle;
+
 public:
     // 构造器读取并构建着色器
     Shader(const char* vertexPath, const char* fragmentPath);
 
 	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath);
 
+	// 按宏定义编译变体, 同一组文件的多个变体通常经由ShaderVariants获取
+	Shader(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines);
+
+	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const ShaderDefines& defines);
+
     ~Shader();
 
-    // 使用/激活程序
+    // 使用/激活程序, 编译尚未完成时在此等待
     void Use();
 
-    // uniform工具函数
-    void SetBool(const std::string& name, bool value) const;
-    void SetInt(const std::string& name, int value) const;
-    void SetFloat(const std::string& name, float value) const;
-	void SetVec3(const std::string& name, glm::vec3 value) const;
-	void SetMat4(const std::string& name, glm::mat4 value) const;
-	void SetMat3(const std::string& name, glm::mat3 value) const;
-
-	void SetParaLightParams();
-	void SetPointLightParams(glm::vec3 LightPos);
-	void SetSpotLightParams();
+	// 不阻塞地查询编译是否完成
+	bool IsReady();
+
+	// 等待编译完成并检查结果, 之后ID, 句柄及uniform表可用
+	void Resolve();
+
+    // uniform工具函数, 按名称查找前会等待编译完成
+    void SetBool(const std::string& name, bool value);
+    void SetInt(const std::string& name, int value);
+    void SetFloat(const std::string& name, float value);
+	void SetVec3(const std::string& name, glm::vec3 value);
+	void SetMat4(const std::string& name, glm::mat4 value);
+	void SetMat3(const std::string& name, glm::mat3 value);
+
+	// 按名称查询句柄, 每帧调用的uniform应在初始化时取得句柄后使用下列重载(需已Use()或Resolve())
+	UniformHandle GetUniform(const std::string& name);
+
+	void SetBool(UniformHandle handle, bool value) const;
+	void SetInt(UniformHandle handle, int value) const;
+	void SetFloat(UniformHandle handle, float value) const;
+	void SetVec3(UniformHandle handle, glm::vec3 value) const;
+	void SetMat4(UniformHandle handle, const glm::mat4& value) const;
+	void SetMat3(UniformHandle handle, const glm::mat3& value) const;
+	void SetVec3Array(UniformHandle handle, const glm::vec3* value, int count) const;
+
+	// 材质sampler的纹理单元, 每个程序按首次解析的顺序从0分配并写入uniform, 之后不再改变
+	// 会使本程序成为当前程序; sampler不存在时返回-1. 手动设置的sampler应使用材质单元之后的单元
+	int ResolveSamplerUnit(const std::string& name);
+
+	// 对应Include/Lighting.glsl中的光源数组, 变体未声明该光源时为空操作
+	void SetParaLightParams(int index = 0);
+	void SetPointLightParams(glm::vec3 LightPos, int index = 0);
+	void SetSpotLightParams(int index = 0);
+
+private:
+	friend class ShaderCompileQueue;
+
+	struct ShaderStage {
+		GLenum Type;
+		const char* Name; // 用于错误输出及缓存键
+		std::string Code;
+		std::vector<std::string> FileList; // 源码串编号对应的文件, 用于错误输出
+	};
+
+	// 待编译的各阶段源码, 编译完成后释放
+	std::vector<ShaderStage> StageList;
+
+	std::vector<GLuint> StageShaderList;
+
+	std::string CacheKey;
+
+	// 已提交编译但尚未检查结果
+	bool bPending = false;
+
+	// 提交时的编译模式, 编译线程完成后由队列置位bCompileDone
+	int CompileMode = 0;
+
+	bool bCompileDone = false;
+
+	// geometryPath可为nullptr
+	void Load(const char* vertexPath, const char* fragmentPath, const char* geometryPath, const ShaderDefines& defines);
+
+	// 预处理失败时输出错误并返回false
+	bool AddStage(GLenum type, const char* name, const char* path, const ShaderDefines& defines);
+
+	// 先尝试加载缓存, 否则交给ShaderCompileQueue
+	void Submit();
+
+	// 创建各阶段shader并编译链接, 不查询状态
+	void BeginCompile();
+
+	// 查询编译链接状态, 写入缓存并构建uniform表
+	void FinishCompile();
+
+	// 开放寻址哈希表, 容量为2的幂, 线性探测
+	struct UniformSlot {
+		std::string Name;
+		unsigned int Hash = 0;
+		GLint Location = -1;
+	};
+
+	std::vector<UniformSlot> UniformTable;
+
+	// 已分配的材质sampler location, 下标即纹理单元
+	std::vector<GLint> SamplerLocationList;
+
+	// 链接成功后通过glGetActiveUniform枚举全部active uniform
+	void BuildUniformTable();
+
+	void AddUniform(const std::string& name, GLint location);
+
+	GLint FindLocation(const std::string& name);
+
+	// 不等待编译, 仅查表
+	GLint LookupLocation(const std::string& name) const;
 };
 
 #endif
@@ -0,0 +1,167 @@
+﻿#include <iostream>
+
+#include "ShaderCompileQueue.h"
+#include "Shader.h"
+
+ECompileMode ShaderCompileQueue::PreferredMode = COMPILE_AUTO;
+ECompileMode ShaderCompileQueue::Mode = COMPILE_SYNC;
+RenderContext* ShaderCompileQueue::Context = nullptr;
+SharedContext* ShaderCompileQueue::WorkerContext = nullptr;
+std::thread ShaderCompileQueue::Worker;
+std::mutex ShaderCompileQueue::Mutex;
+std::condition_variable ShaderCompileQueue::JobCondition;
+std::condition_variable ShaderCompileQueue::DoneCondition;
+std::deque<Shader*> ShaderCompileQueue::JobList;
+bool ShaderCompileQueue::bStopWorker = false;
+
+void ShaderCompileQueue::Init(RenderContext* context)
+{
+	Context = context;
+
+	Mode = PreferredMode;
+	if (Mode == COMPILE_AUTO)
+	{
+		Mode = GLAD_GL_KHR_parallel_shader_compile ? COMPILE_PARALLEL : COMPILE_WORKER;
+	}
+
+	if (Mode == COMPILE_PARALLEL && !GLAD_GL_KHR_parallel_shader_compile)
+	{
+		std::cout << "ERROR::SHADER_COMPILE::GL_KHR_parallel_shader_compile not supported, use worker thread" << std::endl;
+		Mode = COMPILE_WORKER;
+	}
+
+	if (Mode == COMPILE_PARALLEL)
+	{
+		// 0xFFFFFFFF表示由驱动决定线程数
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	}
+	else if (Mode == COMPILE_WORKER)
+	{
+		WorkerContext = Context->CreateSharedContext();
+		if (WorkerContext)
+		{
+			bStopWorker = false;
+			Worker = std::thread(WorkerLoop);
+		}
+		else
+		{
+			Mode = COMPILE_SYNC;
+		}
+	}
+
+	const char* modeNameList[] = { "auto", "sync", "parallel", "worker" };
+	std::cout << "Shader compile mode: " << modeNameList[Mode] << std::endl;
+}
+
+void ShaderCompileQueue::Shutdown()
+{
+	if (Worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			bStopWorker = true;
+		}
+		JobCondition.notify_all();
+		Worker.join();
+	}
+
+	if (WorkerContext)
+	{
+		Context->DestroySharedContext(WorkerContext);
+		WorkerContext = nullptr;
+	}
+
+	Context = nullptr;
+	Mode = COMPILE_SYNC;
+}
+
+void ShaderCompileQueue::Submit(Shader* shader)
+{
+	shader->CompileMode = Mode;
+
+	if (Mode == COMPILE_WORKER)
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			shader->bCompileDone = false;
+			JobList.push_back(shader);
+		}
+		JobCondition.notify_one();
+		return;
+	}
+
+	// 并行模式下驱动在后台编译, 直到查询状态时才需要等待
+	shader->BeginCompile();
+	if (Mode == COMPILE_SYNC)
+	{
+		shader->FinishCompile();
+		shader->bPending = false;
+	}
+}
+
+void ShaderCompileQueue::Finish(Shader* shader)
+{
+	if (shader->CompileMode == COMPILE_WORKER)
+	{
+		std::unique_lock<std::mutex> lock(Mutex);
+		DoneCondition.wait(lock, [shader]() { return shader->bCompileDone; });
+	}
+	else
+	{
+		shader->FinishCompile();
+	}
+}
+
+bool ShaderCompileQueue::IsReady(Shader* shader)
+{
+	if (shader->CompileMode == COMPILE_WORKER)
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		return shader->bCompileDone;
+	}
+
+	if (shader->CompileMode == COMPILE_PARALLEL)
+	{
+		GLint bComplete = GL_FALSE;
+		glGetProgramiv(shader->ID, GL_COMPLETION_STATUS_KHR, &bComplete);
+		return bComplete == GL_TRUE;
+	}
+
+	return true;
+}
+
+void ShaderCompileQueue::WorkerLoop()
+{
+	Context->MakeCurrent(WorkerContext);
+
+	while (true)
+	{
+		Shader* shader = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			JobCondition.wait(lock, []() { return bStopWorker || !JobList.empty(); });
+
+			// 退出前完成剩余任务
+			if (JobList.empty())
+			{
+				break;
+			}
+			shader = JobList.front();
+			JobList.pop_front();
+		}
+
+		shader->BeginCompile();
+		shader->FinishCompile();
+
+		// 等待链接真正完成, 主线程重新绑定程序后即可见
+		glFinish();
+
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			shader->bCompileDone = true;
+		}
+		DoneCondition.notify_all();
+	}
+
+	Context->MakeCurrent(nullptr);
+}
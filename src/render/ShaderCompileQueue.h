@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "../app/RenderContext.h"
+
+class Shader;
+
+enum ECompileMode {
+	COMPILE_AUTO,
+	COMPILE_SYNC, // 构造时阻塞编译, 即原先的行为
+	COMPILE_PARALLEL, // GL_KHR_parallel_shader_compile, 驱动后台编译
+	COMPILE_WORKER // 共享上下文的编译线程
+};
+
+// 着色器编译队列, new Shader只提交编译, 首次Use()时才等待结果
+// 场景初始化时应尽早创建全部Shader, 使编译与纹理解码及预计算重叠
+class ShaderCompileQueue
+{
+public:
+
+	// --shader-compile sync|parallel|worker, 默认自动选择
+	static ECompileMode PreferredMode;
+
+	static ECompileMode Mode;
+
+public:
+
+	// 上下文创建后调用, 确定编译模式并按需启动编译线程
+	static void Init(RenderContext* context);
+
+	// 上下文销毁前调用, 完成剩余任务并结束编译线程
+	static void Shutdown();
+
+	static void Submit(Shader* shader);
+
+	// 阻塞直至shader编译完成并检查结果
+	static void Finish(Shader* shader);
+
+	// 不阻塞地查询编译是否完成
+	static bool IsReady(Shader* shader);
+
+private:
+
+	static RenderContext* Context;
+
+	static SharedContext* WorkerContext;
+
+	static std::thread Worker;
+
+	static std::mutex Mutex;
+
+	static std::condition_variable JobCondition;
+
+	static std::condition_variable DoneCondition;
+
+	static std::deque<Shader*> JobList;
+
+	static bool bStopWorker;
+
+private:
+
+	static void WorkerLoop();
+};
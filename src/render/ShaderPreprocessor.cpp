@@ -0,0 +1,175 @@
+﻿#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "ShaderPreprocessor.h"
+
+// 嵌套层数上限, 防止互相包含
+static const int MAX_INCLUDE_DEPTH = 16;
+
+ShaderDefines& ShaderDefines::Set(const std::string& name, const std::string& value)
+{
+	for (std::pair<std::string, std::string>& define : DefineList)
+	{
+		if (define.first == name)
+		{
+			define.second = value;
+			return *this;
+		}
+	}
+	DefineList.push_back(std::make_pair(name, value));
+	return *this;
+}
+
+ShaderDefines& ShaderDefines::Set(const std::string& name, int value)
+{
+	return Set(name, std::to_string(value));
+}
+
+std::string ShaderDefines::GetKey() const
+{
+	std::vector<std::pair<std::string, std::string>> sortedList = DefineList;
+	std::sort(sortedList.begin(), sortedList.end());
+
+	std::string key;
+	for (const std::pair<std::string, std::string>& define : sortedList)
+	{
+		key += define.first + "=" + define.second + ";";
+	}
+	return key;
+}
+
+bool ShaderPreprocessor::Load(const std::string& path, const ShaderDefines& defines, std::string& code, std::vector<std::string>& fileList)
+{
+	code.clear();
+	fileList.clear();
+	if (!Expand(ResolvePath("", path), code, fileList, 0))
+	{
+		return false;
+	}
+
+	if (defines.DefineList.empty())
+	{
+		return true;
+	}
+
+	// #version必须位于最前, 宏定义插入其后
+	size_t versionPos = code.find("#version");
+	size_t insertPos = versionPos == std::string::npos ? 0 : code.find('\n', versionPos);
+	insertPos = insertPos == std::string::npos ? code.size() : insertPos + 1;
+
+	std::string defineCode;
+	for (const std::pair<std::string, std::string>& define : defines.DefineList)
+	{
+		defineCode += "#define " + define.first + " " + define.second + "\n";
+	}
+	int nextLine = (int)std::count(code.begin(), code.begin() + insertPos, '\n') + 1;
+	defineCode += "#line " + std::to_string(nextLine) + " 0\n";
+
+	code.insert(insertPos, defineCode);
+	return true;
+}
+
+bool ShaderPreprocessor::Expand(const std::string& path, std::string& code, std::vector<std::string>& fileList, int depth)
+{
+	if (depth > MAX_INCLUDE_DEPTH)
+	{
+		std::cout << "ERROR::SHADER::INCLUDE_TOO_DEEP: " << path << std::endl;
+		return false;
+	}
+
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << path << std::endl;
+		return false;
+	}
+	std::stringstream stream;
+	stream << file.rdbuf();
+	std::string source = stream.str();
+
+	// 去除UTF-8 BOM, Mesa等驱动的GLSL预处理器不接受BOM
+	if (source.size() >= 3 && source.compare(0, 3, "\xEF\xBB\xBF") == 0)
+	{
+		source.erase(0, 3);
+	}
+
+	int fileIndex = (int)fileList.size();
+	fileList.push_back(path);
+	if (fileIndex > 0)
+	{
+		code += "#line 1 " + std::to_string(fileIndex) + "\n";
+	}
+
+	size_t slash = path.find_last_of("/\\");
+	std::string dir = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+	std::istringstream lineStream(source);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(lineStream, line))
+	{
+		lineNumber++;
+
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+		{
+			code += line + "\n";
+			continue;
+		}
+
+		size_t nameBegin = line.find('"', start);
+		size_t nameEnd = nameBegin == std::string::npos ? std::string::npos : line.find('"', nameBegin + 1);
+		if (nameEnd == std::string::npos)
+		{
+			std::cout << "ERROR::SHADER::INCLUDE_SYNTAX: " << path << "(" << lineNumber << ")" << std::endl;
+			return false;
+		}
+
+		std::string includePath = ResolvePath(dir, line.substr(nameBegin + 1, nameEnd - nameBegin - 1));
+		if (std::find(fileList.begin(), fileList.end(), includePath) != fileList.end())
+		{
+			// 已展开过, 保留空行使行号不变
+			code += "\n";
+			continue;
+		}
+
+		if (!Expand(includePath, code, fileList, depth + 1))
+		{
+			return false;
+		}
+		code += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+	}
+	return true;
+}
+
+std::string ShaderPreprocessor::ResolvePath(const std::string& dir, const std::string& name)
+{
+	std::string fullPath = dir + name;
+	std::replace(fullPath.begin(), fullPath.end(), '\\', '/');
+
+	std::vector<std::string> partList;
+	std::stringstream stream(fullPath);
+	std::string part;
+	while (std::getline(stream, part, '/'))
+	{
+		if (part.empty() || part == ".")
+		{
+			continue;
+		}
+		if (part == ".." && !partList.empty() && partList.back() != "..")
+		{
+			partList.pop_back();
+			continue;
+		}
+		partList.push_back(part);
+	}
+
+	std::string result = fullPath.size() > 0 && fullPath[0] == '/' ? "/" : "";
+	for (size_t i = 0; i < partList.size(); i++)
+	{
+		result += (i > 0 ? "/" : "") + partList[i];
+	}
+	return result;
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// 编译期宏定义, 同一组源文件配合不同的宏生成着色器变体
+struct ShaderDefines {
+	std::vector<std::pair<std::string, std::string>> DefineList;
+
+	// 同名宏覆盖之前的值
+	ShaderDefines& Set(const std::string& name, const std::string& value = "1");
+	ShaderDefines& Set(const std::string& name, int value);
+
+	// 按名称排序后拼接, 与Set的顺序无关, 用作变体键
+	std::string GetKey() const;
+};
+
+// 着色器源码预处理, 展开#include "file"(相对当前文件, 每个文件只展开一次), 并在#version之后插入宏定义
+// 展开时插入#line, 错误信息中的源码串编号对应fileList下标
+class ShaderPreprocessor
+{
+public:
+
+	// 失败时输出错误并返回false
+	static bool Load(const std::string& path, const ShaderDefines& defines, std::string& code, std::vector<std::string>& fileList);
+
+private:
+
+	static bool Expand(const std::string& path, std::string& code, std::vector<std::string>& fileList, int depth);
+
+	// 拼接目录并消去"."及".."
+	static std::string ResolvePath(const std::string& dir, const std::string& name);
+};
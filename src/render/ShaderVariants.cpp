@@ -0,0 +1,38 @@
+﻿#include "ShaderVariants.h"
+
+ShaderVariants::ShaderVariants(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+{
+	VertexPath = vertexPath;
+	FragmentPath = fragmentPath;
+	GeometryPath = geometryPath ? geometryPath : "";
+}
+
+ShaderVariants::~ShaderVariants()
+{
+	for (auto& variant : VariantMap)
+	{
+		delete variant.second;
+	}
+	VariantMap.clear();
+}
+
+Shader* ShaderVariants::Get(const ShaderDefines& defines)
+{
+	std::string key = defines.GetKey();
+
+	auto it = VariantMap.find(key);
+	if (it != VariantMap.end())
+	{
+		return it->second;
+	}
+
+	const char* geometryPath = GeometryPath.empty() ? nullptr : GeometryPath.c_str();
+	Shader* variant = new Shader(VertexPath.c_str(), FragmentPath.c_str(), geometryPath, defines);
+	VariantMap[key] = variant;
+	return variant;
+}
+
+size_t ShaderVariants::GetCount() const
+{
+	return VariantMap.size();
+}
@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "Shader.h"
+
+// 同一组着色器文件的宏定义变体, 首次Get时才提交编译, 之后按宏定义键缓存
+// 例如按光源数量取得只包含所需光照计算的变体, 而非在一个shader中动态分支
+class ShaderVariants
+{
+public:
+
+	// geometryPath可为nullptr
+	ShaderVariants(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
+
+	~ShaderVariants();
+
+	// 返回的Shader归ShaderVariants所有, 不可delete
+	Shader* Get(const ShaderDefines& defines);
+
+	size_t GetCount() const;
+
+private:
+
+	std::string VertexPath;
+
+	std::string FragmentPath;
+
+	std::string GeometryPath;
+
+	std::unordered_map<std::string, Shader*> VariantMap;
+};
@@ -6,96 +6,17 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "SimpleRender.h"
+#include "../app/Profiler.h"
+#include "GLStateCache.h"
 
 SimpleRender::SimpleRender()
 {
 
 }
 
-SimpleRender::SimpleRender(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize)
-{
-	BindVertexList(AttriDivisor, VertexList, VertexSize);
-}
-
-SimpleRender::SimpleRender(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize, unsigned int IndicesList[], unsigned int IndicesSize)
-{
-	BindVertexList(AttriDivisor, VertexList, VertexSize, IndicesList, IndicesSize);
-}
-
-void SimpleRender::BindVertexList(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize)
-{
-	// 创建VAO并绑定
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	// 创建VBO并把顶点数组复制到缓冲中供OpenGL使用
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, VertexSize, VertexList, GL_STATIC_DRAW);
-
-	int totalAttriNum = SetVertexAttri(AttriDivisor);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	unsigned singleVertSize = totalAttriNum * sizeof(float);
-	VertNum = VertexSize / singleVertSize;
-}
-
-void SimpleRender::BindVertexList(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize, unsigned int IndicesList[], unsigned int IndicesSize)
-{
-	// 创建VAO并绑定
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	// 创建VBO并把顶点数组复制到缓冲中供OpenGL使用
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, VertexSize, VertexList, GL_STATIC_DRAW);
-
-	// 创建EBO并复制到缓冲
-	glGenBuffers(1, &EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndicesSize, IndicesList, GL_STATIC_DRAW);
-
-	int totalAttriNum = SetVertexAttri(AttriDivisor);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	unsigned singleVertSize = totalAttriNum * sizeof(float);
-	VertNum = VertexSize / singleVertSize;
-
-	IndicesNum = IndicesSize / sizeof(float);
-}
-
-
-int SimpleRender::SetVertexAttri(std::vector<int> AttriDivisor)
-{
-	int totalAttriNum = 0;
-	for (int i = 0; i < AttriDivisor.size(); i++)
-	{
-		totalAttriNum += AttriDivisor[i];
-	}
-
-	int startPos = 0;
-	for (int i = 0; i < AttriDivisor.size(); i++)
-	{
-		glVertexAttribPointer(i, AttriDivisor[i], GL_FLOAT, GL_FALSE, totalAttriNum * sizeof(float), (void*)(startPos * sizeof(float)));
-		glEnableVertexAttribArray(i);
-
-		startPos += AttriDivisor[i];
-	}
-
-	return totalAttriNum;
-}
-
-
 SimpleRender::~SimpleRender()
 {
-	glDeleteVertexArrays(1, &this->VAO);
-	glDeleteBuffers(1, &this->VBO);
-	glDeleteBuffers(1, &this->EBO);
+	GeometryArena::Free(Geometry);
 }
 
 void SimpleRender::BindTexture(unsigned int Texture)
@@ -112,13 +33,13 @@ void SimpleRender::ActiveBindedTextures()
 {
 	for (int i = 0; i < TexList.size(); i++)
 	{
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, TexList.at(i));
+		GLStateCache::ActiveTexture(GL_TEXTURE0 + i);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, TexList.at(i));
 	}
 
 	if (CubeMapID > 0)
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, CubeMapID);
+		GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, CubeMapID);
 	}
 }
 
@@ -139,19 +60,10 @@ void SimpleRender::Draw(bool bPolygonMode)
 	}
 }
 
-void SimpleRender::Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::mat4 projection)
+void SimpleRender::Draw(Shader* shader, glm::mat4 model)
 {
-	// Model矩阵
-	int modelLoc = glGetUniformLocation(shader->ID, "model");
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-	// View矩阵
-	int viewLoc = glGetUniformLocation(shader->ID, "view");
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-
-	// Projection矩阵
-	int projectionLoc = glGetUniformLocation(shader->ID, "projection");
-	glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+	// Model矩阵, 句柄在Shader链接时取得, View及Projection位于每帧上传的FrameUniforms
+	shader->SetMat4(shader->ModelHandle, model);
 
 	DrawShape();
 }
@@ -159,16 +71,6 @@ void SimpleRender::Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::ma
 // 仅绘制顶点
 void SimpleRender::DrawShape()
 {
-	glBindVertexArray(VAO);
-
-	if (IndicesNum > 0)
-	{
-		glDrawElements(GL_TRIANGLES, IndicesNum, GL_UNSIGNED_INT, 0);
-	}
-	else
-	{
-		glDrawArrays(GL_TRIANGLES, 0, VertNum);
-	}
-
-	glBindVertexArray(0);
+	GeometryArena::Draw(Geometry, GL_TRIANGLES);
+	Profiler::Get().AddDrawCall();
 }
@@ -10,6 +10,8 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Shader.h"
+#include "VertexLayout.h"
+#include "../buffer/GeometryArena.h"
 
 class SimpleRender
 {
@@ -17,15 +19,28 @@ public:
 	
 	SimpleRender();
 
-	SimpleRender(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize, unsigned int IndicesList[], unsigned int IndicesSize);
+	// Layout为VertexLayout, 仅用于推导类型, 如SimpleRender(PosNormalTexLayout(), ...)
+	template<typename Layout>
+	SimpleRender(Layout layout, float VertexList[], unsigned int VertexSize, unsigned int IndicesList[], unsigned int IndicesSize)
+	{
+		BindVertexList(layout, VertexList, VertexSize, IndicesList, IndicesSize);
+	}
 
-	SimpleRender(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize);
+	template<typename Layout>
+	SimpleRender(Layout layout, float VertexList[], unsigned int VertexSize)
+	{
+		BindVertexList(layout, VertexList, VertexSize, nullptr, 0);
+	}
 
 	~SimpleRender();
 
-	void BindVertexList(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize);
-
-	void BindVertexList(std::vector<int> AttriDivisor, float VertexList[], unsigned int VertexSize, unsigned int IndicesList[], unsigned int IndicesSize);
+	// VertexSize及IndicesSize为字节数, 数据上传至GeometryArena中Layout对应的顶点缓冲
+	template<typename Layout>
+	void BindVertexList(Layout layout, float VertexList[], unsigned int VertexSize, unsigned int IndicesList[] = nullptr, unsigned int IndicesSize = 0)
+	{
+		GeometryArena::Free(Geometry);
+		Geometry = GeometryArena::Allocate<Layout>(VertexList, VertexSize / Layout::Stride, IndicesList, IndicesSize / sizeof(unsigned int), GL_UNSIGNED_INT);
+	}
 
 	void BindTexture(unsigned int Texture);
 
@@ -35,15 +50,10 @@ public:
 
 	void DrawShape();
 
-	virtual void Draw(Shader* shader, glm::mat4 model, glm::mat4 view, glm::mat4 projection);
+	virtual void Draw(Shader* shader, glm::mat4 model);
 
 
 public:
-	unsigned int VAO;
-
-	unsigned int VBO;
-
-	unsigned int EBO;
 
 	std::vector<unsigned int> TexList;
 
@@ -51,11 +61,8 @@ public:
 
 private:
 
-	unsigned int VertNum = 0;
-
-	unsigned int IndicesNum = 0;
+	// 同一布局的渲染器共用arena中的VAO
+	GeometryRange Geometry;
 
 	void ActiveBindedTextures();
-
-	int SetVertexAttri(std::vector<int> AttriDivisor);
 };
@@ -1,4 +1,5 @@
 ﻿#include "SphereRender.h"
+#include "../app/Profiler.h"
 
 const float PI = 3.14159265359f;
 
@@ -83,47 +84,28 @@ void SphereRender::SetupMesh()
 		}
 	}
 
-	// 绑定顶点缓冲
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
-
-	glGenBuffers(1, &EBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexCount * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-	unsigned int stride = (3 + 2 + 3) * sizeof(float);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+	// 位置, 法线, 纹理坐标
+	Geometry = GeometryArena::Allocate<PosNormalTexLayout>(data.data(), (unsigned int)positions.size(), indices.data(), IndexCount, GL_UNSIGNED_INT);
 }
 
-void SphereRender::Draw(Shader* shader, glm::mat4 modelMatrix, glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
+void SphereRender::Draw(Shader* shader, glm::mat4 modelMatrix)
 {
-	// Model矩阵
-	int modelLoc = glGetUniformLocation(shader->ID, "model");
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-
-	// View矩阵
-	int viewLoc = glGetUniformLocation(shader->ID, "view");
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(viewMatrix));
-
-	// Projection矩阵
-	int projectionLoc = glGetUniformLocation(shader->ID, "projection");
-	glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
-
-	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLE_STRIP, IndexCount, GL_UNSIGNED_INT, 0);
+	// Model矩阵, 句柄在Shader链接时取得, View及Projection位于每帧上传的FrameUniforms
+	shader->SetMat4(shader->ModelHandle, modelMatrix);
 
-	glBindVertexArray(0);
+	GeometryArena::Draw(Geometry, GL_TRIANGLE_STRIP);
+	Profiler::Get().AddDrawCall();
 }
 
+void SphereRender::DrawInstanced(Shader* shader, const InstanceBuffer* instances)
+{
+	if (instances->GetCount() == 0)
+	{
+		return;
+	}
 
+	shader->SetMat4(shader->ModelHandle, glm::mat4(1.0f));
 
-
+	GeometryArena::DrawInstanced(Geometry, GL_TRIANGLE_STRIP, instances);
+	Profiler::Get().AddDrawCall();
+}
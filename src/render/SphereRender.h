@@ -10,6 +10,9 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "Shader.h"
+#include "VertexLayout.h"
+#include "../buffer/InstanceBuffer.h"
+#include "../buffer/GeometryArena.h"
 
 class SphereRender
 {
@@ -27,15 +30,15 @@ public:
 
 	SphereRender(float InRadius = 1.0f, GLuint InXSegments = 64, GLuint InYSegments = 64);
 
-	void Draw(Shader* shader, glm::mat4 modelMatrix, glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
+	void Draw(Shader* shader, glm::mat4 modelMatrix);
 
-private:
-
-	GLuint VAO;
+	// shader需为INSTANCED变体, 各实例的变换取自instances
+	void DrawInstanced(Shader* shader, const InstanceBuffer* instances);
 
-	GLuint VBO;
+private:
 
-	GLuint EBO;
+	// 与其他PosNormalTexLayout渲染器共用arena中的VAO
+	GeometryRange Geometry;
 
 private:
 
@@ -0,0 +1,90 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// 单个顶点属性, 编译期给出GL类型, 分量数, 是否归一化及占用字节数
+// ComponentCount为0时仅占位(对齐填充), 不占用属性位置
+template<GLenum Type, int Count, GLboolean Normalized, size_t Size>
+struct VertexAttr {
+	static constexpr GLenum GLType = Type;
+	static constexpr int ComponentCount = Count;
+	static constexpr GLboolean bNormalized = Normalized;
+	static constexpr size_t ByteSize = Size;
+};
+
+template<int Count>
+using AttrFloat = VertexAttr<GL_FLOAT, Count, GL_FALSE, Count * sizeof(float)>;
+
+template<int Count>
+using AttrHalf = VertexAttr<GL_HALF_FLOAT, Count, GL_FALSE, Count * sizeof(unsigned short)>;
+
+// 有符号16位整数, 读取时归一化到[-1, 1]
+template<int Count>
+using AttrSnorm16 = VertexAttr<GL_SHORT, Count, GL_TRUE, Count * sizeof(short)>;
+
+// GL_INT_2_10_10_10_REV, 归一化后xyz为[-1, 1], w为{-1, 0, 1}
+using AttrPacked1010102 = VertexAttr<GL_INT_2_10_10_10_REV, 4, GL_TRUE, 4>;
+
+template<size_t Size>
+using AttrPadding = VertexAttr<GL_NONE, 0, GL_FALSE, Size>;
+
+
+// 交错顶点布局, 属性位置从Bind的firstLocation起依次分配, 步长及偏移均在编译期确定
+// 例: VertexLayout<AttrFloat<3>, AttrFloat<3>, AttrFloat<2>>::Bind()
+template<typename... Attrs>
+struct VertexLayout;
+
+template<>
+struct VertexLayout<> {
+	static constexpr size_t Stride = 0;
+	static constexpr int AttributeCount = 0;
+
+	static constexpr size_t Offset(size_t)
+	{
+		return 0;
+	}
+
+	static void BindFrom(GLuint, size_t, GLsizei, GLuint)
+	{
+	}
+};
+
+template<typename First, typename... Rest>
+struct VertexLayout<First, Rest...> {
+	static constexpr size_t Stride = First::ByteSize + VertexLayout<Rest...>::Stride;
+	static constexpr int AttributeCount = (First::ComponentCount > 0 ? 1 : 0) + VertexLayout<Rest...>::AttributeCount;
+
+	// 第index个属性(含占位)的字节偏移
+	static constexpr size_t Offset(size_t index)
+	{
+		return index == 0 ? 0 : First::ByteSize + VertexLayout<Rest...>::Offset(index - 1);
+	}
+
+	// 对当前绑定的VAO及GL_ARRAY_BUFFER设置全部属性, divisor非0时为逐实例属性
+	static void Bind(GLuint firstLocation = 0, GLuint divisor = 0)
+	{
+		BindFrom(firstLocation, 0, (GLsizei)Stride, divisor);
+	}
+
+	static void BindFrom(GLuint location, size_t offset, GLsizei stride, GLuint divisor)
+	{
+		if (First::ComponentCount > 0)
+		{
+			glEnableVertexAttribArray(location);
+			glVertexAttribPointer(location, First::ComponentCount, First::GLType, First::bNormalized, stride, (void*)offset);
+			if (divisor > 0)
+			{
+				glVertexAttribDivisor(location, divisor);
+			}
+		}
+		VertexLayout<Rest...>::BindFrom(location + (First::ComponentCount > 0 ? 1 : 0), offset + First::ByteSize, stride, divisor);
+	}
+};
+
+// 常用布局, 与Data.h中的顶点数组及Vertex结构对应
+typedef VertexLayout<AttrFloat<3>> PosLayout;
+typedef VertexLayout<AttrFloat<2>, AttrFloat<2>> Pos2TexLayout;
+typedef VertexLayout<AttrFloat<3>, AttrFloat<2>> PosTexLayout;
+typedef VertexLayout<AttrFloat<3>, AttrFloat<3>, AttrFloat<2>> PosNormalTexLayout;
+typedef VertexLayout<AttrFloat<3>, AttrFloat<3>, AttrFloat<2>, AttrFloat<3>, AttrFloat<3>> PosNormalTexTBNLayout;
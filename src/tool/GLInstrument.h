@@ -0,0 +1,43 @@
+#pragma once
+
+// GL调用计数, 定义GL_INSTRUMENT编译时glad.c在加载入口后将下列函数指针替换为计数包装
+// 未定义时不生成包装, 调用直接走驱动入口, 无额外开销
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum EGLCallType {
+	GL_CALL_DRAW, // glDraw*, glMultiDraw*
+	GL_CALL_PROGRAM, // glUseProgram
+	GL_CALL_VERTEX_ARRAY, // glBindVertexArray, 含解绑
+	GL_CALL_TEXTURE, // glBindTexture
+	GL_CALL_BUFFER, // glBindBuffer, glBindBufferBase, glBindBufferRange
+	GL_CALL_FRAMEBUFFER, // glBindFramebuffer
+	GL_CALL_UNIFORM, // glUniform*, glUniformMatrix*
+	GL_CALL_UPLOAD, // glBufferData, glBufferSubData
+	GL_CALL_STATE, // glEnable, glDisable, glActiveTexture, 混合/深度/面剔除/视口等
+	GL_CALL_REDUNDANT, // 上述绑定中与当前绑定相同的程序, VAO及纹理, 同时计入对应类别
+	GL_CALL_TYPE_COUNT
+};
+
+typedef struct GLCallStats {
+	unsigned int Count[GL_CALL_TYPE_COUNT];
+} GLCallStats;
+
+#ifdef GL_INSTRUMENT
+
+// 自加载起单调递增, Profiler在帧及Pass首尾取差值; 只在主线程的上下文中有意义
+extern GLCallStats glad_call_stats;
+
+// JSON及控制台输出用的类别名
+extern const char* const glad_call_type_name[GL_CALL_TYPE_COUNT];
+
+// 由gladLoadGLLoader在加载完成后调用, 重新加载时重置绑定记录
+void gladInstallInstrument(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,6 +5,7 @@
 
 #include "TextureLoader.h"
 #include "stb_image.h"
+#include "../render/GLStateCache.h"
 
 using namespace std;
 
@@ -35,7 +36,7 @@ unsigned int TextureLoader::LoadTexture(char* ImagePath, bool bFlip)
 		else if (nrChannels == 4)
 			format = GL_RGBA;
 
-		glBindTexture(GL_TEXTURE_2D, TextureID);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, TextureID);
 		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -88,7 +89,7 @@ unsigned int TextureLoader::LoadTextureWithChannel(char* ImagePath, int channelC
 		else if (channelCount == 4)
 			format = GL_RGBA;
 
-		glBindTexture(GL_TEXTURE_2D, TextureID);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, TextureID);
 		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -117,7 +118,7 @@ unsigned int TextureLoader::LoadCubeMap(std::vector<std::string> faceList)
 	// 生成CubeMap纹理并绑定
 	unsigned int textureID;
 	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+	GLStateCache::BindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
 	// 遍历加载CubeMap
 	int width, height, nrChannels;
@@ -157,7 +158,7 @@ unsigned int TextureLoader::LoadHDRTexture(char* ImagePath)
 	if (data)
 	{
 		glGenTextures(1, &hdrTexture);
-		glBindTexture(GL_TEXTURE_2D, hdrTexture);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, hdrTexture);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -0,0 +1,106 @@
+﻿#include "ThreadPool.h"
+
+int ThreadPool::ThreadCount = 0;
+
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool pool(ThreadCount > 0 ? ThreadCount : (int)std::thread::hardware_concurrency());
+	return pool;
+}
+
+ThreadPool::ThreadPool(int threadCount)
+	: NextIndex(0)
+{
+	for (int i = 1; i < threadCount; i++)
+	{
+		WorkerList.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		bStop = true;
+	}
+	JobCondition.notify_all();
+
+	for (std::thread& worker : WorkerList)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// 无工作线程或只有一项时直接在调用线程执行
+	if (WorkerList.empty() || count == 1)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Job = &job;
+		JobCount = count;
+		NextIndex = 0;
+		BusyCount = (int)WorkerList.size();
+		Generation++;
+	}
+	JobCondition.notify_all();
+
+	RunJob();
+
+	// 等待所有工作线程离开本批次, 之后job才可析构
+	std::unique_lock<std::mutex> lock(Mutex);
+	DoneCondition.wait(lock, [this]() { return BusyCount == 0; });
+	Job = nullptr;
+}
+
+int ThreadPool::GetThreadCount() const
+{
+	return (int)WorkerList.size() + 1;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned int lastGeneration = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			JobCondition.wait(lock, [&]() { return bStop || Generation != lastGeneration; });
+			if (bStop)
+			{
+				return;
+			}
+			lastGeneration = Generation;
+		}
+
+		RunJob();
+
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			BusyCount--;
+		}
+		DoneCondition.notify_one();
+	}
+}
+
+void ThreadPool::RunJob()
+{
+	size_t index;
+	while ((index = NextIndex++) < JobCount)
+	{
+		(*Job)(index);
+	}
+}
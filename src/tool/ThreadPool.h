@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// CPU任务线程池, 仅用于不调用GL的工作(网格转换, 图片解码等), GL上传留在上下文线程
+// 首次使用时创建, 工作线程数为ThreadCount - 1, 调用线程同时参与执行
+class ThreadPool
+{
+public:
+
+	// --load-threads N, 0为硬件线程数
+	static int ThreadCount;
+
+public:
+
+	static ThreadPool& Get();
+
+	~ThreadPool();
+
+	// 对[0, count)每个下标执行一次job, 返回时全部完成; 不可在job内嵌套调用
+	void ParallelFor(size_t count, const std::function<void(size_t)>& job);
+
+	int GetThreadCount() const;
+
+private:
+
+	std::vector<std::thread> WorkerList;
+
+	std::mutex Mutex;
+
+	std::condition_variable JobCondition;
+
+	std::condition_variable DoneCondition;
+
+	// 当前批次, 由Mutex保护发布, 下标由NextIndex原子领取
+	const std::function<void(size_t)>* Job = nullptr;
+
+	size_t JobCount = 0;
+
+	std::atomic<size_t> NextIndex;
+
+	// 尚未完成当前批次的工作线程数
+	int BusyCount = 0;
+
+	unsigned int Generation = 0;
+
+	bool bStop = false;
+
+private:
+
+	ThreadPool(int threadCount);
+
+	void WorkerLoop();
+
+	void RunJob();
+};
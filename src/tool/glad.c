@@ -7,22 +7,27 @@
     APIs: gl=3.3
     Profile: compatibility
     Extensions:
-        
+        GL_ARB_ES3_compatibility,
+        GL_ARB_draw_indirect,
+        GL_ARB_get_program_binary,
+        GL_ARB_multi_draw_indirect,
+        GL_KHR_parallel_shader_compile
     Loader: True
     Local files: False
     Omit khrplatform: False
     Reproducible: False
 
     Commandline:
-        --profile="compatibility" --api="gl=3.3" --generator="c" --spec="gl" --extensions=""
+        --profile="compatibility" --api="gl=3.3" --generator="c" --spec="gl" --extensions="GL_ARB_ES3_compatibility,GL_ARB_draw_indirect,GL_ARB_get_program_binary,GL_ARB_multi_draw_indirect,GL_KHR_parallel_shader_compile"
     Online:
-        https://glad.dav1d.de/#profile=compatibility&language=c&specification=gl&loader=on&api=gl%3D3.3
+        https://glad.dav1d.de/#profile=compatibility&language=c&specification=gl&loader=on&api=gl%3D3.3&extensions=GL_ARB_ES3_compatibility&extensions=GL_ARB_draw_indirect&extensions=GL_ARB_get_program_binary&extensions=GL_ARB_multi_draw_indirect&extensions=GL_KHR_parallel_shader_compile
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <glad/glad.h>
+#include "GLInstrument.h"
 
 static void* get_proc(const char *namez);
 
@@ -267,6 +272,11 @@ int GLAD_GL_VERSION_3_0 = 0;
 int GLAD_GL_VERSION_3_1 = 0;
 int GLAD_GL_VERSION_3_2 = 0;
 int GLAD_GL_VERSION_3_3 = 0;
+int GLAD_GL_ARB_ES3_compatibility = 0;
+int GLAD_GL_ARB_draw_indirect = 0;
+int GLAD_GL_ARB_get_program_binary = 0;
+int GLAD_GL_ARB_multi_draw_indirect = 0;
+int GLAD_GL_KHR_parallel_shader_compile = 0;
 PFNGLACCUMPROC glad_glAccum = NULL;
 PFNGLACTIVETEXTUREPROC glad_glActiveTexture = NULL;
 PFNGLALPHAFUNCPROC glad_glAlphaFunc = NULL;
@@ -991,6 +1001,14 @@ PFNGLWINDOWPOS3IPROC glad_glWindowPos3i = NULL;
 PFNGLWINDOWPOS3IVPROC glad_glWindowPos3iv = NULL;
 PFNGLWINDOWPOS3SPROC glad_glWindowPos3s = NULL;
 PFNGLWINDOWPOS3SVPROC glad_glWindowPos3sv = NULL;
+PFNGLDRAWARRAYSINDIRECTPROC glad_glDrawArraysIndirect = NULL;
+PFNGLDRAWELEMENTSINDIRECTPROC glad_glDrawElementsIndirect = NULL;
+PFNGLGETPROGRAMBINARYPROC glad_glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glad_glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glad_glProgramParameteri = NULL;
+PFNGLMULTIDRAWARRAYSINDIRECTPROC glad_glMultiDrawArraysIndirect = NULL;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect = NULL;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR = NULL;
 static void load_GL_VERSION_1_0(GLADloadproc load) {
 	if(!GLAD_GL_VERSION_1_0) return;
 	glad_glCullFace = (PFNGLCULLFACEPROC)load("glCullFace");
@@ -1754,9 +1772,33 @@ static void load_GL_VERSION_3_3(GLADloadproc load) {
 	glad_glSecondaryColorP3ui = (PFNGLSECONDARYCOLORP3UIPROC)load("glSecondaryColorP3ui");
 	glad_glSecondaryColorP3uiv = (PFNGLSECONDARYCOLORP3UIVPROC)load("glSecondaryColorP3uiv");
 }
+static void load_GL_ARB_draw_indirect(GLADloadproc load) {
+	if(!GLAD_GL_ARB_draw_indirect) return;
+	glad_glDrawArraysIndirect = (PFNGLDRAWARRAYSINDIRECTPROC)load("glDrawArraysIndirect");
+	glad_glDrawElementsIndirect = (PFNGLDRAWELEMENTSINDIRECTPROC)load("glDrawElementsIndirect");
+}
+static void load_GL_ARB_get_program_binary(GLADloadproc load) {
+	if(!GLAD_GL_ARB_get_program_binary) return;
+	glad_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+	glad_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+	glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+}
+static void load_GL_ARB_multi_draw_indirect(GLADloadproc load) {
+	if(!GLAD_GL_ARB_multi_draw_indirect) return;
+	glad_glMultiDrawArraysIndirect = (PFNGLMULTIDRAWARRAYSINDIRECTPROC)load("glMultiDrawArraysIndirect");
+	glad_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)load("glMultiDrawElementsIndirect");
+}
+static void load_GL_KHR_parallel_shader_compile(GLADloadproc load) {
+	if(!GLAD_GL_KHR_parallel_shader_compile) return;
+	glad_glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsKHR");
+}
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
-	(void)&has_ext;
+	GLAD_GL_ARB_ES3_compatibility = has_ext("GL_ARB_ES3_compatibility");
+	GLAD_GL_ARB_draw_indirect = has_ext("GL_ARB_draw_indirect");
+	GLAD_GL_ARB_get_program_binary = has_ext("GL_ARB_get_program_binary");
+	GLAD_GL_ARB_multi_draw_indirect = has_ext("GL_ARB_multi_draw_indirect");
+	GLAD_GL_KHR_parallel_shader_compile = has_ext("GL_KHR_parallel_shader_compile");
 	free_exts();
 	return 1;
 }
@@ -1815,6 +1857,255 @@ static void find_coreGL(void) {
 	}
 }
 
+#ifdef GL_INSTRUMENT
+/* GL调用计数包装, 见GLInstrument.h */
+
+GLCallStats glad_call_stats;
+
+const char* const glad_call_type_name[GL_CALL_TYPE_COUNT] = {
+	"draw", "program", "vertex_array", "texture", "buffer", "framebuffer", "uniform", "upload", "state", "redundant"
+};
+
+/* 超出范围的纹理单元不判断冗余 */
+#define GLI_MAX_TEXTURE_UNIT 32
+
+static GLuint gli_program;
+static GLuint gli_vertex_array;
+static GLuint gli_active_unit;
+static GLenum gli_texture_target[GLI_MAX_TEXTURE_UNIT];
+static GLuint gli_texture[GLI_MAX_TEXTURE_UNIT];
+
+/* 计数后转发给驱动入口, 按参数个数展开 */
+#define GLI_WRAP1(type, name, T1) \
+	static void (APIENTRYP gli_real_##name)(T1); \
+	static void APIENTRY gli_##name(T1 a) { glad_call_stats.Count[type]++; gli_real_##name(a); }
+#define GLI_WRAP2(type, name, T1, T2) \
+	static void (APIENTRYP gli_real_##name)(T1, T2); \
+	static void APIENTRY gli_##name(T1 a, T2 b) { glad_call_stats.Count[type]++; gli_real_##name(a, b); }
+#define GLI_WRAP3(type, name, T1, T2, T3) \
+	static void (APIENTRYP gli_real_##name)(T1, T2, T3); \
+	static void APIENTRY gli_##name(T1 a, T2 b, T3 c) { glad_call_stats.Count[type]++; gli_real_##name(a, b, c); }
+#define GLI_WRAP4(type, name, T1, T2, T3, T4) \
+	static void (APIENTRYP gli_real_##name)(T1, T2, T3, T4); \
+	static void APIENTRY gli_##name(T1 a, T2 b, T3 c, T4 d) { glad_call_stats.Count[type]++; gli_real_##name(a, b, c, d); }
+#define GLI_WRAP5(type, name, T1, T2, T3, T4, T5) \
+	static void (APIENTRYP gli_real_##name)(T1, T2, T3, T4, T5); \
+	static void APIENTRY gli_##name(T1 a, T2 b, T3 c, T4 d, T5 e) { glad_call_stats.Count[type]++; gli_real_##name(a, b, c, d, e); }
+#define GLI_WRAP6(type, name, T1, T2, T3, T4, T5, T6) \
+	static void (APIENTRYP gli_real_##name)(T1, T2, T3, T4, T5, T6); \
+	static void APIENTRY gli_##name(T1 a, T2 b, T3 c, T4 d, T5 e, T6 f) { glad_call_stats.Count[type]++; gli_real_##name(a, b, c, d, e, f); }
+#define GLI_WRAP7(type, name, T1, T2, T3, T4, T5, T6, T7) \
+	static void (APIENTRYP gli_real_##name)(T1, T2, T3, T4, T5, T6, T7); \
+	static void APIENTRY gli_##name(T1 a, T2 b, T3 c, T4 d, T5 e, T6 f, T7 g) { glad_call_stats.Count[type]++; gli_real_##name(a, b, c, d, e, f, g); }
+
+GLI_WRAP3(GL_CALL_DRAW, glDrawArrays, GLenum, GLint, GLsizei)
+GLI_WRAP4(GL_CALL_DRAW, glDrawArraysInstanced, GLenum, GLint, GLsizei, GLsizei)
+GLI_WRAP4(GL_CALL_DRAW, glDrawElements, GLenum, GLsizei, GLenum, const void *)
+GLI_WRAP5(GL_CALL_DRAW, glDrawElementsBaseVertex, GLenum, GLsizei, GLenum, const void *, GLint)
+GLI_WRAP5(GL_CALL_DRAW, glDrawElementsInstanced, GLenum, GLsizei, GLenum, const void *, GLsizei)
+GLI_WRAP6(GL_CALL_DRAW, glDrawElementsInstancedBaseVertex, GLenum, GLsizei, GLenum, const void *, GLsizei, GLint)
+GLI_WRAP6(GL_CALL_DRAW, glDrawRangeElements, GLenum, GLuint, GLuint, GLsizei, GLenum, const void *)
+GLI_WRAP7(GL_CALL_DRAW, glDrawRangeElementsBaseVertex, GLenum, GLuint, GLuint, GLsizei, GLenum, const void *, GLint)
+GLI_WRAP4(GL_CALL_DRAW, glMultiDrawArrays, GLenum, const GLint *, const GLsizei *, GLsizei)
+GLI_WRAP5(GL_CALL_DRAW, glMultiDrawElements, GLenum, const GLsizei *, GLenum, const void *const*, GLsizei)
+GLI_WRAP6(GL_CALL_DRAW, glMultiDrawElementsBaseVertex, GLenum, const GLsizei *, GLenum, const void *const*, GLsizei, const GLint *)
+GLI_WRAP2(GL_CALL_DRAW, glDrawArraysIndirect, GLenum, const void *)
+GLI_WRAP3(GL_CALL_DRAW, glDrawElementsIndirect, GLenum, GLenum, const void *)
+GLI_WRAP4(GL_CALL_DRAW, glMultiDrawArraysIndirect, GLenum, const void *, GLsizei, GLsizei)
+GLI_WRAP5(GL_CALL_DRAW, glMultiDrawElementsIndirect, GLenum, GLenum, const void *, GLsizei, GLsizei)
+
+GLI_WRAP2(GL_CALL_BUFFER, glBindBuffer, GLenum, GLuint)
+GLI_WRAP3(GL_CALL_BUFFER, glBindBufferBase, GLenum, GLuint, GLuint)
+GLI_WRAP5(GL_CALL_BUFFER, glBindBufferRange, GLenum, GLuint, GLuint, GLintptr, GLsizeiptr)
+GLI_WRAP2(GL_CALL_FRAMEBUFFER, glBindFramebuffer, GLenum, GLuint)
+
+GLI_WRAP2(GL_CALL_UNIFORM, glUniform1f, GLint, GLfloat)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform2f, GLint, GLfloat, GLfloat)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniform3f, GLint, GLfloat, GLfloat, GLfloat)
+GLI_WRAP5(GL_CALL_UNIFORM, glUniform4f, GLint, GLfloat, GLfloat, GLfloat, GLfloat)
+GLI_WRAP2(GL_CALL_UNIFORM, glUniform1i, GLint, GLint)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform2i, GLint, GLint, GLint)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniform3i, GLint, GLint, GLint, GLint)
+GLI_WRAP5(GL_CALL_UNIFORM, glUniform4i, GLint, GLint, GLint, GLint, GLint)
+GLI_WRAP2(GL_CALL_UNIFORM, glUniform1ui, GLint, GLuint)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform2ui, GLint, GLuint, GLuint)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniform3ui, GLint, GLuint, GLuint, GLuint)
+GLI_WRAP5(GL_CALL_UNIFORM, glUniform4ui, GLint, GLuint, GLuint, GLuint, GLuint)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform1fv, GLint, GLsizei, const GLfloat *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform2fv, GLint, GLsizei, const GLfloat *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform3fv, GLint, GLsizei, const GLfloat *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform4fv, GLint, GLsizei, const GLfloat *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform1iv, GLint, GLsizei, const GLint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform2iv, GLint, GLsizei, const GLint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform3iv, GLint, GLsizei, const GLint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform4iv, GLint, GLsizei, const GLint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform1uiv, GLint, GLsizei, const GLuint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform2uiv, GLint, GLsizei, const GLuint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform3uiv, GLint, GLsizei, const GLuint *)
+GLI_WRAP3(GL_CALL_UNIFORM, glUniform4uiv, GLint, GLsizei, const GLuint *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix2fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix3fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix4fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix2x3fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix3x2fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix2x4fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix4x2fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix3x4fv, GLint, GLsizei, GLboolean, const GLfloat *)
+GLI_WRAP4(GL_CALL_UNIFORM, glUniformMatrix4x3fv, GLint, GLsizei, GLboolean, const GLfloat *)
+
+GLI_WRAP4(GL_CALL_UPLOAD, glBufferData, GLenum, GLsizeiptr, const void *, GLenum)
+GLI_WRAP4(GL_CALL_UPLOAD, glBufferSubData, GLenum, GLintptr, GLsizeiptr, const void *)
+
+GLI_WRAP1(GL_CALL_STATE, glEnable, GLenum)
+GLI_WRAP1(GL_CALL_STATE, glDisable, GLenum)
+GLI_WRAP2(GL_CALL_STATE, glBlendFunc, GLenum, GLenum)
+GLI_WRAP4(GL_CALL_STATE, glBlendFuncSeparate, GLenum, GLenum, GLenum, GLenum)
+GLI_WRAP1(GL_CALL_STATE, glBlendEquation, GLenum)
+GLI_WRAP1(GL_CALL_STATE, glDepthFunc, GLenum)
+GLI_WRAP1(GL_CALL_STATE, glDepthMask, GLboolean)
+GLI_WRAP4(GL_CALL_STATE, glColorMask, GLboolean, GLboolean, GLboolean, GLboolean)
+GLI_WRAP1(GL_CALL_STATE, glCullFace, GLenum)
+GLI_WRAP1(GL_CALL_STATE, glFrontFace, GLenum)
+GLI_WRAP2(GL_CALL_STATE, glPolygonMode, GLenum, GLenum)
+GLI_WRAP2(GL_CALL_STATE, glPolygonOffset, GLfloat, GLfloat)
+GLI_WRAP4(GL_CALL_STATE, glViewport, GLint, GLint, GLsizei, GLsizei)
+GLI_WRAP4(GL_CALL_STATE, glScissor, GLint, GLint, GLsizei, GLsizei)
+GLI_WRAP3(GL_CALL_STATE, glStencilFunc, GLenum, GLint, GLuint)
+GLI_WRAP3(GL_CALL_STATE, glStencilOp, GLenum, GLenum, GLenum)
+GLI_WRAP1(GL_CALL_STATE, glStencilMask, GLuint)
+GLI_WRAP4(GL_CALL_STATE, glClearColor, GLfloat, GLfloat, GLfloat, GLfloat)
+
+/* 程序, VAO及纹理绑定额外记录当前对象以统计冗余绑定 */
+static void (APIENTRYP gli_real_glUseProgram)(GLuint);
+static void APIENTRY gli_glUseProgram(GLuint program)
+{
+	glad_call_stats.Count[GL_CALL_PROGRAM]++;
+	if (program == gli_program) glad_call_stats.Count[GL_CALL_REDUNDANT]++;
+	gli_program = program;
+	gli_real_glUseProgram(program);
+}
+
+static void (APIENTRYP gli_real_glBindVertexArray)(GLuint);
+static void APIENTRY gli_glBindVertexArray(GLuint array)
+{
+	glad_call_stats.Count[GL_CALL_VERTEX_ARRAY]++;
+	if (array == gli_vertex_array) glad_call_stats.Count[GL_CALL_REDUNDANT]++;
+	gli_vertex_array = array;
+	gli_real_glBindVertexArray(array);
+}
+
+static void (APIENTRYP gli_real_glActiveTexture)(GLenum);
+static void APIENTRY gli_glActiveTexture(GLenum texture)
+{
+	glad_call_stats.Count[GL_CALL_STATE]++;
+	gli_active_unit = texture - GL_TEXTURE0;
+	gli_real_glActiveTexture(texture);
+}
+
+static void (APIENTRYP gli_real_glBindTexture)(GLenum, GLuint);
+static void APIENTRY gli_glBindTexture(GLenum target, GLuint texture)
+{
+	glad_call_stats.Count[GL_CALL_TEXTURE]++;
+	if (gli_active_unit < GLI_MAX_TEXTURE_UNIT) {
+		if (gli_texture_target[gli_active_unit] == target && gli_texture[gli_active_unit] == texture) glad_call_stats.Count[GL_CALL_REDUNDANT]++;
+		gli_texture_target[gli_active_unit] = target;
+		gli_texture[gli_active_unit] = texture;
+	}
+	gli_real_glBindTexture(target, texture);
+}
+
+#define GLI_INSTALL(name) if (glad_##name) { gli_real_##name = glad_##name; glad_##name = gli_##name; }
+
+void gladInstallInstrument(void) {
+	gli_program = 0;
+	gli_vertex_array = 0;
+	gli_active_unit = 0;
+	memset(gli_texture_target, 0, sizeof(gli_texture_target));
+	memset(gli_texture, 0, sizeof(gli_texture));
+
+	GLI_INSTALL(glDrawArrays);
+	GLI_INSTALL(glDrawArraysInstanced);
+	GLI_INSTALL(glDrawElements);
+	GLI_INSTALL(glDrawElementsBaseVertex);
+	GLI_INSTALL(glDrawElementsInstanced);
+	GLI_INSTALL(glDrawElementsInstancedBaseVertex);
+	GLI_INSTALL(glDrawRangeElements);
+	GLI_INSTALL(glDrawRangeElementsBaseVertex);
+	GLI_INSTALL(glMultiDrawArrays);
+	GLI_INSTALL(glMultiDrawElements);
+	GLI_INSTALL(glMultiDrawElementsBaseVertex);
+	GLI_INSTALL(glDrawArraysIndirect);
+	GLI_INSTALL(glDrawElementsIndirect);
+	GLI_INSTALL(glMultiDrawArraysIndirect);
+	GLI_INSTALL(glMultiDrawElementsIndirect);
+
+	GLI_INSTALL(glUseProgram);
+	GLI_INSTALL(glBindVertexArray);
+	GLI_INSTALL(glActiveTexture);
+	GLI_INSTALL(glBindTexture);
+	GLI_INSTALL(glBindBuffer);
+	GLI_INSTALL(glBindBufferBase);
+	GLI_INSTALL(glBindBufferRange);
+	GLI_INSTALL(glBindFramebuffer);
+
+	GLI_INSTALL(glUniform1f);
+	GLI_INSTALL(glUniform2f);
+	GLI_INSTALL(glUniform3f);
+	GLI_INSTALL(glUniform4f);
+	GLI_INSTALL(glUniform1i);
+	GLI_INSTALL(glUniform2i);
+	GLI_INSTALL(glUniform3i);
+	GLI_INSTALL(glUniform4i);
+	GLI_INSTALL(glUniform1ui);
+	GLI_INSTALL(glUniform2ui);
+	GLI_INSTALL(glUniform3ui);
+	GLI_INSTALL(glUniform4ui);
+	GLI_INSTALL(glUniform1fv);
+	GLI_INSTALL(glUniform2fv);
+	GLI_INSTALL(glUniform3fv);
+	GLI_INSTALL(glUniform4fv);
+	GLI_INSTALL(glUniform1iv);
+	GLI_INSTALL(glUniform2iv);
+	GLI_INSTALL(glUniform3iv);
+	GLI_INSTALL(glUniform4iv);
+	GLI_INSTALL(glUniform1uiv);
+	GLI_INSTALL(glUniform2uiv);
+	GLI_INSTALL(glUniform3uiv);
+	GLI_INSTALL(glUniform4uiv);
+	GLI_INSTALL(glUniformMatrix2fv);
+	GLI_INSTALL(glUniformMatrix3fv);
+	GLI_INSTALL(glUniformMatrix4fv);
+	GLI_INSTALL(glUniformMatrix2x3fv);
+	GLI_INSTALL(glUniformMatrix3x2fv);
+	GLI_INSTALL(glUniformMatrix2x4fv);
+	GLI_INSTALL(glUniformMatrix4x2fv);
+	GLI_INSTALL(glUniformMatrix3x4fv);
+	GLI_INSTALL(glUniformMatrix4x3fv);
+
+	GLI_INSTALL(glBufferData);
+	GLI_INSTALL(glBufferSubData);
+
+	GLI_INSTALL(glEnable);
+	GLI_INSTALL(glDisable);
+	GLI_INSTALL(glBlendFunc);
+	GLI_INSTALL(glBlendFuncSeparate);
+	GLI_INSTALL(glBlendEquation);
+	GLI_INSTALL(glDepthFunc);
+	GLI_INSTALL(glDepthMask);
+	GLI_INSTALL(glColorMask);
+	GLI_INSTALL(glCullFace);
+	GLI_INSTALL(glFrontFace);
+	GLI_INSTALL(glPolygonMode);
+	GLI_INSTALL(glPolygonOffset);
+	GLI_INSTALL(glViewport);
+	GLI_INSTALL(glScissor);
+	GLI_INSTALL(glStencilFunc);
+	GLI_INSTALL(glStencilOp);
+	GLI_INSTALL(glStencilMask);
+	GLI_INSTALL(glClearColor);
+}
+#endif
+
 int gladLoadGLLoader(GLADloadproc load) {
 	GLVersion.major = 0; GLVersion.minor = 0;
 	glGetString = (PFNGLGETSTRINGPROC)load("glGetString");
@@ -1835,6 +2126,13 @@ int gladLoadGLLoader(GLADloadproc load) {
 	load_GL_VERSION_3_3(load);
 
 	if (!find_extensionsGL()) return 0;
+	load_GL_ARB_draw_indirect(load);
+	load_GL_ARB_get_program_binary(load);
+	load_GL_ARB_multi_draw_indirect(load);
+	load_GL_KHR_parallel_shader_compile(load);
+#ifdef GL_INSTRUMENT
+	gladInstallInstrument();
+#endif
 	return GLVersion.major != 0 || GLVersion.minor != 0;
 }
 